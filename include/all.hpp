@@ -19,5 +19,6 @@
 #include "./debug/dynamic_isa.hpp"
 #include "./dynamic_fm_index.hpp"
 #include "./dynamic_r_index.hpp"
+#include "./integer_alphabet_dynamic_r_index.hpp"
 #include "./commands/query.hpp"
 // #include "./dynamic_fm_index/dynranks_wrapper.hpp"
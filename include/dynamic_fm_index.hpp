@@ -1,6 +1,10 @@
 #pragma once
+#include <future>
+#include <cstring>
 #include "dynamic_fm_index/dynamic_bwt.hpp"
 #include "dynamic_fm_index/dynamic_sampled_sa.hpp"
+#include "dynamic_fm_index/text_replacement.hpp"
+#include "dynamic_fm_index/edit_session.hpp"
 #include "stool/include/all.hpp"
 #include "libdivsufsort/sa.hpp"
 
@@ -19,6 +23,8 @@ namespace stool
          * The dynamic FM-index uses a dynamic BWT and a sampled suffix array to enable
          * efficient queries and updates. The space/time trade-off can be tuned via the
          * sampling interval parameter s.
+         *
+         * @tparam C_ARRAY The C array of the dynamic BWT (CArray or BlockedCArray)
          * 
          * @note Time complexities:
          *   - Count query: O(m log σ log n) where m is pattern length
@@ -28,11 +34,17 @@ namespace stool
          * \ingroup DynamicFMIndexes
          * \ingroup StringIndexes
          */
-        class DynamicFMIndex
+        template <typename C_ARRAY = CArray>
+        class BasicDynamicFMIndex
         {
-            DynamicBWT dbwt; // Dynamic Burrows-Wheeler Transform
+        public:
+            using BWT = BasicDynamicBWT<C_ARRAY>;
+            using SampledSA = BasicDynamicSampledSA<BWT>;
+
+        private:
+            BWT dbwt; // Dynamic Burrows-Wheeler Transform
             // DynamicISA disa;
-            DynamicSampledSA dsa; // Dynamic Sampled Suffix Array
+            SampledSA dsa; // Dynamic Sampled Suffix Array
 
         public:
             static inline constexpr uint32_t LOAD_KEY = 99999999; // Key used for loading the index
@@ -42,7 +54,7 @@ namespace stool
             /**
              * @brief Default constructor for DynamicFMIndex.
              */
-            DynamicFMIndex()
+            BasicDynamicFMIndex()
             {
                 this->dsa.set_BWT(&this->dbwt);
             }
@@ -50,13 +62,13 @@ namespace stool
             /**
              * @brief Deleted copy assignment operator.
              */
-            DynamicFMIndex &operator=(const DynamicFMIndex &) = delete;
+            BasicDynamicFMIndex &operator=(const BasicDynamicFMIndex &) = delete;
 
             /**
              * @brief Move constructor for DynamicFMIndex.
              * @param other The DynamicFMIndex to move from.
              */
-            DynamicFMIndex(DynamicFMIndex &&other) noexcept
+            BasicDynamicFMIndex(BasicDynamicFMIndex &&other) noexcept
             {
                 this->dbwt = std::move(other.dbwt);
                 this->dsa = std::move(other.dsa);
@@ -68,7 +80,7 @@ namespace stool
              * @param other The DynamicFMIndex to move from.
              * @return Reference to the current DynamicFMIndex.
              */
-            DynamicFMIndex &operator=(DynamicFMIndex &&other) noexcept
+            BasicDynamicFMIndex &operator=(BasicDynamicFMIndex &&other) noexcept
             {
                 if (this != &other)
                 {
@@ -83,7 +95,7 @@ namespace stool
              * @brief Get a pointer to the dynamic BWT.
              * @return Pointer to the dynamic BWT.
              */
-            DynamicBWT *_get_dbwt_pointer()
+            BWT *_get_dbwt_pointer()
             {
                 return &this->dbwt;
             }
@@ -92,7 +104,7 @@ namespace stool
              * @brief Get a pointer to the dynamic sampled suffix array.
              * @return Pointer to the dynamic sampled suffix array.
              */
-            DynamicSampledSA *_get_dsa_pointer()
+            SampledSA *_get_dsa_pointer()
             {
                 return &this->dsa;
             }
@@ -263,7 +275,7 @@ namespace stool
              * @param os The output stream to save to.
              * @param message_paragraph The paragraph to start the message from.
              */
-            static void store_to_file(DynamicFMIndex &item, std::ofstream &os, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static void store_to_file(BasicDynamicFMIndex &item, std::ofstream &os, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
                 if (message_paragraph >= 0)
                 {
@@ -272,22 +284,15 @@ namespace stool
                 std::chrono::system_clock::time_point st1, st2;
                 st1 = std::chrono::system_clock::now();
 
-                uint64_t key = DynamicFMIndex::LOAD_KEY;
+                uint64_t key = BasicDynamicFMIndex::LOAD_KEY;
                 os.write(reinterpret_cast<const char *>(&key), sizeof(uint64_t));
 
-                DynamicBWT::store_to_file(item.dbwt, os);
-                DynamicSampledSA::store_to_file(item.dsa, os);
+                BWT::store_to_file(item.dbwt, os);
+                SampledSA::store_to_file(item.dsa, os);
 
                 uint64_t text_size = item.size();
                 st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && text_size > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
             }
 
             /**
@@ -299,23 +304,145 @@ namespace stool
                 return this->dbwt.size();
             }
 
-            static DynamicFMIndex build_from_text(const std::vector<uint8_t> &text_with_end_marker, const std::vector<uint8_t> &alphabet_with_end_marker, int message_paragraph = stool::Message::NO_MESSAGE)
+            static BasicDynamicFMIndex build_from_text(const std::vector<uint8_t> &text_with_end_marker, const std::vector<uint8_t> &alphabet_with_end_marker, int message_paragraph = stool::Message::NO_MESSAGE)
             {
                 std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text_with_end_marker, stool::Message::NO_MESSAGE);
                 std::vector<uint64_t> isa = stool::ArrayConstructor::construct_ISA(sa, stool::Message::NO_MESSAGE);
                 std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text_with_end_marker, sa, stool::Message::NO_MESSAGE);
-                DynamicFMIndex r = stool::dynamic_r_index::DynamicFMIndex::build(bwt, alphabet_with_end_marker, isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, message_paragraph);
+                BasicDynamicFMIndex r = BasicDynamicFMIndex::build(bwt, alphabet_with_end_marker, isa, SampledSA::DEFAULT_SAMPLING_INTERVAL, message_paragraph);
+
+                return r;
+            }
+
+            /**
+             * @brief Build a DynamicFMIndex from a BWT file without loading the whole BWT
+             * @details The BWT file is read in blocks into the dynamic BWT, and the sampled suffix array is computed by one LF traversal over the dynamic BWT.
+             * Hence, no static copy of the BWT is made, and the peak memory is the index itself plus 2n bits and the sampled positions.
+             * @throws std::runtime_error if the file cannot be opened, or the smallest character of the BWT does not occur exactly once
+             * @note This is slower than build() because LF is computed on the dynamic BWT.
+             */
+            static BasicDynamicFMIndex build_from_BWT_file(const std::string &file_path, uint64_t sampling_interval_of_SA = SampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                if (message_paragraph >= 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic FM-index from BWT file..." << std::endl;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                BasicDynamicFMIndex r;
+                BWT _dbwt = BWT::build_from_BWT_file(file_path, stool::Message::increment_paragraph_level(message_paragraph));
+                r.dbwt.swap(_dbwt);
+
+                SampledSA _dsa = SampledSA::build_from_dynamic_BWT(&r.dbwt, sampling_interval_of_SA, stool::Message::increment_paragraph_level(message_paragraph));
+                r.dsa.swap(_dsa);
+                r.dsa.set_BWT(&r.dbwt);
+
+                st2 = std::chrono::system_clock::now();
+                uint64_t text_size = r.size();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
 
                 return r;
             }
 
+            /**
+             * @brief Build a DynamicFMIndex from a text with a small peak memory, using \p thread_count threads in the steps (2) and (3)
+             * @details The pipeline is as follows: (1) SA is computed; (2) the sampled SA is extracted from SA in parallel chunks (ISA is not computed);
+             * (3) the BWT is computed in parallel and written over the first n bytes of SA, and it is moved to \p text_with_end_marker; (4) SA is released, and the dynamic BWT is built.
+             * The peak memory of the pipeline is about 9n bytes (the text and SA), excluding the index itself.
+             * @param text_with_end_marker The text, which is overwritten with its BWT
+             * @note The suffix sorting in the step (1) is sequential.
+             */
+            static BasicDynamicFMIndex build_from_text_in_place(std::vector<uint8_t> &text_with_end_marker, const std::vector<uint8_t> &alphabet_with_end_marker, uint64_t sampling_interval_of_SA = SampledSA::DEFAULT_SAMPLING_INTERVAL,
+                                                           int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
+            {
+                uint64_t text_size = text_with_end_marker.size();
+                if (message_paragraph >= 0 && text_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic FM-index from text (threads: " << thread_count << ")..." << std::endl;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                BasicDynamicFMIndex r;
+                {
+                    std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text_with_end_marker, stool::Message::increment_paragraph_level(message_paragraph));
+
+                    SampledSA _dsa = SampledSA::build_from_SA(sa, sampling_interval_of_SA, stool::Message::increment_paragraph_level(message_paragraph), thread_count);
+                    r.dsa.swap(_dsa);
+
+                    BasicDynamicFMIndex::construct_BWT_over_SA(text_with_end_marker, sa, stool::Message::increment_paragraph_level(message_paragraph), thread_count);
+                    std::memcpy(text_with_end_marker.data(), sa.data(), text_size);
+                }
+
+                BWT _dbwt = BWT::build(text_with_end_marker, alphabet_with_end_marker, stool::Message::increment_paragraph_level(message_paragraph));
+                r.dbwt.swap(_dbwt);
+                r.dsa.set_BWT(&r.dbwt);
+
+                st2 = std::chrono::system_clock::now();
+
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+
+                return r;
+            }
+
+            /**
+             * @brief Write the BWT of \p text over the first n bytes of its suffix array \p sa, using \p thread_count threads
+             * @details The BWT is computed in rounds of \p thread_count blocks; each thread fills a private buffer with its block, and the buffers are written back after all the threads have read their blocks.
+             * The bytes written in a round overlap only the SA values read in the same or preceding rounds.
+             */
+            static void construct_BWT_over_SA(const std::vector<uint8_t> &text, std::vector<uint64_t> &sa, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
+            {
+                static constexpr uint64_t BLOCK_SIZE = 1ULL << 20;
+                uint64_t text_size = text.size();
+                if (message_paragraph >= 0 && text_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing BWT over SA... " << std::flush;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                uint64_t _thread_count = std::max<uint64_t>(thread_count, 1);
+                uint8_t *output = reinterpret_cast<uint8_t *>(sa.data());
+                std::vector<std::vector<uint8_t>> buffers;
+                buffers.resize(_thread_count);
+                for (uint64_t round_begin = 0; round_begin < text_size; round_begin += _thread_count * BLOCK_SIZE)
+                {
+                    std::vector<std::future<uint64_t>> futures;
+                    for (uint64_t t = 0; t < _thread_count; t++)
+                    {
+                        futures.push_back(std::async(std::launch::async, [&, t]()
+                                                     {
+                            uint64_t begin = std::min(round_begin + t * BLOCK_SIZE, text_size);
+                            uint64_t end = std::min(begin + BLOCK_SIZE, text_size);
+                            buffers[t].resize(end - begin);
+                            for (uint64_t i = begin; i < end; i++)
+                            {
+                                buffers[t][i - begin] = sa[i] == 0 ? text[text_size - 1] : text[sa[i] - 1];
+                            }
+                            return begin; }));
+                    }
+                    std::vector<uint64_t> begins;
+                    for (auto &f : futures)
+                    {
+                        begins.push_back(f.get());
+                    }
+                    for (uint64_t t = 0; t < _thread_count; t++)
+                    {
+                        std::memcpy(output + begins[t], buffers[t].data(), buffers[t].size());
+                    }
+                }
+
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+            }
             /**
              * @brief Build a DynamicFMIndex from data in a file.
              * @param ifs The input stream to read from.
              * @param message_paragraph The paragraph to start the message from.
              * @return The constructed DynamicFMIndex.
              */
-            static DynamicFMIndex load_from_file(std::ifstream &ifs, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicFMIndex load_from_file(std::ifstream &ifs, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
                 if (message_paragraph >= 0)
                 {
@@ -326,30 +453,23 @@ namespace stool
 
                 uint64_t _key = 0;
                 ifs.read(reinterpret_cast<char *>(&_key), sizeof(uint64_t));
-                if (_key != DynamicFMIndex::LOAD_KEY)
+                if (_key != BasicDynamicFMIndex::LOAD_KEY)
                 {
                     std::cout << "key: " << _key << std::endl;
                     throw std::runtime_error("This data is not Dynamic FM-index!");
                 }
 
-                auto tmp1 = DynamicBWT::load_from_file(ifs);
-                DynamicFMIndex r;
+                auto tmp1 = BWT::load_from_file(ifs);
+                BasicDynamicFMIndex r;
                 r.dbwt.swap(tmp1);
 
-                auto tmp2 = DynamicSampledSA::load_from_file(ifs, &r.dbwt);
+                auto tmp2 = SampledSA::load_from_file(ifs, &r.dbwt);
                 r.dsa.swap(tmp2);
 
                 uint64_t text_size = r.size();
 
                 st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && text_size > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
 
                 return r;
             }
@@ -363,7 +483,7 @@ namespace stool
              * @param message_paragraph The paragraph to start the message from.
              * @return The constructed DynamicFMIndex.
              */
-            static DynamicFMIndex build(const std::vector<uint8_t> &bwt, const std::vector<uint8_t> &alphabet, const std::vector<uint64_t> &isa, uint64_t sampling_interval_of_SA = DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicFMIndex build(const std::vector<uint8_t> &bwt, const std::vector<uint8_t> &alphabet, const std::vector<uint64_t> &isa, uint64_t sampling_interval_of_SA = SampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
 
                 if (message_paragraph >= 0 && bwt.size() > 0)
@@ -373,23 +493,16 @@ namespace stool
                 std::chrono::system_clock::time_point st1, st2;
                 st1 = std::chrono::system_clock::now();
 
-                DynamicFMIndex r;
-                DynamicBWT _dbwt = DynamicBWT::build(bwt, alphabet, stool::Message::increment_paragraph_level(message_paragraph));
+                BasicDynamicFMIndex r;
+                BWT _dbwt = BWT::build(bwt, alphabet, stool::Message::increment_paragraph_level(message_paragraph));
                 r.dbwt.swap(_dbwt);
 
-                DynamicSampledSA _dsa = DynamicSampledSA::build(isa, &r.dbwt, sampling_interval_of_SA, stool::Message::increment_paragraph_level(message_paragraph));
+                SampledSA _dsa = SampledSA::build(isa, &r.dbwt, sampling_interval_of_SA, stool::Message::increment_paragraph_level(message_paragraph));
                 r.dsa.swap(_dsa);
 
                 st2 = std::chrono::system_clock::now();
 
-                if (message_paragraph >= 0 && bwt.size() > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)bwt.size()) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, bwt.size());
 
                 return r;
             }
@@ -402,7 +515,7 @@ namespace stool
              * @param message_paragraph The paragraph to start the message from.
              * @return The constructed DynamicFMIndex.
              */
-            static DynamicFMIndex build(const std::vector<uint8_t> &bwt, const std::vector<uint8_t> &alphabet, uint64_t sampling_interval_of_SA = DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicFMIndex build(const std::vector<uint8_t> &bwt, const std::vector<uint8_t> &alphabet, uint64_t sampling_interval_of_SA = SampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
                 if (message_paragraph >= 0 && bwt.size() > 0)
                 {
@@ -415,23 +528,16 @@ namespace stool
                 stool::bwt::BackwardISA<stool::bwt::LFDataStructure> bisa;
                 bisa.set(&lfds, lfds.get_end_marker_position(), lfds.get_text_size());
 
-                DynamicFMIndex r;
-                DynamicBWT _dbwt = DynamicBWT::build(bwt, alphabet, stool::Message::increment_paragraph_level(message_paragraph));
+                BasicDynamicFMIndex r;
+                BWT _dbwt = BWT::build(bwt, alphabet, stool::Message::increment_paragraph_level(message_paragraph));
                 r.dbwt.swap(_dbwt);
 
-                DynamicSampledSA _dsa = DynamicSampledSA::build(bisa, &r.dbwt, sampling_interval_of_SA, stool::Message::increment_paragraph_level(message_paragraph));
+                SampledSA _dsa = SampledSA::build(bisa, &r.dbwt, sampling_interval_of_SA, stool::Message::increment_paragraph_level(message_paragraph));
                 r.dsa.swap(_dsa);
 
                 st2 = std::chrono::system_clock::now();
 
-                if (message_paragraph >= 0 && bwt.size() > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)bwt.size()) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, bwt.size());
 
                 return r;
             }
@@ -440,7 +546,7 @@ namespace stool
              * @brief Swap the contents of this DynamicFMIndex with another.
              * @param item The DynamicFMIndex to swap with.
              */
-            void swap(DynamicFMIndex &item)
+            void swap(BasicDynamicFMIndex &item)
             {
                 this->dbwt.swap(item.dbwt);
                 this->dsa.swap(item.dsa);
@@ -717,11 +823,12 @@ namespace stool
              * @param c The character to insert.
              * @param output_history The history of edits to output.
              * @return The number of operations performed.
+             * @note If \p c is not in the alphabet, the wavelet tree of the BWT is first rebuilt with every byte value (see DynamicBWT::extend_alphabet()); this happens at most once per index.
              */
             uint64_t insert_char(int64_t pos, uint8_t c, FMIndexEditHistory *output_history = nullptr)
             {
                 assert(c > this->dbwt.get_end_marker());
-                this->dbwt.verify_inserted_string({c});
+                this->dbwt.extend_alphabet({c});
 
                 SAIndex isa_of_insertionPosOnText = this->dsa.isa(pos);
                 // assert(isa_of_insertionPosOnText == this->dsa.isa(pos));
@@ -803,12 +910,13 @@ namespace stool
              * @param pos The text position to insert at (0-indexed)
              * @param pattern The string to insert
              * @param output_history Output parameter for edit history
+             * @param anchor Optional anchor for computing ISA[pos] (see EditSession)
              * @return The number of BWT reorder operations performed
              * @note Time complexity: Average O((m + L_avg) log σ log n) where m is string length
              */
-            uint64_t insert_string(int64_t pos, const std::vector<uint8_t> &pattern, FMIndexEditHistory &output_history)
+            uint64_t insert_string(int64_t pos, const std::vector<uint8_t> &pattern, FMIndexEditHistory &output_history, EditAnchor *anchor = nullptr)
             {
-                return insert_string(pos, pattern, &output_history);
+                return insert_string(pos, pattern, &output_history, anchor);
             }
 
             /**
@@ -816,15 +924,17 @@ namespace stool
              * @param pos The text position to insert at (0-indexed)
              * @param pattern The string to insert
              * @param output_history Optional output parameter for edit history (nullptr to ignore)
+             * @param anchor If it is not nullptr, ISA[pos] is computed from \p anchor when it is close to \p pos, and \p anchor is replaced with the anchor of this update (see EditSession)
              * @return The number of BWT reorder operations performed
-             * @note Time complexity: Average O((m + L_avg) log σ log n) where m is string length
+             * @note Time complexity: Average O((m + L_avg) log σ log n) where m is string length.
+             * If \p pattern contains a character not in the alphabet, the wavelet tree of the BWT is first rebuilt in O(n log n) time with every byte value (see DynamicBWT::extend_alphabet()); this happens at most once per index.
              */
-            uint64_t insert_string(int64_t pos, const std::vector<uint8_t> &pattern, FMIndexEditHistory *output_history = nullptr)
+            uint64_t insert_string(int64_t pos, const std::vector<uint8_t> &pattern, FMIndexEditHistory *output_history = nullptr, EditAnchor *anchor = nullptr)
             {
                 assert(pattern.size() > 0);
-                this->dbwt.verify_inserted_string(pattern);
+                this->dbwt.extend_alphabet(pattern);
                 
-                SAIndex isa_of_insertionPosOnText = this->dsa.isa(pos);
+                SAIndex isa_of_insertionPosOnText = anchor != nullptr ? this->isa_by_anchor(pos, *anchor) : this->dsa.isa(pos);
                 // assert(isa_of_insertionPosOnText == this->dsa.isa(pos));
                 uint64_t positionToReplace = isa_of_insertionPosOnText;
                 uint64_t prev_isa = this->dbwt.LF(isa_of_insertionPosOnText);
@@ -920,7 +1030,12 @@ namespace stool
 
                 // std::cout << "j = " << j << ", j' = " << j_prime << std::endl;
 
-                std::vector<SAMove> swap_history = reorder_BWT(j, j_prime);
+                int64_t final_j = 0;
+                std::vector<SAMove> swap_history = reorder_BWT(j, j_prime, &final_j);
+                if (anchor != nullptr)
+                {
+                    this->set_anchor(*anchor, pos, swap_history.size(), final_j);
+                }
 
                 if (output_history != nullptr)
                 {
@@ -1009,13 +1124,14 @@ namespace stool
              * @param pos The starting position of the substring to delete (0-indexed)
              * @param len The length of the substring to delete
              * @param output_history Output parameter for edit history
+             * @param anchor Optional anchor for computing ISA[pos+len] and ISA[pos] (see EditSession)
              * @return The number of BWT reorder operations performed
              * @throws std::logic_error if pos + len >= text_size()
              * @note Time complexity: Average O((len + L_avg) log σ log n)
              */
-            uint64_t delete_string(const int64_t pos, int64_t len, FMIndexEditHistory &output_history)
+            uint64_t delete_string(const int64_t pos, int64_t len, FMIndexEditHistory &output_history, EditAnchor *anchor = nullptr)
             {
-                return delete_string(pos, len, &output_history);
+                return delete_string(pos, len, &output_history, anchor);
             }
 
             /**
@@ -1023,11 +1139,12 @@ namespace stool
              * @param pos The starting position of the substring to delete (0-indexed)
              * @param len The length of the substring to delete
              * @param output_history Optional output parameter for edit history (nullptr to ignore)
+             * @param anchor If it is not nullptr, ISA[pos+len] and ISA[pos] are computed from \p anchor when they are close to it, and \p anchor is replaced with the anchor of this update (see EditSession)
              * @return The number of BWT reorder operations performed
              * @throws std::logic_error if pos + len >= text_size()
              * @note Time complexity: Average O((len + L_avg) log σ log n)
              */
-            uint64_t delete_string(const int64_t pos, int64_t len, FMIndexEditHistory *output_history = nullptr)
+            uint64_t delete_string(const int64_t pos, int64_t len, FMIndexEditHistory *output_history = nullptr, EditAnchor *anchor = nullptr)
             {
 
                 if (pos + len >= (int64_t)this->size())
@@ -1037,9 +1154,9 @@ namespace stool
 
                 TextIndex pointer = pos + len < (int64_t)this->size() ? pos + len : 0;
 
-                uint64_t positionToReplace = this->dsa.isa(pointer);
+                uint64_t positionToReplace = anchor != nullptr ? this->isa_by_anchor(pointer, *anchor) : this->dsa.isa(pointer);
 
-                SAIndex isa_pos2 = this->dsa.isa(pos);
+                SAIndex isa_pos2 = anchor != nullptr ? this->isa_by_anchor(pos, *anchor) : this->dsa.isa(pos);
                 uint8_t new_char = this->dbwt.access(isa_pos2);
                 // uint8_t old_char = this->dbwt.access(positionToReplace);
                 uint64_t positionToDelete = this->dbwt.LF(positionToReplace);
@@ -1096,7 +1213,12 @@ namespace stool
                 }
 
                 // std::cout << "j = " << j << ", j' = " << j_prime << std::endl;
-                std::vector<SAMove> swap_history = reorder_BWT(j, j_prime);
+                int64_t final_j = 0;
+                std::vector<SAMove> swap_history = reorder_BWT(j, j_prime, &final_j);
+                if (anchor != nullptr)
+                {
+                    this->set_anchor(*anchor, pos, swap_history.size(), final_j);
+                }
                 if (output_history != nullptr)
                 {
                     output_history->move_history.swap(swap_history);
@@ -1105,7 +1227,49 @@ namespace stool
                 return 0;
             }
 
+            /**
+             * @brief Replace every occurrence of a pattern \p P with a string \p Q
+             * @details Overlapping occurrences are resolved from left to right (e.g., replacing aa in aaaa replaces the occurrences starting at 0 and 2).
+             * The occurrences are located once and edited in descending order of position. See TextReplacement::replace_all() for the details.
+             * @return The number of replaced occurrences
+             * @throws std::logic_error if \p P is empty
+             */
+            uint64_t replace_all(const std::vector<uint8_t> &P, const std::vector<uint8_t> &Q)
+            {
+                return TextReplacement::replace_all(*this, P, Q);
+            }
+
         private:
+            /**
+             * @brief Return ISA[i] computed from \p anchor if the walk from \p anchor is shorter than the expected walk from a sampled position, otherwise compute it by DynamicSampledSA::isa()
+             */
+            SAIndex isa_by_anchor(TextIndex i, EditAnchor &anchor) const
+            {
+                uint64_t n = this->size();
+                uint64_t d = anchor.distance(i, n);
+                if (d < this->dsa.get_sampling_interval() / 2 && anchor.sa_index < n)
+                {
+                    anchor.use_count++;
+                    return anchor.compute_isa(i, n, this->dbwt);
+                }
+                else
+                {
+                    return this->dsa.isa(i);
+                }
+            }
+
+            /**
+             * @brief Store the row \p final_j at which the reorder of an update at \p pos stopped after \p move_count moves in \p anchor
+             * @details The reorder starts with the row of the suffix starting at pos-1 and moves to the row of the preceding suffix after each move,
+             * and hence \p final_j is ISA[pos-1-move_count] of the updated text.
+             */
+            void set_anchor(EditAnchor &anchor, TextIndex pos, uint64_t move_count, int64_t final_j) const
+            {
+                uint64_t n = this->size();
+                anchor.text_position = (pos + (n - ((move_count + 1) % n))) % n;
+                anchor.sa_index = final_j;
+            }
+
             /**
              * @brief Move a row in the BWT.
              * @param j The position to move from.
@@ -1140,9 +1304,10 @@ namespace stool
              * @brief Reorder the BWT.
              * @param j The position to reorder from.
              * @param j_prime The position to reorder to.
+             * @param final_j If it is not nullptr, the row at which the reorder stops is stored in it.
              * @return A vector of moves performed during the reorder.
              */
-            std::vector<SAMove> reorder_BWT(int64_t j, int64_t j_prime)
+            std::vector<SAMove> reorder_BWT(int64_t j, int64_t j_prime, int64_t *final_j = nullptr)
             {
 
                 std::vector<SAMove> swap_history;
@@ -1163,9 +1328,25 @@ namespace stool
                     }
                 }
                 // swap_history.push_back(SAMove(j, j_prime));
+                if (final_j != nullptr)
+                {
+                    *final_j = j;
+                }
 
                 return swap_history;
             }
         };
+
+        /**
+         * @brief The dynamic FM-index with the default C array (CArray)
+         * \ingroup DynamicFMIndexes
+         */
+        using DynamicFMIndex = BasicDynamicFMIndex<CArray>;
+
+        /**
+         * @brief The dynamic FM-index with the C array supporting O(√σ)-time updates (BlockedCArray)
+         * \ingroup DynamicFMIndexes
+         */
+        using BlockedDynamicFMIndex = BasicDynamicFMIndex<BlockedCArray>;
     }
 }
@@ -0,0 +1,476 @@
+#pragma once
+#include <vector>
+#include <array>
+#include "stool/include/all.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief A variant of CArray supporting O(√σ)-time updates and O(1)-time access to \p C[i].
+         * @details This data structure stores the same two arrays \p C and \p D as CArray in the following form:
+         * @li The alphabet is divided into blocks of BLOCK_SIZE characters. For each block \p b, \p block_prefix_sums[b] stores the number of occurrences of the characters preceding the block \p b in \p T[0..n-1],
+         * and for each character \p c, \p in_block_prefix_sums[c] stores the number of occurrences of the characters preceding \p c in the block of \p c. Hence, C[c] = block_prefix_sums[c / BLOCK_SIZE] + in_block_prefix_sums[c].
+         * @li \p D is represented as a bit vector of length 256, and the rank and select queries on \p D are answered by popcount.
+         *
+         * This class has the same interface and file format as CArray, and can be used as the template parameter of BasicDynamicRIndex, BasicDynamicFMIndex, BasicDynamicRLBWT, and BasicDynamicBWT (e.g., BlockedDynamicRIndex and BlockedDynamicFMIndex).
+         * \ingroup DynamicFMIndexes
+         * \ingroup MainDataStructures
+         */
+        class BlockedCArray
+        {
+            static inline constexpr uint64_t C_ARRAY_MAX_SIZE = 257;
+            static inline constexpr uint64_t BLOCK_SIZE = 16;
+            static inline constexpr uint64_t BLOCK_COUNT = ((C_ARRAY_MAX_SIZE - 1) / BLOCK_SIZE) + 1;
+            static inline constexpr uint64_t BIT_WORD_COUNT = 4;
+
+            std::array<uint64_t, BLOCK_COUNT> block_prefix_sums;
+            std::array<uint64_t, C_ARRAY_MAX_SIZE> in_block_prefix_sums;
+            std::array<uint64_t, BIT_WORD_COUNT> alphabet_bits; // D
+            uint64_t _effective_alphabet_size = 0;
+
+        public:
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Constructors and Destructor
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+            /**
+             * @brief Default constructor.
+             */
+            BlockedCArray()
+            {
+                this->initialize();
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Lightweight functions for accessing to properties of this class
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+            /**
+             * @brief Returns the total memory usage in bytes
+             */
+            uint64_t size_in_bytes() const
+            {
+                return sizeof(BlockedCArray);
+            }
+            /**
+             * @brief Return \p σ'
+             */
+            uint64_t effective_alphabet_size() const
+            {
+                return this->_effective_alphabet_size;
+            }
+
+            //@}
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Main queries
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+            /**
+             * @brief Return \p D[0..σ'-1] as a vector.
+             * @note O(σ) time
+             */
+            std::vector<uint8_t> get_effective_alphabet() const
+            {
+                std::vector<uint8_t> r;
+                r.reserve(this->_effective_alphabet_size);
+                for (uint64_t w = 0; w < BIT_WORD_COUNT; w++)
+                {
+                    uint64_t bits = this->alphabet_bits[w];
+                    while (bits != 0)
+                    {
+                        uint64_t x = __builtin_ctzll(bits);
+                        r.push_back((w * 64) + x);
+                        bits &= bits - 1;
+                    }
+                }
+                return r;
+            }
+
+            /**
+             * @brief Return the number of occurrences of a character \p c in \p T[0..n-1].
+             * @note O(1) time
+             */
+            uint64_t get_c_count(uint8_t c) const
+            {
+                uint64_t x = c;
+                return this->at(x + 1) - this->at(x);
+            }
+
+            /**
+             * @brief Return \p C[i]
+             * @note O(1) time
+             */
+            uint64_t at(uint64_t i) const
+            {
+                return this->block_prefix_sums[i / BLOCK_SIZE] + this->in_block_prefix_sums[i];
+            }
+
+            /**
+             * @brief Return the rank of a given character \p c in \p Σ' if it exists, otherwise return -1.
+             * @note O(1) time
+             */
+            int64_t get_c_id(uint8_t c) const
+            {
+                if (!this->get_bit(c))
+                {
+                    return -1;
+                }
+                return this->rank(c);
+            }
+
+            /**
+             * @brief Return the index of the successor of a character \p c in \p Σ' if it exists, otherwise return -1.
+             * @note O(1) time
+             */
+            int64_t successor_on_effective_alphabet(uint8_t value) const
+            {
+                uint64_t w = value / 64;
+                uint64_t bits = this->alphabet_bits[w] & (UINT64_MAX << (value % 64));
+                while (bits == 0)
+                {
+                    w++;
+                    if (w >= BIT_WORD_COUNT)
+                    {
+                        return -1;
+                    }
+                    bits = this->alphabet_bits[w];
+                }
+                return this->rank((w * 64) + __builtin_ctzll(bits));
+            }
+
+            /**
+             * @brief Return the index of the predecessor of a character \p c in \p Σ' if it exists, otherwise return -1.
+             * @note O(1) time
+             */
+            int64_t predecessor_on_effective_alphabet(uint8_t value) const
+            {
+                int64_t w = value / 64;
+                uint64_t shift = 63 - (value % 64);
+                uint64_t bits = this->alphabet_bits[w] & (UINT64_MAX >> shift);
+                while (bits == 0)
+                {
+                    w--;
+                    if (w < 0)
+                    {
+                        return -1;
+                    }
+                    bits = this->alphabet_bits[w];
+                }
+                return this->rank((w * 64) + (63 - __builtin_clzll(bits)));
+            }
+
+            /**
+             * @brief Checks if a character \p c occurs in \p Σ'
+             * @note O(1) time
+             */
+            bool occurs_in_effective_alphabet(uint8_t c) const
+            {
+                return this->get_bit(c);
+            }
+
+            /**
+             * @brief Return the i-th character in \p Σ'
+             * @note O(1) time
+             */
+            uint8_t get_character_in_effective_alphabet(uint64_t i) const
+            {
+                uint64_t w = 0;
+                uint64_t count = __builtin_popcountll(this->alphabet_bits[0]);
+                while (count <= i)
+                {
+                    i -= count;
+                    w++;
+                    assert(w < BIT_WORD_COUNT);
+                    count = __builtin_popcountll(this->alphabet_bits[w]);
+                }
+                uint64_t bits = this->alphabet_bits[w];
+                for (uint64_t j = 0; j < i; j++)
+                {
+                    bits &= bits - 1;
+                }
+                return (w * 64) + __builtin_ctzll(bits);
+            }
+
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Update operations
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+            /**
+             * @brief Initializes the two arrays \p C and \p D
+             */
+            void initialize()
+            {
+                this->block_prefix_sums.fill(0);
+                this->in_block_prefix_sums.fill(0);
+                this->alphabet_bits.fill(0);
+                this->_effective_alphabet_size = 0;
+            }
+
+            /**
+             * @brief Swap operation
+             */
+            void swap(BlockedCArray &item)
+            {
+                this->block_prefix_sums.swap(item.block_prefix_sums);
+                this->in_block_prefix_sums.swap(item.in_block_prefix_sums);
+                this->alphabet_bits.swap(item.alphabet_bits);
+                std::swap(this->_effective_alphabet_size, item._effective_alphabet_size);
+            }
+
+            /**
+             * @brief Alias of initialize()
+             */
+            void clear()
+            {
+                this->initialize();
+            }
+
+            /**
+             * @brief Increases the number of occurrences of a character \p c in \p T[0..n-1] by \p delta
+             * @note O(√σ) time
+             */
+            void increase(uint8_t c, int64_t delta)
+            {
+                uint64_t x = c;
+                uint64_t block_end = ((x / BLOCK_SIZE) + 1) * BLOCK_SIZE;
+                for (uint64_t i = x + 1; i < block_end && i < C_ARRAY_MAX_SIZE; i++)
+                {
+                    this->in_block_prefix_sums[i] += delta;
+                }
+                for (uint64_t b = (x / BLOCK_SIZE) + 1; b < BLOCK_COUNT; b++)
+                {
+                    this->block_prefix_sums[b] += delta;
+                }
+
+                bool b1 = this->get_bit(c);
+                bool b2 = this->get_c_count(c) > 0;
+                if (b1 != b2)
+                {
+                    this->alphabet_bits[x / 64] ^= (1ULL << (x % 64));
+                    if (b2)
+                    {
+                        this->_effective_alphabet_size++;
+                    }
+                    else
+                    {
+                        this->_effective_alphabet_size--;
+                    }
+                }
+                assert(this->verify());
+            }
+
+            /**
+             * @brief Increases the number of occurrences of a character \p c in \p T[0..n-1] by 1
+             * @note O(√σ) time
+             */
+            void increase(uint8_t c)
+            {
+                this->increase(c, 1);
+            }
+
+            /**
+             * @brief Decreases the number of occurrences of a character \p c in \p T[0..n-1] by \p delta
+             * @note O(√σ) time
+             */
+            void decrease(uint8_t c, int64_t delta)
+            {
+                this->increase(c, -delta);
+            }
+
+            /**
+             * @brief Decreases the number of occurrences of a character \p c in \p T[0..n-1] by 1
+             * @note O(√σ) time
+             */
+            void decrease(uint8_t removedChar)
+            {
+                this->increase(removedChar, -1);
+            }
+
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Conversion functions
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+            /**
+             * @brief Return \p C[0..σ] as a vector
+             */
+            std::vector<uint64_t> to_c_vector() const
+            {
+                std::vector<uint64_t> r;
+                r.resize(C_ARRAY_MAX_SIZE, 0);
+                for (uint64_t i = 0; i < C_ARRAY_MAX_SIZE; i++)
+                {
+                    r[i] = this->at(i);
+                }
+                return r;
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Print and verification functions
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Return the memory usage information of this data structure as a vector of strings
+             * @param message_paragraph The paragraph depth of message logs
+             */
+            std::vector<std::string> get_memory_usage_info(int message_paragraph = stool::Message::SHOW_MESSAGE) const
+            {
+                std::vector<std::string> log;
+                log.push_back(stool::Message::get_paragraph_string(message_paragraph) + "=BlockedCArray: " + std::to_string(this->size_in_bytes()) + " bytes =");
+                log.push_back(stool::Message::get_paragraph_string(message_paragraph) + "==");
+                return log;
+            }
+
+            /**
+             * @brief Prints detailed information about this instance
+             */
+            void print_info() const
+            {
+                std::cout << "====== BlockedCArray ======" << std::endl;
+                stool::DebugPrinter::print_integers(this->to_c_vector());
+                stool::DebugPrinter::print_integers_with_characters(this->get_effective_alphabet());
+                std::cout << "===========================" << std::endl;
+            }
+
+            /**
+             * @brief Print the memory usage information of this data structure
+             * @param message_paragraph The paragraph depth of message logs (-1 for no output)
+             */
+            void print_memory_usage(int message_paragraph = stool::Message::SHOW_MESSAGE) const
+            {
+                std::vector<std::string> log = this->get_memory_usage_info(message_paragraph);
+                for (std::string &s : log)
+                {
+                    std::cout << s << std::endl;
+                }
+            }
+
+            /**
+             * @brief Print the statistics of this data structure
+             * @param message_paragraph The paragraph depth of message logs
+             */
+            void print_statistics(int message_paragraph = stool::Message::SHOW_MESSAGE) const
+            {
+                std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Statistics(BlockedCArray):" << std::endl;
+                std::cout << stool::Message::get_paragraph_string(message_paragraph + 1) << "Effective Alphabet: " << stool::ConverterToString::to_character_string(this->get_effective_alphabet()) << std::endl;
+                std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END]" << std::endl;
+            }
+            /**
+             * @brief Verify the internal consistency of this data structure.
+             */
+            bool verify() const
+            {
+                for (uint64_t i = 1; i < C_ARRAY_MAX_SIZE; i++)
+                {
+                    if (this->at(i) < this->at(i - 1))
+                    {
+                        this->print_info();
+                        std::cout << "i = " << i << ", C[i] = " << this->at(i) << ", C[i-1] = " << this->at(i - 1) << std::endl;
+                        throw std::logic_error("Error: BlockedCArray::verify(), C[i] < C[i-1]");
+                    }
+                }
+                return true;
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Load, save, and builder functions
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Build BlockedCArray from a vector \p Q, where \p Q[c] is the number of occurrences of the character \p c in \p T[0..n-1].
+             */
+            static BlockedCArray build(const std::vector<uint64_t> &vector_Q)
+            {
+                BlockedCArray r;
+                r.initialize();
+                for (uint64_t i = 0; i < vector_Q.size(); i++)
+                {
+                    if (vector_Q[i] > 0)
+                    {
+                        r.increase(i, vector_Q[i]);
+                    }
+                }
+                return r;
+            }
+            /**
+             * @brief Save the given instance \p item to a file stream \p os
+             * @note The file format is the same as that of CArray
+             */
+            static void store_to_file(const BlockedCArray &item, std::ofstream &os)
+            {
+                std::vector<uint64_t> c_vector = item.to_c_vector();
+                std::vector<uint8_t> effective_alphabet = item.get_effective_alphabet();
+                uint64_t sz1 = c_vector.size();
+                uint64_t sz2 = effective_alphabet.size();
+                os.write(reinterpret_cast<const char *>(&sz1), sizeof(uint64_t));
+                os.write(reinterpret_cast<const char *>(&sz2), sizeof(uint64_t));
+                os.write(reinterpret_cast<const char *>(c_vector.data()), c_vector.size() * sizeof(uint64_t));
+                os.write(reinterpret_cast<const char *>(effective_alphabet.data()), effective_alphabet.size() * sizeof(uint8_t));
+            }
+
+            /**
+             * @brief Return the BlockedCArray loaded from a file stream \p ifs
+             * @note The file format is the same as that of CArray
+             */
+            static BlockedCArray load_from_file(std::ifstream &ifs)
+            {
+                uint64_t size1 = 0;
+                uint64_t size2 = 0;
+
+                ifs.read(reinterpret_cast<char *>(&size1), sizeof(uint64_t));
+                ifs.read(reinterpret_cast<char *>(&size2), sizeof(uint64_t));
+                std::vector<uint64_t> c_vector;
+                std::vector<uint8_t> effective_alphabet;
+                c_vector.resize(size1);
+                effective_alphabet.resize(size2);
+
+                ifs.read(reinterpret_cast<char *>(c_vector.data()), size1 * sizeof(uint64_t));
+                ifs.read(reinterpret_cast<char *>(effective_alphabet.data()), size2 * sizeof(uint8_t));
+
+                std::vector<uint64_t> vector_Q;
+                vector_Q.resize(C_ARRAY_MAX_SIZE - 1, 0);
+                for (uint64_t i = 0; i + 1 < size1 && i < vector_Q.size(); i++)
+                {
+                    vector_Q[i] = c_vector[i + 1] - c_vector[i];
+                }
+                return BlockedCArray::build(vector_Q);
+            }
+
+            //@}
+
+        private:
+            /**
+             * @brief Return true if and only if the character \p c is contained in \p Σ'
+             */
+            bool get_bit(uint64_t c) const
+            {
+                return (this->alphabet_bits[c / 64] >> (c % 64)) & 1;
+            }
+            /**
+             * @brief Return the number of characters in \p Σ' smaller than \p c
+             */
+            int64_t rank(uint64_t c) const
+            {
+                uint64_t w = c / 64;
+                int64_t r = 0;
+                for (uint64_t i = 0; i < w; i++)
+                {
+                    r += __builtin_popcountll(this->alphabet_bits[i]);
+                }
+                uint64_t mask = (c % 64) == 0 ? 0 : (UINT64_MAX >> (64 - (c % 64)));
+                r += __builtin_popcountll(this->alphabet_bits[w] & mask);
+                return r;
+            }
+        };
+    }
+}
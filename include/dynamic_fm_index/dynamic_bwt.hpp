@@ -8,6 +8,7 @@
 #include "./fm_index_edit_history.hpp"
 #include "b_tree_plus_alpha/include/all.hpp"
 #include "./c_array.hpp"
+#include "./blocked_c_array.hpp"
 
 // #include "./packed_spsi_wrapper.hpp"
 
@@ -20,12 +21,14 @@ namespace stool
         /**
          * @brief A dynamic data structure storing the BWT \p L[0..n-1] of a string \p T[0..n-1] over an alphabet \p Σ[0..σ-1].
          * @note $O(n log σ)$ bits of space
+         * @tparam C_ARRAY The data structure for the C array (CArray or BlockedCArray)
          * \ingroup DynamicFMIndexes
          * \ingroup MainDataStructures
          */
-        class DynamicBWT
+        template <typename C_ARRAY = CArray>
+        class BasicDynamicBWT
         {
-            stool::dynamic_r_index::CArray cArray; /// C and D arrays
+            C_ARRAY cArray; /// C and D arrays
             stool::bptree::DynamicWaveletTree bwt; /// L
 
         public:
@@ -36,13 +39,13 @@ namespace stool
             /**
              * @brief Default constructor
              */
-            DynamicBWT()
+            BasicDynamicBWT()
             {
             }
             /**
              * @brief Move constructor
              */
-            DynamicBWT(DynamicBWT &&) noexcept = default;
+            BasicDynamicBWT(BasicDynamicBWT &&) noexcept = default;
 
             //@}
 
@@ -53,11 +56,11 @@ namespace stool
             /**
              * @brief Deleted copy assignment operator
              */
-            DynamicBWT &operator=(const DynamicBWT &) = delete;
+            BasicDynamicBWT &operator=(const BasicDynamicBWT &) = delete;
             /**
              * @brief Default move assignment operator
              */
-            DynamicBWT &operator=(DynamicBWT &&) noexcept = default;
+            BasicDynamicBWT &operator=(BasicDynamicBWT &&) noexcept = default;
             //@}
 
             ////////////////////////////////////////////////////////////////////////////////
@@ -97,7 +100,7 @@ namespace stool
             /**
              * @brief Return the reference to the C array in this instance
              */
-            const stool::dynamic_r_index::CArray &get_c_array() const
+            const C_ARRAY &get_c_array() const
             {
                 return this->cArray;
             }
@@ -200,6 +203,34 @@ namespace stool
                 return lf;
             }
 
+            /**
+             * @brief Compute the inverse of the LF function for a given position \p i, i.e., the position \p p satisfying LF(p) = i.
+             * @note O(log σ log n) time
+             */
+            int64_t inverse_LF(int64_t i) const
+            {
+                assert(i >= 0);
+                assert(i < (int64_t)this->size());
+
+                // The largest c satisfying C[c] <= i occurs in the BWT, and the i-th row starts with c.
+                uint64_t left = 0;
+                uint64_t right = UINT8_MAX;
+                while (left < right)
+                {
+                    uint64_t mid = (left + right + 1) / 2;
+                    if (this->cArray.at(mid) <= (uint64_t)i)
+                    {
+                        left = mid;
+                    }
+                    else
+                    {
+                        right = mid - 1;
+                    }
+                }
+                uint8_t c = left;
+                return this->select(i - this->cArray.at(c), c);
+            }
+
             /**
              * @brief Compute the special LF mapping for deletion
              * @note O(log σ log n) time
@@ -322,10 +353,67 @@ namespace stool
 
                 this->clear();
             }
+            /**
+             * @brief Add the characters of a given string that are not contained in the alphabet Σ of \p L to Σ
+             * @param inserted_string The string whose characters must be contained in Σ
+             * @return true if Σ has been extended, otherwise false
+             * @throws std::runtime_error if a new character is smaller than the end marker
+             * @details The wavelet tree of \p L cannot be extended in place, so it is rebuilt. To rebuild it at most once per instance,
+             * Σ is extended to every byte value not smaller than the end marker, not only to the new characters.
+             * After the extension, each operation on \p L takes O(log 256) instead of O(log σ) levels of the wavelet tree.
+             * @note The C array already supports every byte value, so only the wavelet tree of \p L is rebuilt.
+             * @note O(σ) time if Σ is not extended, and O(n log n) time otherwise (which happens at most once)
+             */
+            bool extend_alphabet(const std::vector<uint8_t> &inserted_string)
+            {
+                std::vector<uint8_t> new_chars;
+                for (uint8_t c : inserted_string)
+                {
+                    if (this->bwt.get_lexicographic_order(c) == -1 && std::find(new_chars.begin(), new_chars.end(), c) == new_chars.end())
+                    {
+                        new_chars.push_back(c);
+                    }
+                }
+                if (new_chars.size() == 0)
+                {
+                    return false;
+                }
+
+                uint8_t end_marker = this->get_end_marker();
+                for (uint8_t c : new_chars)
+                {
+                    if (c < end_marker)
+                    {
+                        throw std::runtime_error("The character " + std::to_string(c) + " cannot be added to the alphabet of the BWT because it is smaller than the end marker.");
+                    }
+                }
+
+                std::vector<uint8_t> new_alphabet = this->to_alphabet_vector();
+                for (uint64_t c = end_marker; c <= UINT8_MAX; c++)
+                {
+                    if (this->bwt.get_lexicographic_order(c) == -1)
+                    {
+                        new_alphabet.push_back(c);
+                    }
+                }
+                std::sort(new_alphabet.begin(), new_alphabet.end());
+
+                std::vector<uint8_t> _bwt;
+                uint64_t _size = this->bwt.size();
+                _bwt.resize(_size);
+                for (uint64_t i = 0; i < _size; i++)
+                {
+                    _bwt[i] = this->bwt.at(i);
+                }
+                stool::bptree::DynamicWaveletTree tmp_dwt = stool::bptree::DynamicWaveletTree::build(_bwt, new_alphabet);
+                this->bwt.swap(tmp_dwt);
+                return true;
+            }
+
             /**
              * @brief Swap operation
              */
-            void swap(DynamicBWT &item)
+            void swap(BasicDynamicBWT &item)
             {
                 this->cArray.swap(item.cArray);
                 this->bwt.swap(item.bwt);
@@ -516,7 +604,7 @@ namespace stool
              * @brief Build this instance from a given BWT \p _bwt and alphabet \p _alphabet
              * @param message_paragraph The paragraph depth of message logs
              */
-            static DynamicBWT build(const std::vector<uint8_t> &_bwt, const std::vector<uint8_t> &_alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicBWT build(const std::vector<uint8_t> &_bwt, const std::vector<uint8_t> &_alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
 
                 if (message_paragraph >= 0 && _bwt.size() > 0)
@@ -526,7 +614,7 @@ namespace stool
                 std::chrono::system_clock::time_point st1, st2;
                 st1 = std::chrono::system_clock::now();
 
-                DynamicBWT r;
+                BasicDynamicBWT r;
                 r.initialize(_alphabet);
                 r.bwt.clear();
                 r.cArray.clear();
@@ -547,7 +635,7 @@ namespace stool
                         count_c_vector[c] = count;
                     }
 
-                    auto tmp_c_array = CArray::build(count_c_vector);
+                    auto tmp_c_array = C_ARRAY::build(count_c_vector);
                     r.cArray.swap(tmp_c_array);
                 }
 
@@ -564,28 +652,132 @@ namespace stool
 
                 return r;
             }
+            /**
+             * @brief Build this instance from a BWT file, which is read in blocks without loading the whole BWT
+             * @details The file is scanned twice: the first scan computes the alphabet and the number of occurrences of each character,
+             * and the second scan appends the characters of each block to the dynamic wavelet tree.
+             * @param message_paragraph The paragraph depth of message logs
+             * @throws std::runtime_error if the file cannot be opened or read to the end, or the smallest character of the BWT does not occur exactly once
+             * @note O(n log σ log n) time, and the working space is a block of the file in addition to this instance
+             */
+            static BasicDynamicBWT build_from_BWT_file(const std::string &file_path, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                static constexpr uint64_t BUFFER_SIZE = 1ULL << 24;
+
+                std::ifstream ifs(file_path, std::ios::binary);
+                if (!ifs)
+                {
+                    throw std::runtime_error("Cannot open the file: " + file_path);
+                }
+                ifs.seekg(0, std::ios::end);
+                uint64_t file_size = ifs.tellg();
+
+                if (message_paragraph >= 0 && file_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic BWT from BWT file..." << std::endl;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                std::vector<char> buffer;
+                buffer.resize(std::min(BUFFER_SIZE, std::max<uint64_t>(file_size, 1)));
+
+                std::vector<uint64_t> count_c_vector;
+                count_c_vector.resize(256, 0);
+                ifs.seekg(0, std::ios::beg);
+                for (uint64_t read_size = 0; read_size < file_size;)
+                {
+                    uint64_t len = std::min<uint64_t>(buffer.size(), file_size - read_size);
+                    ifs.read(buffer.data(), len);
+                    if (!ifs || (uint64_t)ifs.gcount() != len)
+                    {
+                        throw std::runtime_error("Cannot read the file to the end (the file may be truncated or changed during the reading): " + file_path);
+                    }
+                    for (uint64_t i = 0; i < len; i++)
+                    {
+                        count_c_vector[(uint8_t)buffer[i]]++;
+                    }
+                    read_size += len;
+                }
+
+                std::vector<uint8_t> _alphabet;
+                for (uint64_t c = 0; c < 256; c++)
+                {
+                    if (count_c_vector[c] > 0)
+                    {
+                        _alphabet.push_back(c);
+                    }
+                }
+                if (_alphabet.size() == 0 || count_c_vector[_alphabet[0]] != 1)
+                {
+                    throw std::runtime_error("The smallest character of the BWT must occur exactly once: " + file_path);
+                }
+
+                BasicDynamicBWT r;
+                r.initialize(_alphabet);
+                r.bwt.clear();
+                r.cArray.clear();
+
+                ifs.clear();
+                ifs.seekg(0, std::ios::beg);
+                for (uint64_t read_size = 0; read_size < file_size;)
+                {
+                    uint64_t len = std::min<uint64_t>(buffer.size(), file_size - read_size);
+                    ifs.read(buffer.data(), len);
+                    if (!ifs || (uint64_t)ifs.gcount() != len)
+                    {
+                        throw std::runtime_error("Cannot read the file to the end (the file may be truncated or changed during the reading): " + file_path);
+                    }
+                    for (uint64_t i = 0; i < len; i++)
+                    {
+                        r.bwt.push_back((uint8_t)buffer[i]);
+                    }
+                    read_size += len;
+                }
+
+                auto tmp_c_array = C_ARRAY::build(count_c_vector);
+                r.cArray.swap(tmp_c_array);
+
+                st2 = std::chrono::system_clock::now();
+
+                print_elapsed_time(message_paragraph, st1, st2, file_size);
+
+                return r;
+            }
             /**
              * @brief Save the given instance \p item to a file stream \p os
              */
-            static void store_to_file(DynamicBWT &item, std::ofstream &os)
+            static void store_to_file(BasicDynamicBWT &item, std::ofstream &os)
             {
-                stool::dynamic_r_index::CArray::store_to_file(item.cArray, os);
+                C_ARRAY::store_to_file(item.cArray, os);
                 stool::bptree::DynamicWaveletTree::store_to_file(item.bwt, os);
             }
             /**
              * @brief Return the DynamicBWT instance loaded from a file stream \p ifs
              */
-            static DynamicBWT load_from_file(std::ifstream &ifs)
+            static BasicDynamicBWT load_from_file(std::ifstream &ifs)
             {
-                stool::dynamic_r_index::CArray cArray = stool::dynamic_r_index::CArray::load_from_file(ifs);
+                C_ARRAY cArray = C_ARRAY::load_from_file(ifs);
                 stool::bptree::DynamicWaveletTree bwt = stool::bptree::DynamicWaveletTree::load_from_file(ifs);
 
-                DynamicBWT r;
+                BasicDynamicBWT r;
                 r.cArray.swap(cArray);
                 r.bwt.swap(bwt);
                 return r;
             }
             //@}
         };
+
+        /**
+         * @brief The dynamic BWT with the default C array (CArray)
+         * \ingroup DynamicFMIndexes
+         */
+        using DynamicBWT = BasicDynamicBWT<CArray>;
+
+        /**
+         * @brief The dynamic BWT with the C array supporting O(√σ)-time updates (BlockedCArray)
+         * \ingroup DynamicFMIndexes
+         */
+        using BlockedDynamicBWT = BasicDynamicBWT<BlockedCArray>;
     }
 }
@@ -4,6 +4,7 @@
  */
 
 #pragma once
+#include <future>
 #include "stool/include/lib.hpp"
 #include "b_tree_plus_alpha/include/all.hpp"
 #include "./dynamic_bwt.hpp"
@@ -18,16 +19,18 @@ namespace stool
          * - Dynamic bit sequence \p B[0..n-1]: B[i] = 1 if and only if SA[i] is a sampled value.
          * - Dynamic bit sequence \p F[0..n-1]: F[i] = 1 if and only if i is a sampled SA value.
          * - Dynamic permutation \p Π[0..n/k]: Let j be the (i+1)-th sampled position in SA. Then Π[i] stores the number of 1 in F[0..SA[j]-1]. Here, SA[j] = select1_{F}(Π[i]) holds.
+         * @tparam BWT The dynamic BWT used for LF (DynamicBWT or BlockedDynamicBWT)
          * \ingroup DynamicFMIndexes
          * \ingroup MainDataStructures
          */
-        class DynamicSampledSA
+        template <typename BWT = DynamicBWT>
+        class BasicDynamicSampledSA
         {
             stool::bptree::DynamicPermutation dp; // Π
             stool::bptree::SimpleDynamicBitSequence sample_marks_on_text; // F
             stool::bptree::SimpleDynamicBitSequence sample_marks_on_sa; // B
             uint64_t sampling_interval = 32;
-            DynamicBWT *bwt = nullptr;
+            BWT *bwt = nullptr;
 
             // stool::old_implementations::VPomPermutation pom;
 
@@ -44,14 +47,14 @@ namespace stool
             /**
              * @brief Default constructor.
              */
-            DynamicSampledSA()
+            BasicDynamicSampledSA()
             {
                 this->clear();
             }
             /**
              * @brief Default move constructor.
              */
-            DynamicSampledSA(DynamicSampledSA &&) noexcept = default;
+            BasicDynamicSampledSA(BasicDynamicSampledSA &&) noexcept = default;
 
             //@}
 
@@ -62,11 +65,11 @@ namespace stool
             /**
              * @brief Deleted copy assignment operator.
              */
-            DynamicSampledSA &operator=(const DynamicSampledSA &) = delete;
+            BasicDynamicSampledSA &operator=(const BasicDynamicSampledSA &) = delete;
             /**
              * @brief Default move assignment operator.
              */
-            DynamicSampledSA &operator=(DynamicSampledSA &&) noexcept = default;
+            BasicDynamicSampledSA &operator=(BasicDynamicSampledSA &&) noexcept = default;
             //@}
 
             ////////////////////////////////////////////////////////////////////////////////
@@ -100,7 +103,7 @@ namespace stool
             /**
              * @brief Set the BWT for the DynamicSampledSA.
              */
-            void set_BWT(DynamicBWT *_bwt)
+            void set_BWT(BWT *_bwt)
             {
                 this->bwt = _bwt;
             }
@@ -224,7 +227,7 @@ namespace stool
             /**
              * @brief Swap operation
              */
-            void swap(DynamicSampledSA &item)
+            void swap(BasicDynamicSampledSA &item)
             {
                 this->dp.swap(item.dp);
                 this->sample_marks_on_text.swap(item.sample_marks_on_text);
@@ -457,7 +460,7 @@ namespace stool
             /**
              * @brief Builds a DynamicSampledSA from BISA and BWT, where BISA is the backward iterator of ISA
              */
-            static DynamicSampledSA build(const stool::bwt::BackwardISA<stool::bwt::LFDataStructure> &BISA, DynamicBWT *_bwt, uint64_t sampling_interval = DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicSampledSA build(const stool::bwt::BackwardISA<stool::bwt::LFDataStructure> &BISA, BWT *_bwt, uint64_t sampling_interval = BasicDynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
                 uint64_t text_size = _bwt->size();
 
@@ -468,7 +471,7 @@ namespace stool
                 std::chrono::system_clock::time_point st1, st2;
                 st1 = std::chrono::system_clock::now();
 
-                DynamicSampledSA r;
+                BasicDynamicSampledSA r;
                 r.set_BWT(_bwt);
                 r.set_sampling_interval(sampling_interval);
 
@@ -482,7 +485,7 @@ namespace stool
                     std::vector<uint64_t> output_sampled_sa_rank;
                     std::vector<uint64_t> output_sampled_sa;
 
-                    DynamicSampledSA::build_sampled_sa_and_bits(BISA, text_size, sampling_interval, _sample_marks_on_text, _sample_marks_on_sa, output_sampled_sa_rank, output_sampled_sa, stool::Message::increment_paragraph_level(message_paragraph));
+                    BasicDynamicSampledSA::build_sampled_sa_and_bits(BISA, text_size, sampling_interval, _sample_marks_on_text, _sample_marks_on_sa, output_sampled_sa_rank, output_sampled_sa, stool::Message::increment_paragraph_level(message_paragraph));
 
                     auto tmp1 = stool::bptree::SimpleDynamicBitSequence::build(_sample_marks_on_text);
                     auto tmp2 = stool::bptree::SimpleDynamicBitSequence::build(_sample_marks_on_sa);
@@ -499,21 +502,14 @@ namespace stool
 
                 st2 = std::chrono::system_clock::now();
 
-                if (message_paragraph >= 0 && text_size > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
 
                 return r;
             }
             /**
              * @brief Builds a DynamicSampledSA from ISA and BWT
              */
-            static DynamicSampledSA build(const std::vector<uint64_t> &isa, DynamicBWT *bwt, uint64_t sampling_interval = DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicSampledSA build(const std::vector<uint64_t> &isa, BWT *bwt, uint64_t sampling_interval = BasicDynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
                 uint64_t text_size = isa.size();
 
@@ -524,7 +520,7 @@ namespace stool
                 std::chrono::system_clock::time_point st1, st2;
                 st1 = std::chrono::system_clock::now();
 
-                DynamicSampledSA r;
+                BasicDynamicSampledSA r;
                 r.set_BWT(bwt);
                 r.set_sampling_interval(sampling_interval);
 
@@ -535,7 +531,7 @@ namespace stool
                 {
                     std::vector<bool> _sample_marks_on_text;
                     std::vector<bool> _sample_marks_on_sa;
-                    DynamicSampledSA::build_bits(isa, sampling_interval, _sample_marks_on_text, _sample_marks_on_sa, stool::Message::increment_paragraph_level(message_paragraph));
+                    BasicDynamicSampledSA::build_bits(isa, sampling_interval, _sample_marks_on_text, _sample_marks_on_sa, stool::Message::increment_paragraph_level(message_paragraph));
 
                     auto tmp1 = stool::bptree::SimpleDynamicBitSequence::build(_sample_marks_on_text);
                     auto tmp2 = stool::bptree::SimpleDynamicBitSequence::build(_sample_marks_on_sa);
@@ -547,25 +543,208 @@ namespace stool
                 std::vector<uint64_t> output_sampled_sa_rank;
                 std::vector<uint64_t> output_sampled_sa;
                 r.dp.clear();
-                DynamicSampledSA::build_sample_sa(isa, sampling_interval, output_sampled_sa_rank, output_sampled_sa, stool::Message::increment_paragraph_level(message_paragraph));
+                BasicDynamicSampledSA::build_sample_sa(isa, sampling_interval, output_sampled_sa_rank, output_sampled_sa, stool::Message::increment_paragraph_level(message_paragraph));
                 r.dp.build(output_sampled_sa_rank.begin(), output_sampled_sa_rank.end(), output_sampled_sa_rank.size(), stool::Message::increment_paragraph_level(message_paragraph));
 
                 st2 = std::chrono::system_clock::now();
 
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+                return r;
+            }
+            /**
+             * @brief Builds a DynamicSampledSA from the dynamic BWT \p _bwt by one LF traversal over it
+             * @details ISA[n-1] = 0 and ISA[p-1] = LF(ISA[p]) are computed from the last position of the text to the first one, and the SA positions of the sampled text positions are recorded.
+             * No static copy of the BWT is made; the working space is 2n bits and two words per sampled position in addition to the returned instance.
+             * @note O(n log σ log n) time
+             */
+            static BasicDynamicSampledSA build_from_dynamic_BWT(BWT *_bwt, uint64_t sampling_interval = BasicDynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                uint64_t text_size = _bwt->size();
+
                 if (message_paragraph >= 0 && text_size > 0)
                 {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic Sampled Suffix Array by LF traversal... " << std::endl;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                BasicDynamicSampledSA r;
+                r.set_BWT(_bwt);
+                r.set_sampling_interval(sampling_interval);
+
+                uint64_t output_size = 0;
+                if (text_size <= 2)
+                {
+                    output_size = text_size;
+                }
+                else
+                {
+                    output_size = ((text_size - 2) / sampling_interval) + 2;
+                }
+
+                std::vector<bool> _sample_marks_on_text;
+                std::vector<bool> _sample_marks_on_sa;
+                _sample_marks_on_text.resize(text_size, false);
+                _sample_marks_on_sa.resize(text_size, false);
+
+                // The pairs of the SA position and the rank of each sampled text position
+                std::vector<std::pair<uint64_t, uint64_t>> sampled_pairs;
+                sampled_pairs.reserve(output_size);
+                {
+                    uint64_t message_counter = 0;
+                    uint64_t sampling_counter = 0;
+                    int64_t rank = output_size - 1;
+                    int64_t isa_value = 0;
+                    for (int64_t tpos = text_size - 1; tpos >= 0; tpos--)
+                    {
+                        if (sampling_counter == 0 || tpos == 0)
+                        {
+                            _sample_marks_on_text[tpos] = true;
+                            _sample_marks_on_sa[isa_value] = true;
+                            sampled_pairs.push_back(std::pair<uint64_t, uint64_t>(isa_value, rank));
+                            sampling_counter = sampling_interval - 1;
+                            rank--;
+                        }
+                        else
+                        {
+                            sampling_counter--;
+                        }
+                        if (tpos > 0)
+                        {
+                            isa_value = _bwt->LF(isa_value);
+                        }
+
+                        message_counter++;
+                        if (message_paragraph >= 0 && message_counter >= 10000000)
+                        {
+                            std::cout << stool::Message::get_paragraph_string(message_paragraph + 1) << "Processing... [" << ((text_size - tpos) / 1000000) << "/" << (text_size / 1000000) << "MB] \r" << std::flush;
+                            message_counter = 0;
+                        }
+                    }
+                }
+                std::sort(sampled_pairs.begin(), sampled_pairs.end());
+
+                std::vector<uint64_t> output_sampled_sa_rank;
+                output_sampled_sa_rank.resize(sampled_pairs.size());
+                for (uint64_t i = 0; i < sampled_pairs.size(); i++)
+                {
+                    output_sampled_sa_rank[i] = sampled_pairs[i].second;
+                }
+                std::vector<std::pair<uint64_t, uint64_t>>().swap(sampled_pairs);
+
+                auto tmp1 = stool::bptree::SimpleDynamicBitSequence::build(_sample_marks_on_text);
+                auto tmp2 = stool::bptree::SimpleDynamicBitSequence::build(_sample_marks_on_sa);
+                r.dp.clear();
+                r.sample_marks_on_text.swap(tmp1);
+                r.sample_marks_on_sa.swap(tmp2);
+                r.dp.build(output_sampled_sa_rank.begin(), output_sampled_sa_rank.end(), output_sampled_sa_rank.size(), stool::Message::increment_paragraph_level(message_paragraph));
+
+                st2 = std::chrono::system_clock::now();
 
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+                return r;
+            }
+
+            /**
+             * @brief Builds a DynamicSampledSA from SA, where SA is scanned in \p thread_count parallel chunks
+             * @details The sampled positions are listed in SA order by the scan, and hence neither ISA nor sorting is needed.
+             * The BWT is not set to the returned instance, and set_BWT() must be called before it is used; this allows the caller to release SA before building the BWT.
+             */
+            static BasicDynamicSampledSA build_from_SA(const std::vector<uint64_t> &sa, uint64_t sampling_interval = BasicDynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
+            {
+                uint64_t text_size = sa.size();
+
+                if (message_paragraph >= 0 && text_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic Sampled Suffix Array from SA... " << std::endl;
                 }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                BasicDynamicSampledSA r;
+                r.set_sampling_interval(sampling_interval);
+
+                // The sampled positions are 0 and the positions p with (n - 1 - p) mod k = 0 (see build_bits)
+                uint64_t remainder = text_size > 0 ? (text_size - 1) % sampling_interval : 0;
+                auto get_sampled_rank = [remainder, sampling_interval](uint64_t p) -> int64_t
+                {
+                    if (p == 0)
+                    {
+                        return 0;
+                    }
+                    else if (p % sampling_interval != remainder)
+                    {
+                        return -1;
+                    }
+                    else
+                    {
+                        return ((p - remainder) / sampling_interval) + (remainder != 0 ? 1 : 0);
+                    }
+                };
+
+                uint64_t _thread_count = std::max<uint64_t>(1, std::min<uint64_t>(thread_count, text_size));
+                uint64_t chunk_size = _thread_count > 0 ? (text_size + _thread_count - 1) / _thread_count : 0;
+                std::vector<std::vector<uint64_t>> sampled_sa_positions;
+                std::vector<std::vector<uint64_t>> sampled_sa_ranks;
+                sampled_sa_positions.resize(_thread_count);
+                sampled_sa_ranks.resize(_thread_count);
+                {
+                    std::vector<std::future<void>> futures;
+                    for (uint64_t t = 0; t < _thread_count; t++)
+                    {
+                        futures.push_back(std::async(std::launch::async, [&, t]()
+                                                     {
+                            uint64_t begin = std::min(t * chunk_size, text_size);
+                            uint64_t end = std::min(begin + chunk_size, text_size);
+                            for (uint64_t i = begin; i < end; i++)
+                            {
+                                int64_t rank = get_sampled_rank(sa[i]);
+                                if (rank >= 0)
+                                {
+                                    sampled_sa_positions[t].push_back(i);
+                                    sampled_sa_ranks[t].push_back(rank);
+                                }
+                            } }));
+                    }
+                    for (auto &f : futures)
+                    {
+                        f.get();
+                    }
+                }
+
+                std::vector<bool> _sample_marks_on_text;
+                std::vector<bool> _sample_marks_on_sa;
+                std::vector<uint64_t> output_sampled_sa_rank;
+                _sample_marks_on_text.resize(text_size, false);
+                _sample_marks_on_sa.resize(text_size, false);
+                for (uint64_t t = 0; t < _thread_count; t++)
+                {
+                    for (uint64_t i : sampled_sa_positions[t])
+                    {
+                        _sample_marks_on_sa[i] = true;
+                        _sample_marks_on_text[sa[i]] = true;
+                    }
+                    output_sampled_sa_rank.insert(output_sampled_sa_rank.end(), sampled_sa_ranks[t].begin(), sampled_sa_ranks[t].end());
+                    std::vector<uint64_t>().swap(sampled_sa_positions[t]);
+                    std::vector<uint64_t>().swap(sampled_sa_ranks[t]);
+                }
+
+                auto tmp1 = stool::bptree::SimpleDynamicBitSequence::build(_sample_marks_on_text);
+                auto tmp2 = stool::bptree::SimpleDynamicBitSequence::build(_sample_marks_on_sa);
+                r.dp.clear();
+                r.sample_marks_on_text.swap(tmp1);
+                r.sample_marks_on_sa.swap(tmp2);
+                r.dp.build(output_sampled_sa_rank.begin(), output_sampled_sa_rank.end(), output_sampled_sa_rank.size(), stool::Message::increment_paragraph_level(message_paragraph));
+
+                st2 = std::chrono::system_clock::now();
+
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
                 return r;
             }
             /**
              * @brief Save the given instance \p item to a file stream \p os
              */
-            static void store_to_file(DynamicSampledSA &item, std::ofstream &os)
+            static void store_to_file(BasicDynamicSampledSA &item, std::ofstream &os)
             {
                 stool::bptree::DynamicPermutation::store_to_file(item.dp, os);
                 stool::bptree::SimpleDynamicBitSequence::store_to_file(item.sample_marks_on_text, os);
@@ -575,14 +754,14 @@ namespace stool
             /**
              * @brief Return the DynamicSampledSA instance loaded from a file stream \p ifs
              */
-            static DynamicSampledSA load_from_file(std::ifstream &ifs, DynamicBWT *bwt)
+            static BasicDynamicSampledSA load_from_file(std::ifstream &ifs, BWT *bwt)
             {
                 auto tmp1 = stool::bptree::DynamicPermutation::load_from_file(ifs);
                 auto tmp2 = stool::bptree::SimpleDynamicBitSequence::load_from_file(ifs);
                 auto tmp3 = stool::bptree::SimpleDynamicBitSequence::load_from_file(ifs);
                 uint64_t tmp4 = 0;
                 ifs.read(reinterpret_cast<char *>(&tmp4), sizeof(uint64_t));
-                DynamicSampledSA r;
+                BasicDynamicSampledSA r;
                 r.dp.swap(tmp1);
                 r.sample_marks_on_text.swap(tmp2);
                 r.sample_marks_on_sa.swap(tmp3);
@@ -727,14 +906,7 @@ namespace stool
 
                 st2 = std::chrono::system_clock::now();
 
-                if (message_paragraph >= 0 && text_size > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
             }
 
             /**
@@ -1172,5 +1344,17 @@ namespace stool
             }
         };
 
+        /**
+         * @brief The DynamicSampledSA over DynamicBWT
+         * \ingroup DynamicFMIndexes
+         */
+        using DynamicSampledSA = BasicDynamicSampledSA<DynamicBWT>;
+
+        /**
+         * @brief The DynamicSampledSA over BlockedDynamicBWT (see BlockedCArray)
+         * \ingroup DynamicFMIndexes
+         */
+        using BlockedDynamicSampledSA = BasicDynamicSampledSA<BlockedDynamicBWT>;
+
     }
 }
@@ -0,0 +1,160 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "./tools.hpp"
+#include "./fm_index_edit_history.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief A pair of a text position \p t and the SA position ISA[t] that is valid for the current text of an index
+         * @details An update of DynamicFMIndex or DynamicRIndex ends with a row that is already at its final position (the last row examined by the reordering of the BWT),
+         * and the update stores the text position of the row and the row in an EditAnchor.
+         * The next update at a nearby text position \p i can compute ISA[i] by walking LF or LF^{-1} from the anchor instead of walking LF from a sampled position.
+         * \ingroup DynamicFMIndexes
+         * \ingroup DynamicRIndexes
+         */
+        struct EditAnchor
+        {
+            TextIndex text_position = UINT64_MAX;
+            SAIndex sa_index = UINT64_MAX;
+            uint64_t use_count = 0; ///< The number of ISA values computed from this anchor (not reset by clear())
+
+            bool is_valid() const
+            {
+                return this->text_position != UINT64_MAX;
+            }
+
+            void clear()
+            {
+                this->text_position = UINT64_MAX;
+                this->sa_index = UINT64_MAX;
+            }
+
+            /**
+             * @brief Return the number of LF or LF^{-1} steps needed to compute ISA[i] from this anchor, or UINT64_MAX if this anchor is invalid
+             * @param i The text position
+             * @param text_size The length of the text
+             */
+            uint64_t distance(TextIndex i, uint64_t text_size) const
+            {
+                if (!this->is_valid() || this->text_position >= text_size || i >= text_size)
+                {
+                    return UINT64_MAX;
+                }
+                uint64_t forward = (i + text_size - this->text_position) % text_size;
+                uint64_t backward = (this->text_position + text_size - i) % text_size;
+                return std::min(forward, backward);
+            }
+
+            /**
+             * @brief Compute ISA[i] by walking LF^{-1} (if \p i follows the anchor) or LF (otherwise) from this anchor
+             * @tparam BWT A BWT supporting LF(i) and inverse_LF(i)
+             * @note O(d) LF computations, where d = distance(i, text_size)
+             */
+            template <typename BWT>
+            SAIndex compute_isa(TextIndex i, uint64_t text_size, const BWT &bwt) const
+            {
+                assert(this->is_valid());
+                uint64_t forward = (i + text_size - this->text_position) % text_size;
+                uint64_t backward = (this->text_position + text_size - i) % text_size;
+                int64_t p = this->sa_index;
+                if (forward <= backward)
+                {
+                    for (uint64_t x = 0; x < forward; x++)
+                    {
+                        p = bwt.inverse_LF(p);
+                    }
+                }
+                else
+                {
+                    for (uint64_t x = 0; x < backward; x++)
+                    {
+                        p = bwt.LF(p);
+                    }
+                }
+                return p;
+            }
+        };
+
+        /**
+         * @brief A cursor-style editor of DynamicFMIndex or DynamicRIndex that reuses the ISA information between nearby edits
+         * @details Every update of the index starts with computing ISA[u] for the edited position \p u. This class keeps the EditAnchor produced by the previous update,
+         * and the next update computes ISA[u] from the anchor if it is closer to \p u than the nearest sampled position.
+         * Hence sequential edits (e.g., inserting at u, then at u + |P|) skip the ISA walk from a sampled position.
+         * @note The index must not be updated except by this session while the session is used; call reset() after such an update.
+         * @tparam INDEX DynamicFMIndex or DynamicRIndex
+         * \ingroup DynamicFMIndexes
+         * \ingroup DynamicRIndexes
+         */
+        template <typename INDEX>
+        class EditSession
+        {
+            INDEX *index;
+            EditAnchor anchor;
+            FMIndexEditHistory history;
+
+        public:
+            EditSession(INDEX &_index) : index(&_index)
+            {
+            }
+
+            /**
+             * @brief Return the anchor produced by the last edit
+             */
+            const EditAnchor &get_anchor() const
+            {
+                return this->anchor;
+            }
+
+            /**
+             * @brief Return the edit history of the last edit
+             */
+            const FMIndexEditHistory &get_last_edit_history() const
+            {
+                return this->history;
+            }
+
+            /**
+             * @brief Return the number of ISA values computed from the anchors of this session instead of sampled positions
+             */
+            uint64_t get_anchor_use_count() const
+            {
+                return this->anchor.use_count;
+            }
+
+            /**
+             * @brief Discard the anchor (e.g., after the index is updated outside this session)
+             */
+            void reset()
+            {
+                this->anchor.clear();
+            }
+
+            uint64_t insert_string(TextIndex u, const std::vector<uint8_t> &inserted_string)
+            {
+                this->history.clear();
+                return this->index->insert_string(u, inserted_string, this->history, &this->anchor);
+            }
+
+            uint64_t insert_char(TextIndex u, uint8_t c)
+            {
+                std::vector<uint8_t> inserted_string = {c};
+                return this->insert_string(u, inserted_string);
+            }
+
+            uint64_t delete_string(TextIndex u, uint64_t len)
+            {
+                this->history.clear();
+                return this->index->delete_string(u, len, this->history, &this->anchor);
+            }
+
+            uint64_t delete_char(TextIndex u)
+            {
+                return this->delete_string(u, 1);
+            }
+        };
+    }
+}
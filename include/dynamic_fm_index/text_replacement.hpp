@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "./tools.hpp"
+#include "./edit_session.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief Helper functions for replacing every occurrence of a pattern in a dynamic index
+         * \ingroup DynamicFMIndexes
+         * \ingroup DynamicRIndexes
+         */
+        class TextReplacement
+        {
+        public:
+            /**
+             * @brief Return the starting positions of the occurrences replaced by replace_all() in descending order
+             * @details The occurrences are scanned from left to right, and an occurrence is selected if it does not overlap the previously selected occurrence.
+             * For example, for the text aaaa and the pattern aa, the occurrences starting at 0 and 2 are selected.
+             * @param occurrences The starting positions of the occurrences (in any order)
+             * @param pattern_length The length of the pattern
+             */
+            static std::vector<TextIndex> select_non_overlapping_occurrences(std::vector<uint64_t> occurrences, uint64_t pattern_length)
+            {
+                std::sort(occurrences.begin(), occurrences.end());
+                std::vector<TextIndex> r;
+                for (uint64_t p : occurrences)
+                {
+                    if (r.size() == 0 || r[r.size() - 1] + pattern_length <= p)
+                    {
+                        r.push_back(p);
+                    }
+                }
+                std::reverse(r.begin(), r.end());
+                return r;
+            }
+
+            /**
+             * @brief Return the pair of the lengths of the longest common prefix and the longest common suffix of \p P and \p Q
+             * @details The two lengths do not overlap, i.e., their sum is at most min(|P|, |Q|).
+             */
+            static std::pair<uint64_t, uint64_t> compute_common_prefix_and_suffix(const std::vector<uint8_t> &P, const std::vector<uint8_t> &Q)
+            {
+                uint64_t min_len = std::min(P.size(), Q.size());
+                uint64_t prefix = 0;
+                while (prefix < min_len && P[prefix] == Q[prefix])
+                {
+                    prefix++;
+                }
+                uint64_t suffix = 0;
+                while (prefix + suffix < min_len && P[P.size() - suffix - 1] == Q[Q.size() - suffix - 1])
+                {
+                    suffix++;
+                }
+                return std::pair<uint64_t, uint64_t>(prefix, suffix);
+            }
+
+            /**
+             * @brief Replace every non-overlapping occurrence of \p P in the text of \p index with \p Q
+             * @details The occurrences are located once and selected by select_non_overlapping_occurrences().
+             * They are edited in descending order of position, so that the positions of the remaining occurrences stay valid.
+             * Since P and Q share their common prefix and suffix, each occurrence is edited by deleting only the differing middle part of P and inserting only the differing middle part of Q.
+             * The edits are performed through one EditSession, so the insertion at an occurrence computes its ISA value from the anchor left by the deletion at the same position,
+             * and the next occurrence does so if it is close to the previous one.
+             * @tparam INDEX DynamicFMIndex or DynamicRIndex
+             * @return The number of replaced occurrences
+             * @throws std::logic_error if \p P is empty
+             */
+            template <typename INDEX>
+            static uint64_t replace_all(INDEX &index, const std::vector<uint8_t> &P, const std::vector<uint8_t> &Q)
+            {
+                if (P.size() == 0)
+                {
+                    throw std::logic_error("The replaced pattern must not be empty.");
+                }
+                std::vector<TextIndex> positions = TextReplacement::select_non_overlapping_occurrences(index.locate_query(P), P.size());
+
+                std::pair<uint64_t, uint64_t> common = TextReplacement::compute_common_prefix_and_suffix(P, Q);
+                uint64_t deleted_length = P.size() - common.first - common.second;
+                std::vector<uint8_t> inserted_string(Q.begin() + common.first, Q.end() - common.second);
+
+                EditSession<INDEX> session(index);
+                for (TextIndex p : positions)
+                {
+                    TextIndex u = p + common.first;
+                    if (deleted_length > 0)
+                    {
+                        session.delete_string(u, deleted_length);
+                    }
+                    if (inserted_string.size() > 0)
+                    {
+                        session.insert_string(u, inserted_string);
+                    }
+                }
+                return positions.size();
+            }
+        };
+    }
+}
@@ -4,8 +4,10 @@
 #include <iostream>
 #include <stack>
 #include <unordered_map>
+#include <chrono>
 // #include "./dynamic_rank_select/gRankS.h"
 #include <cassert>
+#include "stool/include/lib.hpp"
 namespace stool
 {
     namespace dynamic_r_index
@@ -40,6 +42,22 @@ namespace stool
 
 #endif
 
+        /**
+         * @brief Print the time from \p st1 to \p st2 spent on a text of length \p text_size as "[END] Elapsed Time: ... sec (... ms/MB)"
+         * @note Nothing is printed if \p message_paragraph is negative or \p text_size is zero.
+         */
+        inline void print_elapsed_time(int message_paragraph, std::chrono::system_clock::time_point st1, std::chrono::system_clock::time_point st2, uint64_t text_size)
+        {
+            if (message_paragraph >= 0 && text_size > 0)
+            {
+                uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
+                uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
+                uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
+
+                std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
+            }
+        }
+
         /**
          * @brief Enumeration representing the types of edits that can be performed on the FM-index. [Unchecked AI comment].
          * \ingroup DynamicFMIndexes
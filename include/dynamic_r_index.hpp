@@ -1,5 +1,12 @@
 #pragma once
+#include <future>
+#include <random>
 #include "dynamic_r_index/update/r_index_helper_for_update.hpp"
+#include "dynamic_r_index/prefix_free_parsing.hpp"
+#include "dynamic_r_index/document_collection.hpp"
+#include "dynamic_r_index/fasta_reader.hpp"
+#include "dynamic_fm_index/text_replacement.hpp"
+#include "dynamic_fm_index/edit_session.hpp"
 namespace stool
 {
     namespace dynamic_r_index
@@ -21,14 +28,25 @@ namespace stool
          *   - Locate query: O((m + occ) log σ log n) where occ is number of occurrences
          *   - Insert/Delete: Average O((m + L_avg) log σ log n) where L_avg is average LCP
          *
+         * @tparam C_ARRAY The C array of the dynamic RLBWT (CArray or BlockedCArray)
+         *
          * \ingroup StringIndexes
          * \ingroup DynamicRIndexes
          */
-        class DynamicRIndex
+        template <typename C_ARRAY = CArray>
+        class BasicDynamicRIndex
         {
+        public:
+            using RLBWT = BasicDynamicRLBWT<C_ARRAY>;
+
         private:
-            DynamicRLBWT dbwt;
+            RLBWT dbwt;
             DynamicPhi disa;
+            uint64_t rebuild_threshold = BasicDynamicRIndex::NO_REBUILD_THRESHOLD;
+            uint64_t rebuild_ratio = BasicDynamicRIndex::DEFAULT_REBUILD_RATIO;
+            uint64_t guarded_rebuild_count = 0;
+            uint64_t window_size = BasicDynamicRIndex::NO_SLIDING_WINDOW;
+            RIndexUpdateLog *update_log = nullptr;
 
             ////////////////////////////////////////////////////////////////////////////////
             ///   @name Properties
@@ -39,12 +57,42 @@ namespace stool
         public:
             static inline constexpr uint32_t LOAD_KEY = 8888888;
 
-            DynamicRIndex()
+            /**
+             * @brief The value of the rebuild threshold which disables the worst-case guard
+             */
+            static inline constexpr uint64_t NO_REBUILD_THRESHOLD = UINT64_MAX;
+
+            /**
+             * @brief The default ratio between the text length and the smallest estimate that triggers the worst-case guard (see set_rebuild_threshold())
+             */
+            static inline constexpr uint64_t DEFAULT_REBUILD_RATIO = 16;
+
+            /**
+             * @brief The number of steps between two checks of the time limit in the time-bounded run compaction
+             */
+            static inline constexpr uint64_t COMPACTION_TIME_CHECK_INTERVAL = 64;
+
+            /**
+             * @brief The maximal length of the blocks in which copy_substring() and move_substring() extract and insert a substring
+             */
+            static inline constexpr uint64_t SUBSTRING_BLOCK_SIZE = 4096;
+
+            /**
+             * @brief The value of the window size which disables the sliding-window mode
+             */
+            static inline constexpr uint64_t NO_SLIDING_WINDOW = UINT64_MAX;
+
+            /**
+             * @brief The default number of the characters inserted by one insertion in build_online()
+             */
+            static inline constexpr uint64_t DEFAULT_ONLINE_BLOCK_SIZE = 1ULL << 16;
+
+            BasicDynamicRIndex()
             {
             }
-            DynamicRIndex &operator=(const DynamicRIndex &) = delete;
-            DynamicRIndex(DynamicRIndex &&) noexcept = default;
-            DynamicRIndex &operator=(DynamicRIndex &&) noexcept = default;
+            BasicDynamicRIndex &operator=(const BasicDynamicRIndex &) = delete;
+            BasicDynamicRIndex(BasicDynamicRIndex &&) noexcept = default;
+            BasicDynamicRIndex &operator=(BasicDynamicRIndex &&) noexcept = default;
 
             /**
              * @brief Get the alphabet size (number of distinct characters)
@@ -57,6 +105,119 @@ namespace stool
 
             
 
+            /**
+             * @brief Set the threshold \p t of the worst-case guard for updates
+             * @details If \p t is not NO_REBUILD_THRESHOLD, every update operation first estimates the number of BWT reorder operations in the phase D by estimate_reorder_count()
+             * bounded by the effective threshold max(t, ceil(n / \p ratio)) (see get_effective_rebuild_threshold()).
+             * If the estimate reaches the effective threshold, the update is performed by rebuilding this index from the edited text by prefix-free parsing instead of running the phase D.
+             * Since the rebuild takes time and space linear in n, it is performed only if the phase D would reorder at least a 1 / \p ratio fraction of the rows.
+             * Since the estimate is not an upper bound, an update can still perform more reorder operations than the effective threshold.
+             * @throws std::logic_error if \p ratio is zero
+             */
+            void set_rebuild_threshold(uint64_t t, uint64_t ratio = DEFAULT_REBUILD_RATIO)
+            {
+                if (ratio == 0)
+                {
+                    throw std::logic_error("The rebuild ratio must be at least 1.");
+                }
+                this->rebuild_threshold = t;
+                this->rebuild_ratio = ratio;
+            }
+
+            /**
+             * @brief Get the threshold of the worst-case guard for updates
+             */
+            uint64_t get_rebuild_threshold() const
+            {
+                return this->rebuild_threshold;
+            }
+
+            /**
+             * @brief Return the smallest estimate of the reorder operations that triggers the worst-case guard, i.e., max(t, ceil(n / ratio)) (see set_rebuild_threshold())
+             * @return NO_REBUILD_THRESHOLD if the guard is disabled
+             */
+            uint64_t get_effective_rebuild_threshold() const
+            {
+                if (this->rebuild_threshold == BasicDynamicRIndex::NO_REBUILD_THRESHOLD)
+                {
+                    return BasicDynamicRIndex::NO_REBUILD_THRESHOLD;
+                }
+                uint64_t n = this->size();
+                return std::max(this->rebuild_threshold, (n + this->rebuild_ratio - 1) / this->rebuild_ratio);
+            }
+
+            /**
+             * @brief Return the number of updates performed by rebuilding this index because of the worst-case guard (see set_rebuild_threshold())
+             */
+            uint64_t get_guarded_rebuild_count() const
+            {
+                return this->guarded_rebuild_count;
+            }
+
+            /**
+             * @brief Enable or disable the explicit permutation between the runs in L and the runs in F, which reduces an LF computation to one permutation access and one prefix-sum query
+             * @see DynamicRLBWT::set_run_permutation_enabled()
+             */
+            void set_run_permutation_enabled(bool enabled)
+            {
+                this->dbwt.set_run_permutation_enabled(enabled);
+            }
+
+            /**
+             * @brief Enable or disable the maintenance of the hash of the RLBWT, which makes compute_RLBWT_hash() O(1) time at the cost of an O(log r) update per changed run
+             * @see DynamicRLBWT::set_run_hash_enabled()
+             */
+            void set_run_hash_enabled(bool enabled)
+            {
+                this->dbwt.set_run_hash_enabled(enabled);
+            }
+
+            /**
+             * @brief Enable the sliding-window mode with the window size \p w
+             * @details In the sliding-window mode, append_string() removes the oldest characters from the beginning of the text so that the text (excluding the end marker) has at most \p w characters.
+             * Pass NO_SLIDING_WINDOW to disable this mode. The window size is not saved by store_to_file().
+             * @throws std::logic_error if \p w is 0
+             */
+            void set_window_size(uint64_t w)
+            {
+                if (w == 0)
+                {
+                    throw std::logic_error("The window size must be at least 1.");
+                }
+                this->window_size = w;
+            }
+
+            /**
+             * @brief Get the window size of the sliding-window mode (NO_SLIDING_WINDOW if this mode is disabled)
+             */
+            uint64_t get_window_size() const
+            {
+                return this->window_size;
+            }
+
+            /**
+             * @brief Record every subsequent update of this index in \p log (pass nullptr to stop recording)
+             * @details The recorded log can be applied to a replica of this index by apply_update_log().
+             * The log is owned by the caller and must outlive this index or be detached before it is destroyed.
+             * Since each update is followed by a checksum record, recording enables the maintenance of the hash of the RLBWT (see set_run_hash_enabled()).
+             */
+            void set_update_log(RIndexUpdateLog *log)
+            {
+                this->update_log = log;
+                if (log != nullptr && !this->dbwt.is_run_hash_enabled())
+                {
+                    this->dbwt.set_run_hash_enabled(true);
+                }
+            }
+
+            /**
+             * @brief Get the log recording the updates of this index (nullptr if the updates are not recorded)
+             */
+            RIndexUpdateLog *get_update_log() const
+            {
+                return this->update_log;
+            }
+
             /**
              * @brief Get the end marker character
              * @return The end marker character value
@@ -113,7 +274,7 @@ namespace stool
                 std::cout << stool::Message::get_paragraph_string(message_paragraph + 1) << "The number of runs in BWT: \t\t\t" << this->run_count() << std::endl;
             }
 
-            const DynamicRLBWT &get_dynamic_rlbwt() const
+            const RLBWT &get_dynamic_rlbwt() const
             {
                 return this->dbwt;
             }
@@ -126,10 +287,15 @@ namespace stool
                 this->dbwt.clear();
                 this->disa.clear();
             }
-            void swap(DynamicRIndex &item)
+            void swap(BasicDynamicRIndex &item)
             {
                 this->dbwt.swap(item.dbwt);
                 this->disa.swap(item.disa);
+                std::swap(this->rebuild_threshold, item.rebuild_threshold);
+                std::swap(this->rebuild_ratio, item.rebuild_ratio);
+                std::swap(this->guarded_rebuild_count, item.guarded_rebuild_count);
+                std::swap(this->window_size, item.window_size);
+                std::swap(this->update_log, item.update_log);
             }
 
             void verify(int mode = 0) const
@@ -143,13 +309,70 @@ namespace stool
                 this->disa.verify(mode);
             }
 
+            /**
+             * @brief Verify the invariants of this index that can be checked without computing SA, ISA, and the LF array
+             * @details See DynamicRLBWT::verify_structure() and DynamicPhi::verify_structure().
+             * @param check_maximality Whether to check that no two adjacent runs of the RLBWT have the same character, which holds right after compact_runs()
+             * @note O(r log n) time. Throws std::logic_error if verification fails
+             */
+            void verify_structure(bool check_maximality = false) const
+            {
+                if (this->dbwt.run_count() != this->disa.run_count())
+                {
+                    throw std::logic_error("Verification Error: DBWT and DISA have the different size!");
+                }
+                if (this->dbwt.text_size() != this->disa.text_size())
+                {
+                    throw std::logic_error("Verification Error: DBWT and DISA have the different text sizes!");
+                }
+                this->dbwt.verify_structure(check_maximality);
+                this->disa.verify_structure();
+            }
+
+            /**
+             * @brief Verify the consistency between LF and phi at \p k randomly chosen runs of the RLBWT
+             * @details For each chosen run with the SA values f and l at its first and last positions, the following are checked:
+             * @li phi(f) and phi^{-1}(SA[i-1]) agree with the sampled SA values of the previous run, where i is the first position of the run;
+             * @li phi^{-1}(f - 1) = phi^{-1}(f) - 1 and phi(l - 1) = phi(l) - 1 if the run length is at least 2;
+             * @li SA[LF(i)] = f - 1 and SA[LF(j)] = l - 1 if LF(i) or LF(j) is a sampled position, where j is the last position of the run.
+             * The checks are split among \p thread_count threads, each of which uses its own random generator.
+             * @param k The number of checked runs
+             * @param seed The seed of the random generators
+             * @param thread_count The number of threads
+             * @note O(k log n) time. Throws std::logic_error if verification fails
+             */
+            void verify_by_sampling(uint64_t k, uint64_t seed, uint64_t thread_count = 1) const
+            {
+                if (thread_count == 0)
+                {
+                    throw std::logic_error("The number of threads must be at least 1.");
+                }
+                std::vector<std::future<void>> futures;
+                for (uint64_t t = 0; t < thread_count; t++)
+                {
+                    uint64_t local_k = (k / thread_count) + (t < k % thread_count ? 1 : 0);
+                    futures.push_back(std::async(std::launch::async, [this, local_k, seed, t]()
+                                                 {
+                        std::mt19937_64 mt64(seed + t);
+                        std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, this->run_count() - 1);
+                        for (uint64_t i = 0; i < local_k; i++)
+                        {
+                            this->verify_run_by_sampling(get_rand_uni_int(mt64));
+                        } }));
+                }
+                for (auto &f : futures)
+                {
+                    f.get();
+                }
+            }
+
             /**
              * @brief Save the dynamic r-index to a binary file
              * @param item The DynamicRIndex instance to save
              * @param os Output file stream (must be opened in binary mode)
              * @param message_paragraph Message indentation level for progress output
              */
-            static void store_to_file(DynamicRIndex &item, std::ofstream &os, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static void store_to_file(BasicDynamicRIndex &item, std::ofstream &os, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
                 if (message_paragraph >= 0)
                 {
@@ -158,30 +381,32 @@ namespace stool
                 std::chrono::system_clock::time_point st1, st2;
                 st1 = std::chrono::system_clock::now();
 
-                uint64_t key = DynamicRIndex::LOAD_KEY;
+                uint64_t key = BasicDynamicRIndex::LOAD_KEY;
                 os.write(reinterpret_cast<const char *>(&key), sizeof(uint64_t));
 
-                DynamicRLBWT::store_to_file(item.dbwt, os);
+                RLBWT::store_to_file(item.dbwt, os);
 
                 DynamicPhi::store_to_file(item.disa, os);
 
                 uint64_t text_size = item.size();
                 st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && text_size > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
             }
-            static DynamicRIndex build_from_text(const std::vector<uint8_t> &text_with_end_marker, const std::vector<uint8_t> &alphabet_with_end_marker, int message_paragraph = stool::Message::NO_MESSAGE)
+            /**
+             * @brief Build a dynamic r-index from a text through its suffix array and BWT
+             * @param text_with_end_marker The text, which ends with the end marker
+             * @param alphabet_with_end_marker The alphabet (distinct characters including end marker)
+             * @param message_paragraph Message indentation level for progress output
+             * @note The suffix array (8n bytes) is freed before the index is built from the BWT. See build_from_text_file_by_prefix_free_parsing() for a construction without the suffix array.
+             */
+            static BasicDynamicRIndex build_from_text(const std::vector<uint8_t> &text_with_end_marker, const std::vector<uint8_t> &alphabet_with_end_marker, int message_paragraph = stool::Message::NO_MESSAGE)
             {
-                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text_with_end_marker, stool::Message::NO_MESSAGE);
-                std::vector<uint64_t> isa = stool::ArrayConstructor::construct_ISA(sa, stool::Message::NO_MESSAGE);
-                std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text_with_end_marker, sa, stool::Message::NO_MESSAGE);
-                DynamicRIndex r = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(bwt, alphabet_with_end_marker, message_paragraph);
+                std::vector<uint8_t> bwt;
+                {
+                    std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text_with_end_marker, stool::Message::NO_MESSAGE);
+                    bwt = stool::ArrayConstructor::construct_BWT(text_with_end_marker, sa, stool::Message::NO_MESSAGE);
+                }
+                BasicDynamicRIndex r = BasicDynamicRIndex::build_from_BWT(bwt, alphabet_with_end_marker, message_paragraph);
 
                 return r;
             }
@@ -193,7 +418,7 @@ namespace stool
              * @return A new DynamicRIndex instance loaded from the file
              * @throws std::runtime_error if the file is not a valid dynamic r-index
              */
-            static DynamicRIndex load_from_file(std::ifstream &ifs, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicRIndex load_from_file(std::ifstream &ifs, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
 
                 if (message_paragraph >= 0)
@@ -205,29 +430,22 @@ namespace stool
 
                 uint64_t _key = 0;
                 ifs.read(reinterpret_cast<char *>(&_key), sizeof(uint64_t));
-                if (_key != DynamicRIndex::LOAD_KEY)
+                if (_key != BasicDynamicRIndex::LOAD_KEY)
                 {
                     throw std::runtime_error("This data is not Dynamic r-index!");
                 }
 
-                DynamicRLBWT tmp_dbwt = DynamicRLBWT::load_from_file(ifs);
+                RLBWT tmp_dbwt = RLBWT::load_from_file(ifs);
                 DynamicPhi tmp_disa = DynamicPhi::load_from_file(ifs);
 
-                DynamicRIndex r;
+                BasicDynamicRIndex r;
                 r.dbwt.swap(tmp_dbwt);
                 r.disa.swap(tmp_disa);
 
                 uint64_t text_size = r.size();
 
                 st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && text_size > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
 
                 return r;
             }
@@ -306,11 +524,11 @@ namespace stool
             ////////////////////////////////////////////////////////////////////////////////
             //@{
 
-            static DynamicRIndex build_r_index_of_end_marker(const std::vector<uint8_t> &alphabet)
+            static BasicDynamicRIndex build_r_index_of_end_marker(const std::vector<uint8_t> &alphabet)
             {
                 std::vector<uint8_t> bwt;
                 bwt.push_back(alphabet[0]);
-                return DynamicRIndex::build_from_BWT(bwt, alphabet, stool::Message::NO_MESSAGE);
+                return BasicDynamicRIndex::build_from_BWT(bwt, alphabet, stool::Message::NO_MESSAGE);
             }
 
             /**
@@ -321,7 +539,7 @@ namespace stool
              * @return A new DynamicRIndex instance
              * @note Time complexity: O(n log σ log n) where n is text length
              */
-            static DynamicRIndex build_from_BWT(const std::vector<uint8_t> &bwt, const std::vector<uint8_t> &alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicRIndex build_from_BWT(const std::vector<uint8_t> &bwt, const std::vector<uint8_t> &alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
                 uint64_t text_size = bwt.size();
                 if (message_paragraph >= 0 && text_size > 0)
@@ -331,41 +549,20 @@ namespace stool
                 std::chrono::system_clock::time_point st1, st2;
                 st1 = std::chrono::system_clock::now();
 
-                DynamicRIndex r;
-                {
-                    std::vector<uint64_t> sampled_last_sa_indexes;
-                    std::vector<uint64_t> sampled_first_sa_indexes;
-
-                    {
-                        stool::rlbwt2::RLE<uint8_t> static_rlbwt = stool::rlbwt2::RLE<uint8_t>::build_from_BWT(bwt, stool::Message::increment_paragraph_level(message_paragraph));
-                        SamplingSATBuilder::build(static_rlbwt, sampled_first_sa_indexes, sampled_last_sa_indexes, stool::Message::increment_paragraph_level(message_paragraph));
-                    }
-
-                    DynamicPhi tmp_disa = DynamicPhi::build_from_sampled_sa_indexes(sampled_last_sa_indexes, sampled_first_sa_indexes, text_size, stool::Message::increment_paragraph_level(message_paragraph));
-                    r.disa.swap(tmp_disa);
-                }
-
-                {
-                    DynamicRLBWT tmp_dbwt = DynamicRLBWT::build_from_BWT(bwt, alphabet, stool::Message::increment_paragraph_level(message_paragraph));
-                    r.dbwt.swap(tmp_dbwt);
-                }
+                std::vector<uint8_t> rlbwt_char_vector;
+                std::vector<uint64_t> rlbwt_run_length_vector;
+                stool::RLEIO::build_RLBWT_from_BWT(bwt, rlbwt_char_vector, rlbwt_run_length_vector, stool::Message::increment_paragraph_level(message_paragraph));
+                BasicDynamicRIndex r = BasicDynamicRIndex::build_from_RLBWT(rlbwt_char_vector, rlbwt_run_length_vector, alphabet, stool::Message::increment_paragraph_level(message_paragraph));
 
                 st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && text_size > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
 
                 return r;
 
                 // this->disa.build(sampled_last_sa_indexes, sampled_first_sa_indexes, this->dbwt.text_size(), stool::Message::increment_paragraph_level(message_paragraph));
             }
 
-            DynamicRLBWT *_get_dbwt_pointer()
+            RLBWT *_get_dbwt_pointer()
             {
                 return &this->dbwt;
             }
@@ -378,9 +575,10 @@ namespace stool
              * @brief Build a dynamic r-index from a BWT file
              * @param file_path Path to the BWT file
              * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the sampled SA values (see SamplingSATBuilder::build())
              * @return A new DynamicRIndex instance
              */
-            static DynamicRIndex build_from_BWT_file(std::string file_path, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicRIndex build_from_BWT_file(std::string file_path, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
             {
                 if (message_paragraph >= 0)
                 {
@@ -389,119 +587,457 @@ namespace stool
                 std::chrono::system_clock::time_point st1, st2;
                 st1 = std::chrono::system_clock::now();
 
-                DynamicRIndex r;
-                uint64_t text_size = 0;
-                {
-                    std::vector<uint64_t> sampled_last_sa_indexes;
-                    std::vector<uint64_t> sampled_first_sa_indexes;
-                    {
-                        stool::rlbwt2::RLE<uint8_t> static_rlbwt = stool::rlbwt2::RLE<uint8_t>::build_from_file(file_path, message_paragraph);
-                        text_size = static_rlbwt.str_size();
-                        SamplingSATBuilder::build(static_rlbwt, sampled_first_sa_indexes, sampled_last_sa_indexes, stool::Message::increment_paragraph_level(message_paragraph));
-                    }
+                // The BWT file is scanned once, and the run vectors are used for both the sampled SA values and the dynamic RLBWT
+                std::vector<uint8_t> rlbwt_char_vector;
+                std::vector<uint64_t> rlbwt_run_length_vector;
+                StaticRLBWTForConstruction::load_RLBWT_from_BWT_file(file_path, rlbwt_char_vector, rlbwt_run_length_vector, stool::Message::increment_paragraph_level(message_paragraph));
+                BasicDynamicRIndex r = BasicDynamicRIndex::build_from_RLBWT(rlbwt_char_vector, rlbwt_run_length_vector, stool::Message::increment_paragraph_level(message_paragraph), thread_count);
+                uint64_t text_size = r.size();
 
-                    DynamicPhi tmp_disa = DynamicPhi::build_from_sampled_sa_indexes(sampled_last_sa_indexes, sampled_first_sa_indexes, text_size, stool::Message::increment_paragraph_level(message_paragraph));
-                    r.disa.swap(tmp_disa);
-                }
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
 
-                {
-                    std::vector<uint8_t> rlbwt_char_vector;
-                    std::vector<uint64_t> rlbwt_run_length_vector;
-                    stool::RLEIO::build_RLBWT_from_BWT_file(file_path, rlbwt_char_vector, rlbwt_run_length_vector, stool::Message::increment_paragraph_level(message_paragraph));
-                    std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(rlbwt_char_vector);
-                    DynamicRLBWT tmp_dbwt = DynamicRLBWT::build_from_RLBWT(rlbwt_char_vector, rlbwt_run_length_vector, alphabet, stool::Message::increment_paragraph_level(message_paragraph));
-                    r.dbwt.swap(tmp_dbwt);
-                }
+                return r;
+            }
 
-                st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && text_size > 0)
+            /**
+             * @brief Build a dynamic r-index from an RLBWT file
+             * @details The file stores one 9-byte record per run: the character (1 byte) and the length of the run (8 bytes, little-endian) (see StaticRLBWTForConstruction::load_RLBWT_from_RLBWT_file()).
+             * Hence the construction reads O(r) bytes instead of the n bytes of the BWT.
+             * @param file_path Path to the RLBWT file
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the sampled SA values (see SamplingSATBuilder::build())
+             * @return A new DynamicRIndex instance
+             */
+            static BasicDynamicRIndex build_from_RLBWT_file(std::string file_path, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
+            {
+                if (message_paragraph >= 0)
                 {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic r-index from RLBWT file..." << std::endl;
                 }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                std::vector<uint8_t> rlbwt_char_vector;
+                std::vector<uint64_t> rlbwt_run_length_vector;
+                StaticRLBWTForConstruction::load_RLBWT_from_RLBWT_file(file_path, rlbwt_char_vector, rlbwt_run_length_vector, stool::Message::increment_paragraph_level(message_paragraph));
+                BasicDynamicRIndex r = BasicDynamicRIndex::build_from_RLBWT(rlbwt_char_vector, rlbwt_run_length_vector, stool::Message::increment_paragraph_level(message_paragraph), thread_count);
+                uint64_t text_size = r.size();
 
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
                 return r;
             }
-            //@}
-
-            ////////////////////////////////////////////////////////////////////////////////
-            ///   @name Private const Methods
-            ///   The private const methods of this class.
-            ////////////////////////////////////////////////////////////////////////////////
-            //@{
-        private:
-            //@}
 
-            ////////////////////////////////////////////////////////////////////////////////
-            ///   @name Public const Methods
-            ///   The public const methods of this class.
-            ////////////////////////////////////////////////////////////////////////////////
-            //@{
+            /**
+             * @brief Build a dynamic r-index from the run vectors of an RLBWT
+             * @param rlbwt_chars The characters of the runs (the smallest character is the end marker)
+             * @param rlbwt_runs The lengths of the runs
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the sampled SA values (see SamplingSATBuilder::build())
+             * @return A new DynamicRIndex instance
+             */
+            static BasicDynamicRIndex build_from_RLBWT(const std::vector<uint8_t> &rlbwt_chars, const std::vector<uint64_t> &rlbwt_runs, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
+            {
+                std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(rlbwt_chars);
+                return BasicDynamicRIndex::build_from_RLBWT(rlbwt_chars, rlbwt_runs, alphabet, message_paragraph, thread_count);
+            }
 
-        public:
-            uint8_t access_character_of_text(uint64_t i) const
+            /**
+             * @brief Build a dynamic r-index from the run vectors of an RLBWT over a given alphabet
+             * @param rlbwt_chars The characters of the runs (the smallest character is the end marker)
+             * @param rlbwt_runs The lengths of the runs
+             * @param alphabet The alphabet (distinct characters including end marker), which may contain characters not occurring in \p rlbwt_chars
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the sampled SA values (see SamplingSATBuilder::build())
+             * @return A new DynamicRIndex instance
+             */
+            static BasicDynamicRIndex build_from_RLBWT(const std::vector<uint8_t> &rlbwt_chars, const std::vector<uint64_t> &rlbwt_runs, const std::vector<uint8_t> &alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
             {
-                if (i + 1 < this->text_size())
+                BasicDynamicRIndex r;
+                uint64_t text_size = 0;
+                for (uint64_t len : rlbwt_runs)
                 {
-                    uint64_t j = this->disa.isa(i + 1, this->dbwt);
-                    return this->dbwt.access(j);
+                    text_size += len;
                 }
-                else
                 {
-                    return this->dbwt.get_end_marker();
+                    std::vector<uint64_t> sampled_last_sa_indexes;
+                    std::vector<uint64_t> sampled_first_sa_indexes;
+                    SamplingSATBuilder::build(rlbwt_chars, rlbwt_runs, sampled_first_sa_indexes, sampled_last_sa_indexes, message_paragraph, thread_count);
+
+                    DynamicPhi tmp_disa = DynamicPhi::build_from_sampled_sa_indexes(sampled_last_sa_indexes, sampled_first_sa_indexes, text_size, message_paragraph);
+                    r.disa.swap(tmp_disa);
                 }
+
+                RLBWT tmp_dbwt = RLBWT::build_from_RLBWT(rlbwt_chars, rlbwt_runs, alphabet, message_paragraph);
+                r.dbwt.swap(tmp_dbwt);
+                return r;
             }
-            std::vector<uint8_t> access_substring_of_text(uint64_t i, uint64_t len) const
+
+            /**
+             * @brief Build a dynamic r-index from a text file by prefix-free parsing (see PrefixFreeParsing)
+             * @details The RLBWT and the SA values at the run boundaries are computed directly from the text, without constructing the suffix array and the BWT.
+             * @param file_path Path to the text file (the end marker is appended if the last character is not \p end_marker)
+             * @param end_marker The end marker, which must be the smallest character and occur only at the end of the text
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the trigger positions (each thread reads the file through its own stream)
+             * @param window_size The length of the trigger strings of the parsing
+             * @param modulus The modulus of the fingerprints of the trigger strings
+             * @return A new DynamicRIndex instance
+             * @throws std::runtime_error if the file cannot be opened or the end marker is not the unique smallest character
+             */
+            static BasicDynamicRIndex build_from_text_file_by_prefix_free_parsing(std::string file_path, uint8_t end_marker, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1,
+                                                                             uint64_t window_size = PrefixFreeParsing::DEFAULT_WINDOW_SIZE, uint64_t modulus = PrefixFreeParsing::DEFAULT_MODULUS)
             {
-                uint64_t j;
-                if (i + len < this->text_size())
+                if (!std::ifstream(file_path, std::ios::binary))
                 {
-                    j = this->disa.isa(i + len, this->dbwt);
+                    throw std::runtime_error("Cannot open the file: " + file_path);
                 }
-                else
+                if (message_paragraph >= 0)
                 {
-                    j = this->dbwt.get_end_marker_pos();
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic r-index from text file by prefix-free parsing..." << std::endl;
                 }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
 
-                std::vector<uint8_t> output;
-                output.resize(len, UINT8_MAX);
-                for (int64_t x = len - 1; x >= 0; x--)
+                std::function<std::unique_ptr<std::istream>()> open_stream = [&file_path]()
                 {
-                    output[x] = this->dbwt.access(j);
-                    j = this->dbwt.LF(j);
-                }
-                return output;
-            }
+                    std::unique_ptr<std::istream> ifs = std::make_unique<std::ifstream>(file_path, std::ios::binary);
+                    if (!(*ifs))
+                    {
+                        throw std::runtime_error("Cannot open the file: " + file_path);
+                    }
+                    return ifs;
+                };
+                BasicDynamicRIndex r = BasicDynamicRIndex::build_from_streams_by_prefix_free_parsing(open_stream, end_marker, stool::Message::increment_paragraph_level(message_paragraph), thread_count, window_size, modulus);
 
-            void print_bwt_table() const
-            {
-                std::vector<uint64_t> sa = this->get_sa();
-                std::vector<uint8_t> bwt = this->get_bwt();
-                stool::DebugPrinter::print_bwt_table(bwt, sa);
-            }
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, r.size());
 
-            void print_content(int message_paragraph = 1) const
-            {
-                this->dbwt.print_content();
-                this->disa.print_content(stool::Message::increment_paragraph_level(message_paragraph));
+                return r;
             }
 
-            uint64_t size_in_bytes() const
+            /**
+             * @brief Build a dynamic r-index of the text read from the streams created by \p open_stream by prefix-free parsing (see PrefixFreeParsing)
+             * @param open_stream A function returning a new seekable stream of the text (it is called \p thread_count times)
+             * @param end_marker The end marker, which must be the smallest character and occur only at the end of the text (it is appended if the text does not end with it)
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the trigger positions
+             * @param window_size The length of the trigger strings of the parsing
+             * @param modulus The modulus of the fingerprints of the trigger strings
+             * @return A new DynamicRIndex instance
+             */
+            static BasicDynamicRIndex build_from_streams_by_prefix_free_parsing(const std::function<std::unique_ptr<std::istream>()> &open_stream, uint8_t end_marker, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1,
+                                                                           uint64_t window_size = PrefixFreeParsing::DEFAULT_WINDOW_SIZE, uint64_t modulus = PrefixFreeParsing::DEFAULT_MODULUS)
             {
-                return sizeof(*this) + this->disa.size_in_bytes() + this->dbwt.size_in_bytes();
-            }
+                BasicDynamicRIndex r;
+                std::vector<uint8_t> rlbwt_char_vector;
+                std::vector<uint64_t> rlbwt_run_length_vector;
+                std::vector<uint64_t> sampled_first_sa_indexes;
+                std::vector<uint64_t> sampled_last_sa_indexes;
+                PrefixFreeParsing::build(open_stream, end_marker, rlbwt_char_vector, rlbwt_run_length_vector, sampled_first_sa_indexes, sampled_last_sa_indexes, window_size, modulus, message_paragraph, thread_count);
+                uint64_t text_size = 0;
+                for (uint64_t len : rlbwt_run_length_vector)
+                {
+                    text_size += len;
+                }
 
-            std::vector<std::string> get_memory_usage_info(int message_paragraph = stool::Message::SHOW_MESSAGE) const
-            {
-                std::vector<std::string> log1 = this->dbwt.get_memory_usage_info(message_paragraph + 1);
-                std::vector<std::string> log2 = this->disa.get_memory_usage_info(message_paragraph + 1);
+                DynamicPhi tmp_disa = DynamicPhi::build_from_sampled_sa_indexes(sampled_last_sa_indexes, sampled_first_sa_indexes, text_size, message_paragraph);
+                r.disa.swap(tmp_disa);
 
-                uint64_t total_bytes = this->size_in_bytes();
-                uint64_t run_count = this->dbwt.run_count();
-                uint64_t byte_per_run = total_bytes / run_count;
+                std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(rlbwt_char_vector);
+                RLBWT tmp_dbwt = RLBWT::build_from_RLBWT(rlbwt_char_vector, rlbwt_run_length_vector, alphabet, message_paragraph);
+                r.dbwt.swap(tmp_dbwt);
+                return r;
+            }
+
+            /**
+             * @brief Build a dynamic r-index of the concatenation of the sequences of a FASTA or FASTQ file (see FASTAReader)
+             * @details The sequences are kept in a PackedDNASequence (2 bits per base) and given to the prefix-free parsing without unpacking them.
+             * Two consecutive sequences are separated by PackedDNASequence::SEPARATOR ('>'), so that no pattern over the bases matches across a record boundary.
+             * @param file_path Path to the FASTA or FASTQ file
+             * @param end_marker The end marker, which must be smaller than '>'
+             * @param output_names The name of each record
+             * @param output_starting_positions The starting position of each record in the text
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the trigger positions
+             * @param window_size The length of the trigger strings of the parsing
+             * @param modulus The modulus of the fingerprints of the trigger strings
+             * @return A new DynamicRIndex instance of the text over {end_marker, >, A, C, G, N, T}
+             * @throws std::runtime_error if the file cannot be read or the end marker is not smaller than '>'
+             */
+            static BasicDynamicRIndex build_from_FASTA_file(std::string file_path, uint8_t end_marker, std::vector<std::string> &output_names, std::vector<uint64_t> &output_starting_positions,
+                                                       int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1,
+                                                       uint64_t window_size = PrefixFreeParsing::DEFAULT_WINDOW_SIZE, uint64_t modulus = PrefixFreeParsing::DEFAULT_MODULUS)
+            {
+                if (end_marker >= PackedDNASequence::SEPARATOR)
+                {
+                    throw std::runtime_error("The end marker must be smaller than the record separator '>'.");
+                }
+                if (message_paragraph >= 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic r-index from FASTA/FASTQ file..." << std::endl;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                PackedDNASequence sequence;
+                FASTAReader::load(file_path, sequence, output_names, output_starting_positions, stool::Message::increment_paragraph_level(message_paragraph));
+                BasicDynamicRIndex r = BasicDynamicRIndex::build_from_streams_by_prefix_free_parsing([&sequence]()
+                                                                                            { return sequence.open(); }, end_marker, stool::Message::increment_paragraph_level(message_paragraph), thread_count, window_size, modulus);
+                uint64_t text_size = r.size();
+
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+                return r;
+            }
+
+            /**
+             * @brief Build a dynamic r-index of the concatenation D_1 # D_2 # ... # D_d $ of the documents of a collection by prefix-free parsing (see PrefixFreeParsing)
+             * @details The concatenation is read from the files on demand, without writing it to a temporary file or constructing its suffix array,
+             * and the trigger positions of the parsing are computed by \p thread_count threads, each of which reads a block of the concatenation.
+             * @param collection The collection of the documents
+             * @param end_marker The end marker $, which must be smaller than the separator and all the characters of the documents
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the trigger positions
+             * @param window_size The length of the trigger strings of the parsing
+             * @param modulus The modulus of the fingerprints of the trigger strings
+             * @return A new DynamicRIndex instance
+             * @throws std::runtime_error if a file cannot be read or the end marker is not the unique smallest character
+             */
+            static BasicDynamicRIndex build_from_document_collection(const DocumentCollection &collection, uint8_t end_marker, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1,
+                                                                uint64_t window_size = PrefixFreeParsing::DEFAULT_WINDOW_SIZE, uint64_t modulus = PrefixFreeParsing::DEFAULT_MODULUS)
+            {
+                if (collection.document_count() > 1 && collection.get_separator() <= end_marker)
+                {
+                    throw std::runtime_error("The separator must be larger than the end marker.");
+                }
+                if (message_paragraph >= 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic r-index from " << collection.document_count() << " documents by prefix-free parsing..." << std::endl;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                BasicDynamicRIndex r = BasicDynamicRIndex::build_from_streams_by_prefix_free_parsing([&collection]()
+                                                                                            { return collection.open(); }, end_marker, stool::Message::increment_paragraph_level(message_paragraph), thread_count, window_size, modulus);
+                uint64_t text_size = r.size();
+
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+
+                return r;
+            }
+
+            /**
+             * @brief Build a dynamic r-index of the text read from a stream by online construction
+             * @details The stream is read in blocks of \p block_size characters, and each block is appended to the text by one insertion (see insert_string()).
+             * Hence the sampled SA values are maintained during the construction, and the stream is read only once and does not need to support seekg() (e.g., std::cin).
+             * If \p reversed is true, each block is reversed and inserted at the beginning of the text, and the returned index is the index of the reversed text.
+             * The insertion at the beginning of the text moves no row of the BWT, and hence the construction for the reversed text is faster.
+             * @param is The input stream of the text (without the end marker)
+             * @param end_marker The end marker, which must be smaller than every character of the text
+             * @param reversed If true, the index of the reversed text is built
+             * @param message_paragraph Message indentation level for progress output
+             * @param block_size The number of the characters inserted by one insertion
+             * @return A new DynamicRIndex instance
+             * @throws std::runtime_error if the text contains a character that is not larger than \p end_marker
+             */
+            static BasicDynamicRIndex build_online(std::istream &is, uint8_t end_marker, bool reversed = false, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t block_size = DEFAULT_ONLINE_BLOCK_SIZE)
+            {
+                if (message_paragraph >= 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing Dynamic r-index by online construction" << (reversed ? " for the reversed text" : "") << "..." << std::endl;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                std::vector<uint8_t> alphabet;
+                alphabet.push_back(end_marker);
+                BasicDynamicRIndex r = BasicDynamicRIndex::build_r_index_of_end_marker(alphabet);
+
+                std::vector<char> buffer;
+                buffer.resize(std::max<uint64_t>(block_size, 1));
+                std::vector<uint8_t> block;
+                FMIndexEditHistory history;
+                EditAnchor anchor;
+                uint64_t message_counter = 0;
+                while (is)
+                {
+                    is.read(buffer.data(), buffer.size());
+                    uint64_t len = is.gcount();
+                    if (len == 0)
+                    {
+                        break;
+                    }
+                    block.assign(buffer.begin(), buffer.begin() + len);
+                    for (uint8_t c : block)
+                    {
+                        if (c <= end_marker)
+                        {
+                            throw std::runtime_error("The end marker must be smaller than every character of the text: " + stool::ConverterToString::to_visible_string(end_marker));
+                        }
+                    }
+
+                    if (reversed)
+                    {
+                        std::reverse(block.begin(), block.end());
+                        r.insert_string(0, block, history, &anchor);
+                    }
+                    else
+                    {
+                        r.insert_string(r.size() - 1, block, history, &anchor);
+                    }
+
+                    message_counter += len;
+                    if (message_paragraph >= 0 && message_counter >= 1000000)
+                    {
+                        std::cout << stool::Message::get_paragraph_string(message_paragraph + 1) << "Building r-index... [" << (r.size() - 1) << "]" << std::endl;
+                        message_counter = 0;
+                    }
+                }
+
+                st2 = std::chrono::system_clock::now();
+                uint64_t text_size = r.size();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+                return r;
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Private const Methods
+            ///   The private const methods of this class.
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+        private:
+            /**
+             * @brief Return the number of suffixes of T smaller than cX, where \p k is the number of suffixes of T smaller than a string X
+             * @note X need not be a suffix of T.
+             */
+            uint64_t count_smaller_suffixes_after_prepending(uint64_t k, uint8_t c) const
+            {
+                uint64_t rank = k > 0 ? this->dbwt.rank(c, (int64_t)k - 1) : 0;
+                return this->dbwt.get_c_array().at(c) + rank;
+            }
+
+            /**
+             * @brief Estimate the number of BWT reorder operations performed by the phase D of an update replacing T[u..u+len-1] with \p inserted_string, capped by \p limit
+             * @details Let X_d = T[u-d..] and let X'_d = T[u-d..u-1] inserted_string T[u+len..] be the suffix replacing X_d.
+             * For d = 1, 2, ..., this function computes the rank j of X_d by LF and the number k of suffixes smaller than X'_d by prepending T[u-d] to X'_{d-1}.
+             * X_d is counted as moved unless no suffix other than X_d and the deleted suffixes T[u..u+len-1] lies between X_d and X'_d, and the first such d stops the estimation.
+             * The order between X'_d and the new suffixes starting in \p inserted_string is ignored, and hence the estimate can be smaller or larger than the actual value.
+             * @note O((|inserted_string| + len + min(u, limit)) log σ log n + len log len) time in addition to computing ISA[u+len]
+             */
+            uint64_t estimate_reorder_count(TextIndex u, uint64_t len, const std::vector<uint8_t> &inserted_string, uint64_t limit) const
+            {
+                if (u == 0 || limit == 0)
+                {
+                    return 0;
+                }
+                int64_t j = this->disa.isa(u + len, this->dbwt);
+                uint64_t k = j;
+
+                std::vector<uint64_t> deleted_suffix_ranks;
+                for (uint64_t x = 0; x < len; x++)
+                {
+                    j = this->dbwt.LF(j);
+                    deleted_suffix_ranks.push_back(j);
+                }
+                std::sort(deleted_suffix_ranks.begin(), deleted_suffix_ranks.end());
+
+                for (int64_t x = (int64_t)inserted_string.size() - 1; x >= 0; x--)
+                {
+                    k = this->count_smaller_suffixes_after_prepending(k, inserted_string[x]);
+                }
+
+                uint64_t d = 0;
+                while (d < u && d < limit)
+                {
+                    uint8_t c = this->dbwt.access(j);
+                    j = this->dbwt.LF(j);
+                    k = this->count_smaller_suffixes_after_prepending(k, c);
+
+                    // The suffixes of ranks in [lo, hi) lie between X_d and X'_d
+                    uint64_t lo = k <= (uint64_t)j ? k : j + 1;
+                    uint64_t hi = k <= (uint64_t)j ? j : k;
+                    uint64_t deleted_count = std::lower_bound(deleted_suffix_ranks.begin(), deleted_suffix_ranks.end(), hi) - std::lower_bound(deleted_suffix_ranks.begin(), deleted_suffix_ranks.end(), lo);
+                    if (hi - lo == deleted_count)
+                    {
+                        break;
+                    }
+                    d++;
+                }
+                return d;
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Public const Methods
+            ///   The public const methods of this class.
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+        public:
+            uint8_t access_character_of_text(uint64_t i) const
+            {
+                if (i + 1 < this->text_size())
+                {
+                    uint64_t j = this->disa.isa(i + 1, this->dbwt);
+                    return this->dbwt.access(j);
+                }
+                else
+                {
+                    return this->dbwt.get_end_marker();
+                }
+            }
+            std::vector<uint8_t> access_substring_of_text(uint64_t i, uint64_t len) const
+            {
+                uint64_t j;
+                if (i + len < this->text_size())
+                {
+                    j = this->disa.isa(i + len, this->dbwt);
+                }
+                else
+                {
+                    j = this->dbwt.get_end_marker_pos();
+                }
+
+                std::vector<uint8_t> output;
+                output.resize(len, UINT8_MAX);
+                for (int64_t x = len - 1; x >= 0; x--)
+                {
+                    output[x] = this->dbwt.access(j);
+                    j = this->dbwt.LF(j);
+                }
+                return output;
+            }
+
+            void print_bwt_table() const
+            {
+                std::vector<uint64_t> sa = this->get_sa();
+                std::vector<uint8_t> bwt = this->get_bwt();
+                stool::DebugPrinter::print_bwt_table(bwt, sa);
+            }
+
+            void print_content(int message_paragraph = 1) const
+            {
+                this->dbwt.print_content();
+                this->disa.print_content(stool::Message::increment_paragraph_level(message_paragraph));
+            }
+
+            uint64_t size_in_bytes() const
+            {
+                return sizeof(*this) + this->disa.size_in_bytes() + this->dbwt.size_in_bytes();
+            }
+
+            std::vector<std::string> get_memory_usage_info(int message_paragraph = stool::Message::SHOW_MESSAGE) const
+            {
+                std::vector<std::string> log1 = this->dbwt.get_memory_usage_info(message_paragraph + 1);
+                std::vector<std::string> log2 = this->disa.get_memory_usage_info(message_paragraph + 1);
+
+                uint64_t total_bytes = this->size_in_bytes();
+                uint64_t run_count = this->dbwt.run_count();
+                uint64_t byte_per_run = total_bytes / run_count;
 
                 std::vector<std::string> r;
                 r.push_back(stool::Message::get_paragraph_string(message_paragraph) + "=Dynamic r-index: " + std::to_string(total_bytes) + " bytes (" + std::to_string(byte_per_run) + " bytes per run in BWT) =");
@@ -716,6 +1252,48 @@ namespace stool
                 BackwardSearchResult bsr = this->backward_search(pattern);
                 return this->compute_sa_values(bsr);
             }
+
+            /**
+             * @brief Estimate the number of BWT reorder operations performed by insert_string(u, inserted_string)
+             * @param u The text position to insert at (0-indexed)
+             * @param inserted_string The string to insert
+             * @param limit The estimation stops when the estimated value reaches this value
+             * @return The estimated number of BWT reorder operations in the phase D (at most \p limit)
+             * @note This function does not modify this index. The estimate depends on both \p u and \p inserted_string, but it is not a bound of the actual value (see estimate_reorder_count()).
+             * @note Time complexity: O((|inserted_string| + min(u, limit)) log σ log n) in addition to computing ISA[u]
+             */
+            uint64_t estimate_update_cost(TextIndex u, const std::vector<uint8_t> &inserted_string, uint64_t limit = UINT64_MAX) const
+            {
+                if (u >= this->text_size())
+                {
+                    throw std::logic_error("The insertion position must be less than the length of the text.");
+                }
+                return this->estimate_reorder_count(u, 0, inserted_string, limit);
+            }
+
+            /**
+             * @brief Estimate the number of BWT reorder operations performed by delete_string(u, len)
+             * @param u The starting position of the substring to delete (0-indexed)
+             * @param len The length of the substring to delete
+             * @param limit The estimation stops when the estimated value reaches this value
+             * @return The estimated number of BWT reorder operations in the phase D (at most \p limit)
+             * @throws std::logic_error if len < 1 or u + len >= text_size()
+             * @note This function does not modify this index. The estimate depends on both \p u and \p len, but it is not a bound of the actual value (see estimate_reorder_count()).
+             * @note Time complexity: O((len + min(u, limit)) log σ log n + len log len) in addition to computing ISA[u+len]
+             */
+            uint64_t estimate_delete_cost(TextIndex u, uint64_t len, uint64_t limit = UINT64_MAX) const
+            {
+                if (len < 1)
+                {
+                    throw std::logic_error("The length of the deleted substring is at least 1.");
+                }
+                if (u + len >= this->text_size())
+                {
+                    throw std::logic_error("The ending position of the deleted substring must be less than the ending position of the text.");
+                }
+                return this->estimate_reorder_count(u, len, std::vector<uint8_t>(), limit);
+            }
+
             uint8_t access(int64_t i) const
             {
                 return this->dbwt.access(i);
@@ -762,15 +1340,30 @@ namespace stool
              * @param u The text position to insert at (0-indexed)
              * @param inserted_string The string to insert
              * @param output_history Output parameter for edit history
+             * @param anchor If it is not nullptr, ISA[u] is computed from \p anchor when it is close to \p u, and \p anchor is replaced with the anchor of this update (see EditSession)
              * @return The number of BWT reorder operations performed
+             * @note If the worst-case guard is triggered (see set_rebuild_threshold()), this index is rebuilt, \p output_history is left empty, and 0 is returned
+             * @note Characters not contained in the alphabet are added to it by DynamicRLBWT::extend_alphabet() before the insertion
              */
-            uint64_t insert_string(TextIndex u, const std::vector<uint8_t> &inserted_string, FMIndexEditHistory &output_history)
+            uint64_t insert_string(TextIndex u, const std::vector<uint8_t> &inserted_string, FMIndexEditHistory &output_history, EditAnchor *anchor = nullptr)
             {
-                // Alphabet check
-                this->dbwt.verify_inserted_string(inserted_string);
+                // Add unseen characters to the alphabet
+                this->extend_alphabet(inserted_string);
 
                 output_history.clear();
-                AdditionalInformationUpdatingRIndex inf = RIndexHelperForUpdate::preprocess_of_string_insertion_operation(u, inserted_string, output_history, dbwt, disa);
+                if (this->exceeds_rebuild_threshold(u, 0, inserted_string))
+                {
+                    this->rebuild_with_edited_text(u, 0, inserted_string);
+                    this->guarded_rebuild_count++;
+                    if (anchor != nullptr)
+                    {
+                        anchor->clear();
+                    }
+                    this->write_checksum_to_update_log();
+                    return 0;
+                }
+                SAIndex isa_of_u = anchor != nullptr ? this->compute_isa_by_anchor(u, *anchor) : UINT64_MAX;
+                AdditionalInformationUpdatingRIndex inf = RIndexHelperForUpdate::preprocess_of_string_insertion_operation(u, inserted_string, output_history, dbwt, disa, this->update_log, isa_of_u);
 
                 PositionInformation y_PI;
                 y_PI.p = inf.y;
@@ -788,8 +1381,14 @@ namespace stool
                 while (!b)
                 {
 
-                    b = RIndexHelperForUpdate::phase_D(output_history, this->dbwt, this->disa, y_PI, z_PI);
+                    b = RIndexHelperForUpdate::phase_D(output_history, this->dbwt, this->disa, y_PI, z_PI, this->update_log);
+                }
+                if (anchor != nullptr)
+                {
+                    anchor->text_position = y_PI.value_at_p;
+                    anchor->sa_index = y_PI.p;
                 }
+                this->write_checksum_to_update_log();
 
                 return output_history.move_history.size();
             }
@@ -805,7 +1404,7 @@ namespace stool
              * @param len The length of the substring to delete
              * @return The number of BWT reorder operations performed
              * @throws std::logic_error if len < 1 or u + len >= text_size()
-             * @note Time complexity: Average O((len + L_avg) log σ log n)
+             * @note Time complexity: Average O((len + L_avg) log σ log n). The sampled SA values are shifted once for the whole substring (see DynamicPhi::shrink_text(int64_t, uint64_t)).
              */
             uint64_t delete_string(TextIndex u, uint64_t len)
             {
@@ -827,9 +1426,11 @@ namespace stool
              * @param u The starting position of the substring to delete (0-indexed)
              * @param len The length of the substring to delete
              * @param output_history Output parameter for edit history
+             * @param anchor If it is not nullptr, ISA[u+len] is computed from \p anchor when it is close to u+len, and \p anchor is replaced with the anchor of this update (see EditSession)
              * @return The number of BWT reorder operations performed
+             * @note If the worst-case guard is triggered (see set_rebuild_threshold()), this index is rebuilt, \p output_history is left empty, and 0 is returned
              */
-            uint64_t delete_string(TextIndex u, uint64_t len, FMIndexEditHistory &output_history)
+            uint64_t delete_string(TextIndex u, uint64_t len, FMIndexEditHistory &output_history, EditAnchor *anchor = nullptr)
             {
                 if (len < 1)
                 {
@@ -841,7 +1442,19 @@ namespace stool
                 }
 
                 output_history.clear();
-                AdditionalInformationUpdatingRIndex inf = RIndexHelperForUpdate::preprocess_of_string_deletion_operation(u, len, output_history, dbwt, disa, nullptr);
+                if (this->exceeds_rebuild_threshold(u, len, std::vector<uint8_t>()))
+                {
+                    this->rebuild_with_edited_text(u, len, std::vector<uint8_t>());
+                    this->guarded_rebuild_count++;
+                    if (anchor != nullptr)
+                    {
+                        anchor->clear();
+                    }
+                    this->write_checksum_to_update_log();
+                    return 0;
+                }
+                SAIndex isa_of_v = anchor != nullptr ? this->compute_isa_by_anchor(u + len, *anchor) : UINT64_MAX;
+                AdditionalInformationUpdatingRIndex inf = RIndexHelperForUpdate::preprocess_of_string_deletion_operation(u, len, output_history, dbwt, disa, nullptr, this->update_log, isa_of_v);
 
                 PositionInformation y_PI;
                 y_PI.p = inf.y;
@@ -857,11 +1470,17 @@ namespace stool
                 bool b = false;
                 while (!b)
                 {
-                    b = RIndexHelperForUpdate::phase_D(output_history, this->dbwt, this->disa, y_PI, z_PI);
+                    b = RIndexHelperForUpdate::phase_D(output_history, this->dbwt, this->disa, y_PI, z_PI, this->update_log);
                     // b = RIndexOldUpdateOperations::reorder_RLBWT2(output_history, this->dbwt, this->disa, sub, inf);
                     // b = RIndexHelperForUpdate::phase_D_prime(output_history, this->dbwt, this->disa, inf);
                 }
                 // RIndexHelperForUpdate::merge_non_maximal_runs_in_dbwt(output_history, true, dbwt, disa);
+                if (anchor != nullptr)
+                {
+                    anchor->text_position = y_PI.value_at_p;
+                    anchor->sa_index = y_PI.p;
+                }
+                this->write_checksum_to_update_log();
 
                 return output_history.move_history.size();
             }
@@ -875,7 +1494,6 @@ namespace stool
             uint64_t insert_char(TextIndex u, uint8_t c, FMIndexEditHistory &output_history)
             {
                 const std::vector<uint8_t> inserted_string = {c};
-                this->dbwt.verify_inserted_string(inserted_string);
                 return this->insert_string(u, inserted_string, output_history);
             }
 
@@ -887,8 +1505,15 @@ namespace stool
             uint64_t delete_char(TextIndex u, FMIndexEditHistory &output_history)
             {
                 output_history.clear();
+                if (this->exceeds_rebuild_threshold(u, 1, std::vector<uint8_t>()))
+                {
+                    this->rebuild_with_edited_text(u, 1, std::vector<uint8_t>());
+                    this->guarded_rebuild_count++;
+                    this->write_checksum_to_update_log();
+                    return 0;
+                }
 
-                AdditionalInformationUpdatingRIndex inf = RIndexHelperForUpdate::preprocess_of_string_deletion_operation(u, 1, output_history, dbwt, disa, nullptr);
+                AdditionalInformationUpdatingRIndex inf = RIndexHelperForUpdate::preprocess_of_string_deletion_operation(u, 1, output_history, dbwt, disa, nullptr, this->update_log);
 
                 PositionInformation y_PI;
                 y_PI.p = inf.y;
@@ -904,19 +1529,580 @@ namespace stool
                 bool b = false;
                 while (!b)
                 {
-                    b = RIndexHelperForUpdate::phase_D(output_history, this->dbwt, this->disa, y_PI, z_PI);
+                    b = RIndexHelperForUpdate::phase_D(output_history, this->dbwt, this->disa, y_PI, z_PI, this->update_log);
                     // b = RIndexOldUpdateOperations::reorder_RLBWT2(output_history, this->dbwt, this->disa, sub, inf);
                     // b = RIndexHelperForUpdate::phase_D_prime(output_history, this->dbwt, this->disa, inf);
                 }
+                this->write_checksum_to_update_log();
 
                 return output_history.move_history.size();
             }
 
+            /**
+             * @brief Append a string to the end of the text (i.e., insert it just before the end marker)
+             * @details If the sliding-window mode is enabled (see set_window_size()), the oldest characters are then removed from the beginning of the text so that the text keeps at most the window size characters.
+             * The removal is one delete_string() call, and hence the sampled SA values are shifted once for the evicted characters, in the same way as the inserted characters are shifted once by insert_string().
+             * If \p appended_string alone fills the window, this index is rebuilt from the last window size characters of \p appended_string.
+             * @param appended_string The string to append
+             * @return The number of BWT reorder operations performed
+             * @note Time complexity: Average O((m + L_avg) log σ log n) where m is string length. Each character of a stream is inserted once and removed once.
+             */
+            uint64_t append_string(const std::vector<uint8_t> &appended_string)
+            {
+                if (appended_string.size() == 0)
+                {
+                    return 0;
+                }
+                uint64_t old_size = this->size() - 1;
+                if (this->window_size != BasicDynamicRIndex::NO_SLIDING_WINDOW && appended_string.size() >= this->window_size)
+                {
+                    std::vector<uint8_t> window(appended_string.end() - this->window_size, appended_string.end());
+                    this->extend_alphabet(window);
+                    this->rebuild_with_edited_text(0, old_size, window);
+                    return 0;
+                }
+
+                uint64_t counter = this->insert_string(old_size, appended_string);
+                uint64_t new_size = old_size + appended_string.size();
+                if (this->window_size != BasicDynamicRIndex::NO_SLIDING_WINDOW && new_size > this->window_size)
+                {
+                    counter += this->delete_string(0, new_size - this->window_size);
+                }
+                return counter;
+            }
+
+            /**
+             * @brief Append a character to the end of the text
+             * @see append_string()
+             */
+            uint64_t append_char(uint8_t c)
+            {
+                std::vector<uint8_t> appended_string = {c};
+                return this->append_string(appended_string);
+            }
+
+            /**
+             * @brief Replace every occurrence of a pattern \p P with a string \p Q
+             * @details Overlapping occurrences are resolved from left to right (e.g., replacing aa in aaaa replaces the occurrences starting at 0 and 2).
+             * The occurrences are located once and edited in descending order of position. See TextReplacement::replace_all() for the details.
+             * @return The number of replaced occurrences
+             * @throws std::logic_error if \p P is empty
+             */
+            uint64_t replace_all(const std::vector<uint8_t> &P, const std::vector<uint8_t> &Q)
+            {
+                return TextReplacement::replace_all(*this, P, Q);
+            }
+
+            /**
+             * @brief Insert a copy of the substring T[src..src+len-1] at position \p dst
+             * @details The substring is streamed from its end to its beginning in blocks of at most SUBSTRING_BLOCK_SIZE characters:
+             * each block is extracted by LF walking (see access_substring_of_text()) and inserted at \p dst by insert_string() before the previous block.
+             * The edits share one EditAnchor, so ISA values at the ends of the blocks and at \p dst are computed from the previous edit when it is close.
+             * @param src The starting position of the copied substring
+             * @param len The length of the copied substring
+             * @param dst The text position to insert the copy at (0-indexed)
+             * @return The number of BWT reorder operations performed
+             * @throws std::logic_error if len < 1, src + len >= text_size(), or dst >= text_size()
+             * @note Time complexity: Average O((len + L_avg) log σ log n) in addition to computing ISA[src+len]. O(min(len, SUBSTRING_BLOCK_SIZE)) extra space.
+             */
+            uint64_t copy_substring(TextIndex src, uint64_t len, TextIndex dst)
+            {
+                if (len < 1)
+                {
+                    throw std::logic_error("The length of the copied substring is at least 1.");
+                }
+                if (src + len >= this->text_size())
+                {
+                    throw std::logic_error("The copied substring must not contain the end marker.");
+                }
+                if (dst >= this->text_size())
+                {
+                    throw std::logic_error("The insertion position must be less than the length of the text.");
+                }
+                EditAnchor anchor;
+                return this->copy_substring(src, len, dst, anchor);
+            }
+
+            /**
+             * @brief Move the substring T[src..src+len-1] so that it starts just before the character T[dst] of the current text
+             * @details The substring is copied to \p dst as in copy_substring(), and then it is deleted from its original position, which is shifted by \p len if dst < src.
+             * The deletion reuses the EditAnchor of the copy.
+             * @param src The starting position of the moved substring
+             * @param len The length of the moved substring
+             * @param dst A text position outside T[src+1..src+len-1] (0-indexed). The substring is not moved if \p dst is \p src or src + len.
+             * @return The number of BWT reorder operations performed
+             * @throws std::logic_error if len < 1, src + len >= text_size(), dst >= text_size(), or src < dst < src + len
+             * @note Time complexity: Average O((len + L_avg) log σ log n) in addition to computing ISA[src+len]
+             */
+            uint64_t move_substring(TextIndex src, uint64_t len, TextIndex dst)
+            {
+                if (len < 1)
+                {
+                    throw std::logic_error("The length of the moved substring is at least 1.");
+                }
+                if (src + len >= this->text_size())
+                {
+                    throw std::logic_error("The moved substring must not contain the end marker.");
+                }
+                if (dst >= this->text_size())
+                {
+                    throw std::logic_error("The insertion position must be less than the length of the text.");
+                }
+                if (src < dst && dst < src + len)
+                {
+                    throw std::logic_error("The insertion position must not be inside the moved substring.");
+                }
+                if (dst == src || dst == src + len)
+                {
+                    return 0;
+                }
+
+                EditAnchor anchor;
+                uint64_t counter = this->copy_substring(src, len, dst, anchor);
+                FMIndexEditHistory history;
+                counter += this->delete_string(dst < src ? src + len : src, len, history, &anchor);
+                return counter;
+            }
+
+            /**
+             * @brief Merge non-maximal runs in the RLBWT, starting from the run index \p cursor
+             * @details Two adjacent runs with the same character are merged into one run, and the two sampled SA values at the boundary between them are removed from the dynamic phi.
+             * At most \p max_steps pairs of adjacent runs are examined, so that this function can be called in bounded slices between updates.
+             * @param cursor The run index at which the compaction starts. It is updated to the run index at which the next call should resume, or run_count() if the compaction has reached the last run.
+             * @param max_steps The maximal number of pairs of adjacent runs examined in this call
+             * @return The number of merged pairs of runs
+             * @note O(max_steps log n) time
+             */
+            uint64_t compact_runs(uint64_t &cursor, uint64_t max_steps)
+            {
+                uint64_t merge_count = 0;
+                uint64_t step = 0;
+                while (cursor + 1 < this->dbwt.run_count() && step < max_steps)
+                {
+                    if (DynamicRLBWTHelper::try_to_merge_runs(this->dbwt, cursor))
+                    {
+                        this->disa.merge_runs(cursor);
+                        if (this->update_log != nullptr)
+                        {
+                            this->update_log->write_operation(UpdateLogOperation::MergeRuns);
+                            this->update_log->write_value(cursor);
+                        }
+                        merge_count++;
+                    }
+                    else
+                    {
+                        cursor++;
+                    }
+                    step++;
+                }
+                if (cursor + 1 >= this->dbwt.run_count())
+                {
+                    cursor = this->dbwt.run_count();
+                }
+                if (merge_count > 0)
+                {
+                    this->write_checksum_to_update_log();
+                }
+                return merge_count;
+            }
+
+            /**
+             * @brief Merge non-maximal runs in the RLBWT, starting from the run index \p cursor, until \p time_limit elapses
+             * @details The time limit is measured with std::chrono::steady_clock and checked every COMPACTION_TIME_CHECK_INTERVAL steps. See compact_runs(uint64_t &, uint64_t) for the details.
+             * @return The number of merged pairs of runs
+             */
+            uint64_t compact_runs(uint64_t &cursor, std::chrono::microseconds time_limit)
+            {
+                std::chrono::steady_clock::time_point st = std::chrono::steady_clock::now();
+                uint64_t merge_count = 0;
+                while (cursor < this->dbwt.run_count())
+                {
+                    merge_count += this->compact_runs(cursor, BasicDynamicRIndex::COMPACTION_TIME_CHECK_INTERVAL);
+                    if (std::chrono::steady_clock::now() - st >= time_limit)
+                    {
+                        break;
+                    }
+                }
+                return merge_count;
+            }
+
+            /**
+             * @brief Merge all the non-maximal runs in the RLBWT
+             * @return The number of merged pairs of runs
+             * @note O(r log n) time
+             */
+            uint64_t compact_runs()
+            {
+                uint64_t cursor = 0;
+                return this->compact_runs(cursor, UINT64_MAX);
+            }
+
+            /**
+             * @brief Return the hash value of the RLBWT (see DynamicRLBWT::compute_RLBWT_hash())
+             * @note O(1) time if set_run_hash_enabled() is enabled, and O(r log r) time otherwise
+             */
             uint64_t compute_RLBWT_hash(int message_paragraph = stool::Message::SHOW_MESSAGE) const
             {
                 return this->dbwt.compute_RLBWT_hash(message_paragraph);
             }
 
+            /**
+             * @brief Apply the updates recorded in \p log (see set_update_log()) to this index
+             * @details This index must be a replica of the recorded index, i.e., it must index the same text as the recorded index when the recording started.
+             * Each record stores the positions on the BWT and the SA values computed by the recorded index,
+             * and hence this function updates the RLBWT and the dynamic phi without computing LF, phi, or ISA.
+             * The applied updates are not recorded in the log of this index.
+             * After each update, the hash of the RLBWT is compared with the checksum recorded by the recorded index, and hence this function enables the maintenance of the hash (see set_run_hash_enabled()).
+             * @throws std::runtime_error if \p log has another version, is truncated, or contains an invalid record, or if this index has diverged from the recorded index.
+             * The updates before the failed record remain applied.
+             * @note O(k log n) time, where k is the number of the records in \p log (excluding Rebuild records, each of which takes O(n log σ log n) time)
+             */
+            void apply_update_log(const RIndexUpdateLog &log)
+            {
+                if (!this->dbwt.is_run_hash_enabled())
+                {
+                    this->dbwt.set_run_hash_enabled(true);
+                }
+                RIndexUpdateLog *tmp_log = this->update_log;
+                this->update_log = nullptr;
+                try
+                {
+                    this->apply_update_log_records(log);
+                }
+                catch (...)
+                {
+                    this->update_log = tmp_log;
+                    throw;
+                }
+                this->update_log = tmp_log;
+            }
+
+        private:
+            /**
+             * @brief Apply the records of \p log to this index (see apply_update_log())
+             */
+            void apply_update_log_records(const RIndexUpdateLog &log)
+            {
+                uint64_t pos = 0;
+                log.read_version(pos);
+                while (pos < log.size())
+                {
+                    UpdateLogOperation op = log.read_operation(pos);
+                    switch (op)
+                    {
+                    case UpdateLogOperation::Replace:
+                    {
+                        TextIndex x = log.read_value(pos);
+                        RunPosition x_on_rlbwt = this->dbwt.to_run_position(log.read_value(pos));
+                        uint8_t new_char = log.read_value(pos);
+                        SAValue phi_x = log.read_value(pos);
+                        SAValue inv_phi_x = log.read_value(pos);
+                        PrimitiveUpdateOperations::r_replace(x, x_on_rlbwt, new_char, phi_x, inv_phi_x, this->dbwt, this->disa);
+                    }
+                    break;
+                    case UpdateLogOperation::Insert:
+                    {
+                        TextIndex u = log.read_value(pos);
+                        SAIndex i = log.read_value(pos);
+                        uint8_t c = log.read_value(pos);
+                        SAValue value_at_i_minus = log.read_value(pos);
+                        SAValue value_at_i_plus = log.read_value(pos);
+                        PrimitiveUpdateOperations::r_insert(u, i, c, value_at_i_minus, value_at_i_plus, this->dbwt, this->disa);
+                    }
+                    break;
+                    case UpdateLogOperation::DeleteForDeletion:
+                    {
+                        RunPosition u_on_rlbwt = this->dbwt.to_run_position(log.read_value(pos));
+                        uint8_t c = log.read_value(pos);
+                        SAValue phi_u = log.read_value(pos);
+                        SAValue inv_phi_u = log.read_value(pos);
+                        PrimitiveUpdateOperations::r_delete_for_deletion(u_on_rlbwt, c, phi_u, inv_phi_u, this->dbwt, this->disa);
+                    }
+                    break;
+                    case UpdateLogOperation::ShrinkText:
+                    {
+                        TextIndex u = log.read_value(pos);
+                        uint64_t len = log.read_value(pos);
+                        PrimitiveUpdateOperations::r_shrink_text(u, len, this->disa);
+                    }
+                    break;
+                    case UpdateLogOperation::Move:
+                    {
+                        PositionInformation y_PI;
+                        PositionInformation z_PI;
+                        y_PI.p = log.read_value(pos);
+                        uint8_t y_char = log.read_value(pos);
+                        y_PI.value_at_p = log.read_value(pos);
+                        y_PI.value_at_p_minus = log.read_value(pos);
+                        y_PI.value_at_p_plus = log.read_value(pos);
+                        z_PI.p = log.read_value(pos);
+                        z_PI.value_at_p_minus = log.read_value(pos);
+                        z_PI.value_at_p_plus = log.read_value(pos);
+                        RunPosition y_on_rlbwt = this->dbwt.to_run_position(y_PI.p);
+                        PrimitiveUpdateOperations::r_move(y_PI.p, y_on_rlbwt, y_char, y_PI, z_PI, this->dbwt, this->disa);
+                    }
+                    break;
+                    case UpdateLogOperation::ExtendText:
+                    {
+                        TextIndex i = log.read_value(pos);
+                        uint64_t m = log.read_value(pos);
+                        this->disa.extend_text(i, m);
+                    }
+                    break;
+                    case UpdateLogOperation::MergeRuns:
+                    {
+                        uint64_t run_index = log.read_value(pos);
+                        if (!DynamicRLBWTHelper::try_to_merge_runs(this->dbwt, run_index))
+                        {
+                            throw std::runtime_error("RIndexUpdateLog: the runs at " + std::to_string(run_index) + " cannot be merged");
+                        }
+                        this->disa.merge_runs(run_index);
+                    }
+                    break;
+                    case UpdateLogOperation::ExtendAlphabet:
+                    {
+                        this->dbwt.extend_alphabet(log.read_string(pos));
+                    }
+                    break;
+                    case UpdateLogOperation::Rebuild:
+                    {
+                        TextIndex u = log.read_value(pos);
+                        uint64_t len = log.read_value(pos);
+                        std::vector<uint8_t> inserted_string = log.read_string(pos);
+                        this->rebuild_with_edited_text(u, len, inserted_string);
+                    }
+                    break;
+                    case UpdateLogOperation::Checksum:
+                    {
+                        uint64_t hash = log.read_value(pos);
+                        if (hash != this->dbwt.compute_RLBWT_hash(stool::Message::NO_MESSAGE))
+                        {
+                            throw std::runtime_error("RIndexUpdateLog: this index has diverged from the recorded index (the hash of the RLBWT differs)");
+                        }
+                    }
+                    break;
+                    }
+                }
+            }
+
+            /**
+             * @brief Return T[i..i+len-1], computing ISA[i+len] from \p anchor if it is close to i+len (see compute_isa_by_anchor())
+             * @details \p anchor is replaced with the pair of \p i and ISA[i], which is reached by the LF walk.
+             */
+            std::vector<uint8_t> access_substring_of_text(uint64_t i, uint64_t len, EditAnchor &anchor) const
+            {
+                uint64_t j;
+                if (i + len < this->text_size())
+                {
+                    j = this->compute_isa_by_anchor(i + len, anchor);
+                    if (j == UINT64_MAX)
+                    {
+                        j = this->disa.isa(i + len, this->dbwt);
+                    }
+                }
+                else
+                {
+                    j = this->dbwt.get_end_marker_pos();
+                }
+
+                std::vector<uint8_t> output;
+                output.resize(len, UINT8_MAX);
+                for (int64_t x = len - 1; x >= 0; x--)
+                {
+                    output[x] = this->dbwt.access(j);
+                    j = this->dbwt.LF(j);
+                }
+                anchor.text_position = i;
+                anchor.sa_index = j;
+                return output;
+            }
+
+            /**
+             * @brief Insert a copy of T[src..src+len-1] at \p dst in blocks, sharing \p anchor among the edits (see copy_substring())
+             * @details The blocks are inserted from the last one, and a block never contains both characters before and after \p dst.
+             * Hence every original position p of the remaining blocks is at p in the current text if p < dst, and at p plus the number of inserted characters otherwise.
+             */
+            uint64_t copy_substring(TextIndex src, uint64_t len, TextIndex dst, EditAnchor &anchor)
+            {
+                FMIndexEditHistory history;
+                uint64_t counter = 0;
+                uint64_t end = src + len;
+                while (end > src)
+                {
+                    uint64_t begin = end - std::min(end - src, BasicDynamicRIndex::SUBSTRING_BLOCK_SIZE);
+                    if (begin < dst && dst < end)
+                    {
+                        begin = dst;
+                    }
+                    uint64_t inserted_length = (src + len) - end;
+                    uint64_t current_begin = begin >= dst ? begin + inserted_length : begin;
+                    std::vector<uint8_t> block = this->access_substring_of_text(current_begin, end - begin, anchor);
+                    counter += this->insert_string(dst, block, history, &anchor);
+                    end = begin;
+                }
+                return counter;
+            }
+
+            /**
+             * @brief Return ISA[i] computed from \p anchor if the walk from \p anchor is shorter than the walk from the nearest sampled position, otherwise UINT64_MAX
+             */
+            SAIndex compute_isa_by_anchor(TextIndex i, EditAnchor &anchor) const
+            {
+                uint64_t n = this->text_size();
+                uint64_t d = anchor.distance(i, n);
+                if (d == UINT64_MAX || anchor.sa_index >= n)
+                {
+                    return UINT64_MAX;
+                }
+                std::pair<uint64_t, uint64_t> nearest = this->disa.nearest_search_by_text_position(i, this->dbwt);
+                uint64_t sample_distance = nearest.second <= i ? i - nearest.second : nearest.second - i;
+                sample_distance = std::min(sample_distance, n - sample_distance);
+                if (d >= sample_distance)
+                {
+                    return UINT64_MAX;
+                }
+                anchor.use_count++;
+                return anchor.compute_isa(i, n, this->dbwt);
+            }
+
+            /**
+             * @brief Verify the consistency between LF and phi at the run with the index \p run_index (see verify_by_sampling())
+             */
+            void verify_run_by_sampling(uint64_t run_index) const
+            {
+                uint64_t n = this->dbwt.text_size();
+                uint64_t r = this->dbwt.run_count();
+                uint64_t len = this->dbwt.get_run_length(run_index);
+                uint64_t f = this->disa.get_sampled_first_sa_value(run_index);
+                uint64_t l = this->disa.get_sampled_last_sa_value(run_index);
+                uint64_t prev_l = this->disa.get_sampled_last_sa_value(run_index > 0 ? run_index - 1 : r - 1);
+
+                if (this->disa.phi(f) != prev_l || this->disa.inverse_phi(prev_l) != f)
+                {
+                    throw std::logic_error("Verification Error: phi at the run " + std::to_string(run_index));
+                }
+                if (len >= 2)
+                {
+                    if (this->disa.inverse_phi((f + n - 1) % n) != (this->disa.inverse_phi(f) + n - 1) % n || this->disa.phi((l + n - 1) % n) != (this->disa.phi(l) + n - 1) % n)
+                    {
+                        throw std::logic_error("Verification Error: phi in the run " + std::to_string(run_index));
+                    }
+                }
+
+                uint64_t lf_first = this->dbwt.LF(run_index, 0);
+                uint64_t lf_last = this->dbwt.LF(run_index, len - 1);
+                if (lf_last != lf_first + len - 1)
+                {
+                    throw std::logic_error("Verification Error: LF in the run " + std::to_string(run_index));
+                }
+                RunPosition rp1 = this->dbwt.to_run_position(lf_first);
+                if (rp1.position_in_run == 0 && this->disa.get_sampled_first_sa_value(rp1.run_index) != (f + n - 1) % n)
+                {
+                    throw std::logic_error("Verification Error: LF and SA at the run " + std::to_string(run_index));
+                }
+                RunPosition rp2 = this->dbwt.to_run_position(lf_last);
+                if (rp2.position_in_run + 1 == this->dbwt.get_run_length(rp2.run_index) && this->disa.get_sampled_last_sa_value(rp2.run_index) != (l + n - 1) % n)
+                {
+                    throw std::logic_error("Verification Error: LF and SA at the run " + std::to_string(run_index));
+                }
+            }
+
+            /**
+             * @brief Add the characters of \p str not contained in the alphabet to it
+             */
+            void extend_alphabet(const std::vector<uint8_t> &str)
+            {
+                bool b = this->dbwt.extend_alphabet(str);
+                if (b && this->update_log != nullptr)
+                {
+                    this->update_log->write_operation(UpdateLogOperation::ExtendAlphabet);
+                    this->update_log->write_string(str);
+                }
+            }
+
+            /**
+             * @brief Write the hash of the RLBWT to the update log as the checksum of the last update (see apply_update_log())
+             */
+            void write_checksum_to_update_log()
+            {
+                if (this->update_log != nullptr)
+                {
+                    this->update_log->write_operation(UpdateLogOperation::Checksum);
+                    this->update_log->write_value(this->dbwt.compute_RLBWT_hash(stool::Message::NO_MESSAGE));
+                }
+            }
+
+            /**
+             * @brief Rebuild this index from the text obtained by replacing T[u..u+len-1] with \p inserted_string
+             * @details The edited text (n bytes) is parsed by prefix-free parsing (see PrefixFreeParsing), and it is freed before the new RLBWT and dynamic phi are built from the runs.
+             * Hence neither the suffix array nor the BWT of the edited text is materialized.
+             * @note O(n log σ log n) time for extracting the text, and O(n) time and space in addition to the space of the parse for the parsing
+             */
+            void rebuild_with_edited_text(TextIndex u, uint64_t len, const std::vector<uint8_t> &inserted_string)
+            {
+                if (this->update_log != nullptr)
+                {
+                    this->update_log->write_operation(UpdateLogOperation::Rebuild);
+                    this->update_log->write_value(u);
+                    this->update_log->write_value(len);
+                    this->update_log->write_string(inserted_string);
+                }
+                std::vector<uint8_t> rlbwt_char_vector;
+                std::vector<uint64_t> rlbwt_run_length_vector;
+                std::vector<uint64_t> sampled_first_sa_indexes;
+                std::vector<uint64_t> sampled_last_sa_indexes;
+                {
+                    std::vector<uint8_t> text = this->dbwt.get_text();
+                    text.erase(text.begin() + u, text.begin() + u + len);
+                    text.insert(text.begin() + u, inserted_string.begin(), inserted_string.end());
+                    PrefixFreeParsing::build([&text]()
+                                             { return std::make_unique<RandomAccessStream<ByteVectorReader>>(ByteVectorReader(text)); }, this->dbwt.get_end_marker(), rlbwt_char_vector, rlbwt_run_length_vector, sampled_first_sa_indexes, sampled_last_sa_indexes,
+                                             PrefixFreeParsing::DEFAULT_WINDOW_SIZE, PrefixFreeParsing::DEFAULT_MODULUS, stool::Message::NO_MESSAGE);
+                }
+                uint64_t text_size = 0;
+                for (uint64_t run_length : rlbwt_run_length_vector)
+                {
+                    text_size += run_length;
+                }
+
+                BasicDynamicRIndex tmp;
+                {
+                    DynamicPhi tmp_disa = DynamicPhi::build_from_sampled_sa_indexes(sampled_last_sa_indexes, sampled_first_sa_indexes, text_size, stool::Message::NO_MESSAGE);
+                    tmp.disa.swap(tmp_disa);
+                }
+                std::vector<uint64_t>().swap(sampled_first_sa_indexes);
+                std::vector<uint64_t>().swap(sampled_last_sa_indexes);
+                {
+                    RLBWT tmp_dbwt = RLBWT::build_from_RLBWT(rlbwt_char_vector, rlbwt_run_length_vector, this->dbwt.to_alphabet_vector(), stool::Message::NO_MESSAGE);
+                    tmp.dbwt.swap(tmp_dbwt);
+                }
+                if (this->dbwt.is_run_permutation_enabled())
+                {
+                    tmp.dbwt.set_run_permutation_enabled(true);
+                }
+                if (this->dbwt.is_run_hash_enabled())
+                {
+                    tmp.dbwt.set_run_hash_enabled(true);
+                }
+                this->dbwt.swap(tmp.dbwt);
+                this->disa.swap(tmp.disa);
+            }
+
+            /**
+             * @brief Return true if the update replacing T[u..u+len-1] with \p inserted_string should be performed by rebuilding this index
+             */
+            bool exceeds_rebuild_threshold(TextIndex u, uint64_t len, const std::vector<uint8_t> &inserted_string) const
+            {
+                uint64_t threshold = this->get_effective_rebuild_threshold();
+                if (threshold == BasicDynamicRIndex::NO_REBUILD_THRESHOLD)
+                {
+                    return false;
+                }
+                return this->estimate_reorder_count(u, len, inserted_string, threshold) >= threshold;
+            }
+
+        public:
+
             //@}
             ////////////////////////////////////////////////////////////////////////////////
             ///   @name Public Methods for Debug
@@ -995,5 +2181,17 @@ namespace stool
             //@}
         };
 
+        /**
+         * @brief The dynamic r-index with the default C array (CArray)
+         * \ingroup DynamicRIndexes
+         */
+        using DynamicRIndex = BasicDynamicRIndex<CArray>;
+
+        /**
+         * @brief The dynamic r-index with the C array supporting O(√σ)-time updates (BlockedCArray)
+         * \ingroup DynamicRIndexes
+         */
+        using BlockedDynamicRIndex = BasicDynamicRIndex<BlockedCArray>;
+
     }
 }
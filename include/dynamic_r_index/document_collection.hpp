@@ -0,0 +1,270 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include "stool/include/lib.hpp"
+#include "./random_access_stream.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief A collection of documents stored in files, regarded as the concatenation D_1 # D_2 # ... # D_d of the documents, where # is a separator character
+         * @details The concatenation is never written to disk: open() returns a seekable stream that reads the files on demand.
+         * The starting positions of the documents in the concatenation are kept, and they can be stored in a file and used to map a text position (e.g., an occurrence of a pattern) to its document.
+         * @note The starting positions are not updated by the updates of an index built from this collection.
+         * \ingroup DynamicRIndexes
+         */
+        class DocumentCollection
+        {
+            static inline constexpr uint64_t LOAD_KEY = 3141592653;
+
+            std::vector<std::string> file_paths;
+            std::vector<uint64_t> file_sizes;
+            std::vector<uint64_t> starting_positions;
+            uint8_t separator = 1;
+            uint64_t total_size = 0;
+
+            /**
+             * @brief A reader of the concatenation of the documents, which keeps the file of the last read document open
+             */
+            class DocumentReader
+            {
+                const DocumentCollection *collection;
+                std::ifstream ifs;
+                uint64_t opened_document = UINT64_MAX;
+
+            public:
+                DocumentReader(const DocumentCollection &_collection) : collection(&_collection)
+                {
+                }
+
+                uint64_t size() const
+                {
+                    return this->collection->size();
+                }
+
+                /**
+                 * @brief Copy the characters of the concatenation starting at \p pos to \p output (at most \p max_len characters), and return the number of the copied characters
+                 */
+                uint64_t read(uint64_t pos, char *output, uint64_t max_len)
+                {
+                    const DocumentCollection &c = *this->collection;
+                    uint64_t len = 0;
+                    while (len < max_len && pos < c.total_size)
+                    {
+                        uint64_t k = c.get_document_index(pos);
+                        uint64_t offset = pos - c.starting_positions[k];
+                        if (offset < c.file_sizes[k])
+                        {
+                            if (this->opened_document != k)
+                            {
+                                this->ifs.close();
+                                this->ifs.clear();
+                                this->ifs.open(c.file_paths[k], std::ios::binary);
+                                if (!this->ifs)
+                                {
+                                    throw std::runtime_error("Cannot open the file: " + c.file_paths[k]);
+                                }
+                                this->opened_document = k;
+                            }
+                            uint64_t x = std::min(max_len - len, c.file_sizes[k] - offset);
+                            this->ifs.clear();
+                            this->ifs.seekg(offset, std::ios::beg);
+                            this->ifs.read(output + len, x);
+                            if ((uint64_t)this->ifs.gcount() != x)
+                            {
+                                throw std::runtime_error("The file was changed during the construction: " + c.file_paths[k]);
+                            }
+                            len += x;
+                            pos += x;
+                        }
+                        else
+                        {
+                            output[len++] = (char)c.separator;
+                            pos++;
+                        }
+                    }
+                    return len;
+                }
+            };
+
+        public:
+            DocumentCollection()
+            {
+            }
+
+            /**
+             * @brief Construct the collection of the given files
+             * @param _file_paths The paths of the documents in this order
+             * @param _separator The character inserted between two consecutive documents
+             * @throws std::runtime_error if a file cannot be opened, or a document contains \p _separator
+             * @note Every file is scanned once, because a separator in a document would break the document boundaries.
+             */
+            DocumentCollection(const std::vector<std::string> &_file_paths, uint8_t _separator) : file_paths(_file_paths), separator(_separator)
+            {
+                std::vector<char> buffer(1 << 16);
+                for (uint64_t i = 0; i < this->file_paths.size(); i++)
+                {
+                    std::ifstream ifs(this->file_paths[i], std::ios::binary);
+                    if (!ifs)
+                    {
+                        throw std::runtime_error("Cannot open the file: " + this->file_paths[i]);
+                    }
+                    uint64_t file_size = 0;
+                    while (ifs)
+                    {
+                        ifs.read(buffer.data(), buffer.size());
+                        uint64_t len = ifs.gcount();
+                        if (std::find(buffer.begin(), buffer.begin() + len, (char)this->separator) != buffer.begin() + len)
+                        {
+                            throw std::runtime_error("The document contains the separator: " + this->file_paths[i]);
+                        }
+                        file_size += len;
+                    }
+                    if (ifs.bad())
+                    {
+                        throw std::runtime_error("Cannot read the file: " + this->file_paths[i]);
+                    }
+
+                    this->starting_positions.push_back(this->total_size);
+                    this->file_sizes.push_back(file_size);
+                    this->total_size += file_size + (i + 1 < this->file_paths.size() ? 1 : 0);
+                }
+            }
+
+            /**
+             * @brief Return the paths of the input files specified by \p path
+             * @details If \p path is a directory, the regular files in it are returned in lexicographic order of their paths.
+             * Otherwise, \p path is a list of input files, and its non-empty lines are returned.
+             * @throws std::runtime_error if \p path cannot be opened
+             */
+            static std::vector<std::string> get_file_paths(const std::string &path)
+            {
+                std::vector<std::string> r;
+                if (std::filesystem::is_directory(path))
+                {
+                    for (const auto &entry : std::filesystem::directory_iterator(path))
+                    {
+                        if (entry.is_regular_file())
+                        {
+                            r.push_back(entry.path().string());
+                        }
+                    }
+                    std::sort(r.begin(), r.end());
+                }
+                else
+                {
+                    std::ifstream ifs(path);
+                    if (!ifs)
+                    {
+                        throw std::runtime_error("Cannot open the file: " + path);
+                    }
+                    std::string line;
+                    while (std::getline(ifs, line))
+                    {
+                        if (line.size() > 0 && line[line.size() - 1] == '\r')
+                        {
+                            line.pop_back();
+                        }
+                        if (line.size() > 0)
+                        {
+                            r.push_back(line);
+                        }
+                    }
+                }
+                return r;
+            }
+
+            /**
+             * @brief Return the length of the concatenation of the documents (without the end marker)
+             */
+            uint64_t size() const
+            {
+                return this->total_size;
+            }
+
+            /**
+             * @brief Return the number of the documents
+             */
+            uint64_t document_count() const
+            {
+                return this->file_paths.size();
+            }
+
+            uint8_t get_separator() const
+            {
+                return this->separator;
+            }
+
+            const std::vector<std::string> &get_file_paths() const
+            {
+                return this->file_paths;
+            }
+
+            /**
+             * @brief Return the starting position of each document in the concatenation
+             */
+            const std::vector<uint64_t> &get_starting_positions() const
+            {
+                return this->starting_positions;
+            }
+
+            /**
+             * @brief Return the index of the document containing the position \p i of the concatenation (a separator belongs to the preceding document)
+             */
+            uint64_t get_document_index(uint64_t i) const
+            {
+                auto it = std::upper_bound(this->starting_positions.begin(), this->starting_positions.end(), i);
+                return std::distance(this->starting_positions.begin(), it) - 1;
+            }
+
+            /**
+             * @brief Return a new seekable stream of the concatenation of the documents
+             * @note This collection must be alive while the stream is used.
+             */
+            std::unique_ptr<std::istream> open() const
+            {
+                return std::make_unique<RandomAccessStream<DocumentReader>>(DocumentReader(*this));
+            }
+
+            /**
+             * @brief Save the starting positions of the documents to a file
+             */
+            static void store_starting_positions_to_file(const DocumentCollection &item, std::ofstream &os)
+            {
+                uint64_t key = LOAD_KEY;
+                uint64_t count = item.starting_positions.size();
+                os.write(reinterpret_cast<const char *>(&key), sizeof(uint64_t));
+                os.write(reinterpret_cast<const char *>(&count), sizeof(uint64_t));
+                os.write(reinterpret_cast<const char *>(item.starting_positions.data()), sizeof(uint64_t) * count);
+            }
+
+            /**
+             * @brief Load the starting positions of documents stored by store_starting_positions_to_file()
+             * @throws std::runtime_error if the file does not store starting positions of documents
+             */
+            static std::vector<uint64_t> load_starting_positions_from_file(std::ifstream &ifs)
+            {
+                uint64_t key = 0;
+                uint64_t count = 0;
+                ifs.read(reinterpret_cast<char *>(&key), sizeof(uint64_t));
+                if (key != LOAD_KEY)
+                {
+                    throw std::runtime_error("This data is not the starting positions of documents!");
+                }
+                ifs.read(reinterpret_cast<char *>(&count), sizeof(uint64_t));
+                std::vector<uint64_t> r;
+                r.resize(count);
+                ifs.read(reinterpret_cast<char *>(r.data()), sizeof(uint64_t) * count);
+                return r;
+            }
+        };
+    }
+}
@@ -443,6 +443,32 @@ namespace stool
                 // return PackedSPSIWrapper::verify(this->sampled_isa_gap_vector, true);
             }
 
+            /**
+             * @brief Verify the consistency between the permutation and the gap vector without materializing the sampled SA
+             * @details The sampled text positions must be distinct and less than the text size, and the permutation must have the same size as the gap vector.
+             * @note O(k) time, where k is the number of sampled positions. Throws std::logic_error if verification fails
+             */
+            void verify_structure() const
+            {
+                if ((int64_t)this->pom.size() != this->size())
+                {
+                    throw std::logic_error("Error: DynamicPartialSA::verify_structure(), the size of the permutation");
+                }
+                uint64_t i = 0;
+                for (uint64_t gap : this->sampled_isa_gap_vector)
+                {
+                    if (i > 0 && gap == 0)
+                    {
+                        throw std::logic_error("Error: DynamicPartialSA::verify_structure(), the same sampled positions");
+                    }
+                    i++;
+                }
+                if (this->size() > 0 && this->sampled_isa_gap_vector.psum() >= this->_text_size)
+                {
+                    throw std::logic_error("Error: DynamicPartialSA::verify_structure(), a sampled position is out of the text");
+                }
+            }
+
             /**
              * @brief Get the number of sampled positions
              * @return The size of the sampled suffix array
@@ -531,6 +557,25 @@ namespace stool
                 assert(this->verify());
             }
 
+            /**
+             * @brief Insert \p len characters into the input text at a position and appropriately shift the sampled suffix array values.
+             * @param new_position The characters are inserted into the input text at this position
+             * @param len The number of inserted characters
+             * @note Since the sampled values are gap-encoded, only one gap is updated (O(log r) time), whereas \p len calls of extend_text(new_position) take O(len log r) time.
+             */
+            void extend_text(int64_t new_position, uint64_t len)
+            {
+                int64_t idx = this->sampled_isa_gap_vector.successor_index(new_position);
+
+                if (idx != -1)
+                {
+                    this->sampled_isa_gap_vector.increment(idx, len);
+                }
+                this->_text_size += len;
+
+                assert(this->verify());
+            }
+
             /**
              * @brief Remove the character at a position from the input text and appropriately shift the sampled suffix array values.
              * @param removed_position The character at this position is removed from the input text
@@ -554,6 +599,31 @@ namespace stool
                 assert(this->verify());
             }
 
+            /**
+             * @brief Remove \p len characters from the input text at a position and appropriately shift the sampled suffix array values.
+             * @param removed_position The characters in T[removed_position..removed_position+len-1] are removed from the input text
+             * @param len The number of removed characters
+             * @note No sampled value may lie in the removed range when this function is called.
+             * Since the sampled values are gap-encoded, only one gap is updated (O(log r) time), whereas \p len calls of shrink_text(removed_position) take O(len log r) time.
+             */
+            void shrink_text(int64_t removed_position, uint64_t len)
+            {
+                int64_t idx = this->sampled_isa_gap_vector.successor_index(removed_position);
+
+                if (idx != -1)
+                {
+                    uint64_t gap = this->sampled_isa_gap_vector.at(idx);
+                    if (gap < len)
+                    {
+                        throw std::logic_error("Error: shrink_text");
+                    }
+                    this->sampled_isa_gap_vector.decrement(idx, len);
+                }
+                this->_text_size -= len;
+
+                assert(this->verify());
+            }
+
             /**
              * @brief Add a new sampled suffix array value into this data structure
              * @param new_sa_index the new suffix array value is inserted into this data structure at this position
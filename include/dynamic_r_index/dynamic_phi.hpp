@@ -1,5 +1,6 @@
 #pragma once
 #include "./dynamic_partial_sa.hpp"
+#include "../dynamic_fm_index/tools.hpp"
 #include "stool/include/lib.hpp"
 #include "b_tree_plus_alpha/include/all.hpp"
 
@@ -148,14 +149,7 @@ namespace stool
                 r.sampled_last_sa.swap(tmp_lsa);
 
                 st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && __text_size > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)__text_size) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, __text_size);
 
                 return r;
             }
@@ -397,6 +391,34 @@ namespace stool
                 return b1 && b2;
             }
             
+            /**
+             * @brief Verify the invariants of the DynamicPhi structure that can be checked without computing SA and ISA (see DynamicPartialSA::verify_structure())
+             * @note O(r) time. Throws std::logic_error if verification fails
+             */
+            void verify_structure() const
+            {
+                if (this->sampled_first_sa.size() != this->sampled_last_sa.size())
+                {
+                    throw std::logic_error("Error: DynamicPhi::verify_structure(), the numbers of the sampled SA values");
+                }
+                if (this->sampled_first_sa._text_size != this->sampled_last_sa._text_size)
+                {
+                    throw std::logic_error("Error: DynamicPhi::verify_structure(), the text sizes");
+                }
+                this->sampled_first_sa.verify_structure();
+                this->sampled_last_sa.verify_structure();
+            }
+
+            /**
+             * @brief Get the sampled SA value at the last position of a run
+             * @param i The run index
+             * @return The SA value at the last position of run i
+             */
+            uint64_t get_sampled_last_sa_value(uint64_t i) const
+            {
+                return this->sampled_last_sa.get_sampled_sa_value(i);
+            }
+
             /**
              * @brief Get the sampled SA value at the first position of a run
              * @param i The run index
@@ -420,7 +442,8 @@ namespace stool
              * @param dbwt The DynamicRLBWT instance
              * @return The SA value after inverse phi mapping
              */
-            SAValue LF_inverse_phi(RunPosition i_rp, uint8_t new_c, SAValue sa_value_at_i_plus, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_inverse_phi(RunPosition i_rp, uint8_t new_c, SAValue sa_value_at_i_plus, const RLBWT &dbwt) const
             {
 
                 uint8_t i_c = dbwt.get_char(i_rp.run_index);
@@ -450,7 +473,8 @@ namespace stool
              * @param u_value_inv_phi The inverse phi value at position u
              * @return The computed SA value
              */
-            SAValue LF_inverse_phi_for_deletion_sub(RunPosition u, const DynamicRLBWT &dbwt, uint64_t u_value_inv_phi) const
+            template <typename RLBWT>
+            SAValue LF_inverse_phi_for_deletion_sub(RunPosition u, const RLBWT &dbwt, uint64_t u_value_inv_phi) const
             {
                 uint64_t run_length = dbwt.get_run_length(u.run_index);
                 if (u.position_in_run + 1 < run_length)
@@ -478,7 +502,8 @@ namespace stool
              * @param u_value_inv_phi The inverse phi value at position u
              * @return The computed SA value after inverse phi mapping
              */
-            SAValue LF_inverse_phi_for_deletion(RunPosition i_rp, SAValue sa_value_at_i_plus, const DynamicRLBWT &dbwt, uint64_t i_pos, uint64_t next_i_pos, uint64_t u_value, uint64_t u_value_inv_phi) const
+            template <typename RLBWT>
+            SAValue LF_inverse_phi_for_deletion(RunPosition i_rp, SAValue sa_value_at_i_plus, const RLBWT &dbwt, uint64_t i_pos, uint64_t next_i_pos, uint64_t u_value, uint64_t u_value_inv_phi) const
             {
                 if (next_i_pos + 1 == i_pos)
                 {
@@ -531,7 +556,8 @@ namespace stool
              * @param dbwt The DynamicRLBWT instance
              * @return true if replaced_char succeeds the character at i_rp
              */
-            bool check_whether_succeeding_replaced_char(RunPosition i_rp, uint8_t replaced_char, SAIndex replaced_sa_index, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            bool check_whether_succeeding_replaced_char(RunPosition i_rp, uint8_t replaced_char, SAIndex replaced_sa_index, const RLBWT &dbwt) const
             {
                 uint8_t i_c = dbwt.get_char(i_rp.run_index);
                 uint64_t i = dbwt.get_position(i_rp.run_index, i_rp.position_in_run);
@@ -545,7 +571,8 @@ namespace stool
              * @param dbwt The DynamicRLBWT instance
              * @return The computed SA value
              */
-            int64_t LF_phi_for_move(RunPosition i_on_rlbwt, SAValue sa_value_at_i_minus, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            int64_t LF_phi_for_move(RunPosition i_on_rlbwt, SAValue sa_value_at_i_minus, const RLBWT &dbwt) const
             {
 
                 if (i_on_rlbwt.position_in_run > 0)
@@ -568,7 +595,8 @@ namespace stool
              * @param dbwt The DynamicRLBWT instance
              * @return The computed SA value
              */
-            SAValue LF_inverse_phi_for_move(RunPosition i_on_rlbwt, SAValue sa_value_at_i_plus, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_inverse_phi_for_move(RunPosition i_on_rlbwt, SAValue sa_value_at_i_plus, const RLBWT &dbwt) const
             {
                 uint64_t run_length = dbwt.get_run_length(i_on_rlbwt.run_index);
 
@@ -596,7 +624,8 @@ namespace stool
              * @return The computed SA value
              * @note This method should be replaced with LF_inverse_phi_for_insertionX
              */
-            SAValue LF_inverse_phi_for_insertion(RunPosition i_rp, SAValue sa_value_at_i_plus, uint8_t replaced_char, SAIndex replaced_sa_index, uint64_t insertion_pos, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_inverse_phi_for_insertion(RunPosition i_rp, SAValue sa_value_at_i_plus, uint8_t replaced_char, SAIndex replaced_sa_index, uint64_t insertion_pos, const RLBWT &dbwt) const
             {
                 uint8_t i_c = dbwt.get_char(i_rp.run_index);
                 uint64_t run_length = dbwt.get_run_length(i_rp.run_index);
@@ -664,7 +693,8 @@ namespace stool
              * @return The computed SA value
              * @note This method contains a bug, but dynamic r-index works correctly. Will be fixed later.
              */
-            SAValue LF_inverse_phi_for_insertionX(RunPosition i_rp, SAValue sa_value_at_i_plus, SAIndex i_minus_p, uint64_t y_p, uint64_t insertion_pos, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_inverse_phi_for_insertionX(RunPosition i_rp, SAValue sa_value_at_i_plus, SAIndex i_minus_p, uint64_t y_p, uint64_t insertion_pos, const RLBWT &dbwt) const
             {
                 uint64_t b1 = false;
                 if (y_p + 1 < this->text_size())
@@ -708,7 +738,8 @@ namespace stool
              * @param dbwt The DynamicRLBWT instance
              * @return The computed SA value
              */
-            SAValue LF_phi_for_insertionX(RunPosition i_rp, SAValue sa_value_at_i_minus, SAIndex i_minus_p, uint64_t y_p, uint64_t insertion_pos, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_phi_for_insertionX(RunPosition i_rp, SAValue sa_value_at_i_minus, SAIndex i_minus_p, uint64_t y_p, uint64_t insertion_pos, const RLBWT &dbwt) const
             {
                 uint64_t b1 = false;
                 if (y_p != 0)
@@ -752,7 +783,8 @@ namespace stool
              * @return The computed SA value
              * @note This method should be replaced with LF_phi_for_insertionX
              */
-            SAValue LF_phi_for_insertion(RunPosition i_rp, SAValue sa_value_at_i_minus, uint8_t replaced_char, SAIndex replaced_sa_index, uint64_t insertion_pos, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_phi_for_insertion(RunPosition i_rp, SAValue sa_value_at_i_minus, uint8_t replaced_char, SAIndex replaced_sa_index, uint64_t insertion_pos, const RLBWT &dbwt) const
             {
                 uint8_t i_c = dbwt.get_char(i_rp.run_index);
                 // uint64_t run_length = dbwt.get_run_length(i_rp.run_index);
@@ -817,7 +849,8 @@ namespace stool
              * @param dbwt The DynamicRLBWT instance
              * @return The computed SA value
              */
-            SAValue LF_phi(RunPosition i, uint8_t old_c, uint8_t new_c, SAValue prev_sa_value, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_phi(RunPosition i, uint8_t old_c, uint8_t new_c, SAValue prev_sa_value, const RLBWT &dbwt) const
             {
 
                 if (i.position_in_run > 0 && old_c == new_c)
@@ -845,7 +878,8 @@ namespace stool
              * @param u_value_phi The phi value at position u
              * @return The computed SA value
              */
-            SAValue LF_phi_for_deletion_sub(RunPosition u, const DynamicRLBWT &dbwt, uint64_t u_value_phi) const
+            template <typename RLBWT>
+            SAValue LF_phi_for_deletion_sub(RunPosition u, const RLBWT &dbwt, uint64_t u_value_phi) const
             {
                 if (u.position_in_run > 0)
                 {
@@ -872,7 +906,8 @@ namespace stool
              * @param u_value_phi The phi value at position u
              * @return The computed SA value
              */
-            SAValue LF_phi_for_deletion(RunPosition i, SAValue prev_sa_value, const DynamicRLBWT &dbwt, uint64_t i_pos, uint64_t next_i_pos, uint64_t u_value, uint64_t u_value_phi) const
+            template <typename RLBWT>
+            SAValue LF_phi_for_deletion(RunPosition i, SAValue prev_sa_value, const RLBWT &dbwt, uint64_t i_pos, uint64_t next_i_pos, uint64_t u_value, uint64_t u_value_phi) const
             {
                 if (i_pos == next_i_pos)
                 {
@@ -919,7 +954,8 @@ namespace stool
             }
 
             /*
-            SAValue LF_phi_for_deletion(RunPosition i, SAValue prev_sa_value, const DynamicRLBWT &dbwt, uint64_t i_pos, uint64_t next_i_pos, uint64_t u_value, uint64_t u_value_phi) const
+            template <typename RLBWT>
+            SAValue LF_phi_for_deletion(RunPosition i, SAValue prev_sa_value, const RLBWT &dbwt, uint64_t i_pos, uint64_t next_i_pos, uint64_t u_value, uint64_t u_value_phi) const
             {
                 if (i_pos == next_i_pos)
                 {
@@ -969,7 +1005,8 @@ namespace stool
              * @param dbwt The DynamicRLBWT instance
              * @return The computed SA value
              */
-            SAValue LF_phi(RunPosition i, SAValue prev_sa_value, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_phi(RunPosition i, SAValue prev_sa_value, const RLBWT &dbwt) const
             {
                 uint8_t old_c = dbwt.get_char(i.run_index);
                 return this->LF_phi(i, old_c, old_c, prev_sa_value, dbwt);
@@ -983,14 +1020,16 @@ namespace stool
              * @param dbwt The DynamicRLBWT instance
              * @return The computed SA value
              */
-            SAValue LF_phi(RunPosition i, uint8_t c, SAValue prev_sa_value, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            SAValue LF_phi(RunPosition i, uint8_t c, SAValue prev_sa_value, const RLBWT &dbwt) const
             {
 
                 uint8_t old_c = dbwt.get_char(i.run_index);
                 return this->LF_phi(i, old_c, c, prev_sa_value, dbwt);
             }
 
-            std::pair<uint64_t, uint64_t> nearest_search_by_text_position(uint64_t text_position, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            std::pair<uint64_t, uint64_t> nearest_search_by_text_position(uint64_t text_position, const RLBWT &dbwt) const
             {
                 auto pair1 = this->sampled_first_sa.nearest_search_by_text_position(text_position);
                 auto pair2 = this->sampled_first_sa.nearest_search_by_text_position(text_position);
@@ -1016,7 +1055,8 @@ namespace stool
                 }
             }
 
-            uint64_t isa(uint64_t i, const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            uint64_t isa(uint64_t i, const RLBWT &dbwt) const
             {
                 std::pair<uint64_t, uint64_t> sa_pair = this->nearest_search_by_text_position(i, dbwt);
                 uint64_t sa_value = sa_pair.second;
@@ -1110,7 +1150,8 @@ namespace stool
                 return sa;
             }
 
-            std::vector<uint64_t> get_sampling_sa(const DynamicRLBWT &dbwt) const
+            template <typename RLBWT>
+            std::vector<uint64_t> get_sampling_sa(const RLBWT &dbwt) const
             {
                 std::vector<uint64_t> sa;
                 int64_t sa_size = this->text_size();
@@ -1191,12 +1232,24 @@ namespace stool
                 this->sampled_last_sa.extend_text(new_position);
                 // assert(this->verify());
             }
+            void extend_text(int64_t new_position, uint64_t len)
+            {
+                this->sampled_first_sa.extend_text(new_position, len);
+                this->sampled_last_sa.extend_text(new_position, len);
+                // assert(this->verify());
+            }
             void shrink_text(int64_t remove_position)
             {
                 this->sampled_first_sa.shrink_text(remove_position);
                 this->sampled_last_sa.shrink_text(remove_position);
                 // assert(this->verify());
             }
+            void shrink_text(int64_t remove_position, uint64_t len)
+            {
+                this->sampled_first_sa.shrink_text(remove_position, len);
+                this->sampled_last_sa.shrink_text(remove_position, len);
+                // assert(this->verify());
+            }
 
             void replace_element_for_insertion(int64_t replaced_sa_index, int64_t upper_sa_value, int64_t new_sa_value, int64_t lower_sa_value, const DetailedReplacement type)
             {
@@ -1353,6 +1406,39 @@ namespace stool
                 }
             }
 
+            /**
+             * @brief Update the sampled SA values of a run when a row is moved inside the run
+             * @details Since the BWT does not change, only the first and last sampled SA values of the run can change.
+             * @param run_index The index of the run
+             * @param run_length The length of the run
+             * @param from_position_in_run The position of the moved row in the run before the move
+             * @param to_position_in_run The position of the moved row in the run after the move
+             * @param moved_sa_value The SA value of the moved row
+             * @param upper_sa_value The SA value of the row above the moved row before the move
+             * @param lower_sa_value The SA value of the row below the moved row before the move
+             */
+            void move_element_in_run(SampledSAIndex run_index, uint64_t run_length, uint64_t from_position_in_run, uint64_t to_position_in_run, int64_t moved_sa_value, int64_t upper_sa_value, int64_t lower_sa_value)
+            {
+                assert(from_position_in_run != to_position_in_run);
+                if (to_position_in_run == 0)
+                {
+                    this->sampled_first_sa.replace(run_index, moved_sa_value);
+                }
+                else if (from_position_in_run == 0)
+                {
+                    this->sampled_first_sa.replace(run_index, lower_sa_value);
+                }
+
+                if (to_position_in_run + 1 == run_length)
+                {
+                    this->sampled_last_sa.replace(run_index, moved_sa_value);
+                }
+                else if (from_position_in_run + 1 == run_length)
+                {
+                    this->sampled_last_sa.replace(run_index, upper_sa_value);
+                }
+            }
+
             void merge_runs(SampledSAIndex replaced_sa_index)
             {
                 this->sampled_last_sa.remove(replaced_sa_index);
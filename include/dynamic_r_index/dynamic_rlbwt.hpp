@@ -3,6 +3,8 @@
 #include "../dynamic_fm_index/time_debug.hpp"
 #include "../dynamic_fm_index/tools.hpp"
 #include "../dynamic_fm_index/c_array.hpp"
+#include "../dynamic_fm_index/blocked_c_array.hpp"
+#include "./run_hash_sequence.hpp"
 #include <functional>
 namespace stool
 {
@@ -11,19 +13,29 @@ namespace stool
 
         /**
          * @brief A dynamic data structure storing the RLBWT R[0..r-1] of a string T[0..n-1]. [in progress].
+         * @tparam C_ARRAY The data structure for the C array (CArray or BlockedCArray)
          * \ingroup DynamicRIndexes
          * \ingroup MainDataStructures
          */
-        class DynamicRLBWT
+        template <typename C_ARRAY = CArray>
+        class BasicDynamicRLBWT
         {
         private:
             stool::bptree::SimpleDynamicPrefixSum run_length_vector;
             stool::bptree::SimpleDynamicPrefixSum c_run_counters;
             stool::bptree::SimpleDynamicPrefixSum run_length_vector_sorted_by_F;
             stool::bptree::DynamicWaveletTree head_chars_of_RLBWT;
-            stool::dynamic_r_index::CArray cArray;
+            C_ARRAY cArray;
             int64_t _text_size = 0;
 
+            // The i-th value is the F-index of the i-th run (used only if use_run_permutation is true)
+            stool::bptree::DynamicPermutation run_permutation;
+            bool use_run_permutation = false;
+
+            // The keys of the runs maintained by insert_new_run(), remove_BWT_run(), increment_run(), and decrement_run() for the hash of the RLBWT (used only if use_run_hash is true)
+            RunHashSequence run_hash_sequence;
+            bool use_run_hash = false;
+
             // std::vector<uint8_t> effective_alphabet;
 
         public:
@@ -37,14 +49,14 @@ namespace stool
             /**
              * @brief Default constructor.
              */
-            DynamicRLBWT()
+            BasicDynamicRLBWT()
             {
             }
 
             /**
              * @brief Default move constructor.
              */
-            DynamicRLBWT(DynamicRLBWT &&) noexcept = default;
+            BasicDynamicRLBWT(BasicDynamicRLBWT &&) noexcept = default;
             //@}
 
             ////////////////////////////////////////////////////////////////////////////////
@@ -54,11 +66,11 @@ namespace stool
             /**
              * @brief Deleted copy assignment operator.
              */
-            DynamicRLBWT &operator=(const DynamicRLBWT &) = delete;
+            BasicDynamicRLBWT &operator=(const BasicDynamicRLBWT &) = delete;
             /**
              * @brief Default move assignment operator.
              */
-            DynamicRLBWT &operator=(DynamicRLBWT &&) noexcept = default;
+            BasicDynamicRLBWT &operator=(BasicDynamicRLBWT &&) noexcept = default;
             //@}
 
             ////////////////////////////////////////////////////////////////////////////////
@@ -69,7 +81,7 @@ namespace stool
             /**
              * @brief Return the reference to the C array in this instance
              */
-            const stool::dynamic_r_index::CArray &get_c_array() const
+            const C_ARRAY &get_c_array() const
             {
                 return this->cArray;
             }
@@ -115,7 +127,23 @@ namespace stool
              */
             uint64_t size_in_bytes() const
             {
-                return this->run_length_vector.size_in_bytes() + this->c_run_counters.size_in_bytes() + this->run_length_vector_sorted_by_F.size_in_bytes() + this->head_chars_of_RLBWT.size_in_bytes() + this->cArray.size_in_bytes() + sizeof(this->_text_size);
+                return this->run_length_vector.size_in_bytes() + this->c_run_counters.size_in_bytes() + this->run_length_vector_sorted_by_F.size_in_bytes() + this->head_chars_of_RLBWT.size_in_bytes() + this->cArray.size_in_bytes() + sizeof(this->_text_size) + this->run_permutation.size_in_bytes() + sizeof(this->use_run_permutation) + this->run_hash_sequence.size_in_bytes() + sizeof(this->use_run_hash);
+            }
+
+            /**
+             * @brief Return true if the F-index of each run is stored in the explicit run permutation (see set_run_permutation_enabled())
+             */
+            bool is_run_permutation_enabled() const
+            {
+                return this->use_run_permutation;
+            }
+
+            /**
+             * @brief Return true if the hash of the RLBWT is maintained by the updates (see set_run_hash_enabled())
+             */
+            bool is_run_hash_enabled() const
+            {
+                return this->use_run_hash;
             }
 
 
@@ -325,6 +353,22 @@ namespace stool
              * @return The F-index corresponding to the run
              */
             int64_t get_f_index(RunIndex i) const
+            {
+                if (this->use_run_permutation)
+                {
+                    return this->run_permutation.access(i);
+                }
+                else
+                {
+                    return this->compute_f_index_by_rank(i);
+                }
+            }
+
+            /**
+             * @brief Compute the F-index of the i-th run by a rank query on the run heads and a prefix-sum query on the run counters
+             * @param i The run index
+             */
+            int64_t compute_f_index_by_rank(RunIndex i) const
             {
                 uint8_t c = this->head_chars_of_RLBWT.at(i);
                 int64_t rank = this->head_chars_of_RLBWT.one_based_rank(i + 1, c);
@@ -792,7 +836,7 @@ namespace stool
              * @brief Swap the contents with another DynamicRLBWT instance
              * @param item The DynamicRLBWT instance to swap with
              */
-            void swap(DynamicRLBWT &item)
+            void swap(BasicDynamicRLBWT &item)
             {
                 this->run_length_vector.swap(item.run_length_vector);
                 this->c_run_counters.swap(item.c_run_counters);
@@ -800,6 +844,52 @@ namespace stool
                 this->head_chars_of_RLBWT.swap(item.head_chars_of_RLBWT);
                 this->cArray.swap(item.cArray);
                 std::swap(_text_size, item._text_size);
+                this->run_permutation.swap(item.run_permutation);
+                std::swap(this->use_run_permutation, item.use_run_permutation);
+                this->run_hash_sequence.swap(item.run_hash_sequence);
+                std::swap(this->use_run_hash, item.use_run_hash);
+            }
+
+            /**
+             * @brief Enable or disable the explicit permutation between the runs in L and the runs in F
+             * @details If it is enabled, the F-index of each run is stored in a dynamic permutation, and get_f_index() (and hence LF) needs one permutation access
+             * instead of a rank query on the wavelet tree of the run heads and a prefix-sum query on the run counters. The permutation is maintained by insert_new_run() and remove_BWT_run().
+             * @note Enabling takes O(r log σ log r) time and O(r log r) bits of extra space. The setting is not saved by store_to_file().
+             */
+            void set_run_permutation_enabled(bool enabled)
+            {
+                this->run_permutation.clear();
+                this->use_run_permutation = false;
+                if (enabled)
+                {
+                    std::vector<uint64_t> f_indexes;
+                    uint64_t _run_count = this->run_count();
+                    f_indexes.resize(_run_count);
+                    for (uint64_t i = 0; i < _run_count; i++)
+                    {
+                        f_indexes[i] = this->compute_f_index_by_rank(i);
+                    }
+                    this->run_permutation.build(f_indexes.begin(), f_indexes.end(), f_indexes.size(), stool::Message::NO_MESSAGE);
+                    this->use_run_permutation = true;
+                }
+            }
+
+            /**
+             * @brief Enable or disable the maintenance of the hash of the RLBWT (see compute_RLBWT_hash())
+             * @details If it is enabled, the key of each run is stored in a RunHashSequence, which is updated by insert_new_run(), remove_BWT_run(), increment_run(), and decrement_run(),
+             * and hence compute_RLBWT_hash() takes O(1) time. Otherwise, the updates pay nothing for the hash, and compute_RLBWT_hash() computes it from scratch.
+             * @note Enabling takes O(r log r) time and O(r) words of extra space (about 40 bytes per run). The setting is not saved by store_to_file().
+             */
+            void set_run_hash_enabled(bool enabled)
+            {
+                this->run_hash_sequence.clear();
+                this->use_run_hash = false;
+                if (enabled)
+                {
+                    RunHashSequence tmp_run_hash_sequence = RunHashSequence::build(this->get_run_keys());
+                    this->run_hash_sequence.swap(tmp_run_hash_sequence);
+                    this->use_run_hash = true;
+                }
             }
             
             /**
@@ -815,6 +905,54 @@ namespace stool
                 this->clear();
             }
 
+            /**
+             * @brief Add the characters of a given string that are not contained in the alphabet Σ of this RLBWT to Σ
+             * @param inserted_string The string whose characters must be contained in Σ
+             * @return true if Σ has been extended, otherwise false
+             * @throws std::runtime_error if a new character is smaller than the end marker
+             * @note The C array and the run counters already support every byte value, so only the wavelet tree of the run heads is rebuilt.
+             * @note O(σ) time if Σ is not extended, and O(r log σ log r) time otherwise
+             */
+            bool extend_alphabet(const std::vector<uint8_t> &inserted_string)
+            {
+                std::vector<uint8_t> new_chars;
+                for (uint8_t c : inserted_string)
+                {
+                    if (this->get_lexicographic_order(c) == -1 && std::find(new_chars.begin(), new_chars.end(), c) == new_chars.end())
+                    {
+                        new_chars.push_back(c);
+                    }
+                }
+                if (new_chars.size() == 0)
+                {
+                    return false;
+                }
+
+                uint8_t end_marker = this->get_end_marker();
+                for (uint8_t c : new_chars)
+                {
+                    if (c < end_marker)
+                    {
+                        throw std::runtime_error("The character " + std::to_string(c) + " cannot be added to the alphabet of the RLBWT because it is smaller than the end marker.");
+                    }
+                }
+
+                std::vector<uint8_t> new_alphabet = this->to_alphabet_vector();
+                new_alphabet.insert(new_alphabet.end(), new_chars.begin(), new_chars.end());
+                std::sort(new_alphabet.begin(), new_alphabet.end());
+
+                std::vector<uint8_t> head_chars;
+                uint64_t _run_count = this->head_chars_of_RLBWT.size();
+                head_chars.resize(_run_count);
+                for (uint64_t i = 0; i < _run_count; i++)
+                {
+                    head_chars[i] = this->head_chars_of_RLBWT.at(i);
+                }
+                stool::bptree::DynamicWaveletTree tmp_head_chars_of_RLBWT = stool::bptree::DynamicWaveletTree::build(head_chars, new_alphabet);
+                this->head_chars_of_RLBWT.swap(tmp_head_chars_of_RLBWT);
+                return true;
+            }
+
             /**
              * @brief Clear all data and initialize with a single end marker run
              */
@@ -825,7 +963,9 @@ namespace stool
                 this->run_length_vector_sorted_by_F.clear();
                 this->c_run_counters.clear();
                 this->cArray.clear();
+                this->run_permutation.clear();
                 this->_text_size = 0;
+                this->run_hash_sequence.clear();
                 this->insert_new_run(0, this->get_end_marker(), 1);
             }
 
@@ -845,6 +985,10 @@ namespace stool
 
                 uint64_t f_index = this->get_f_index(run_index);
                 this->run_length_vector.increment(run_index, delta);
+                if (this->use_run_hash)
+                {
+                    this->run_hash_sequence.set(run_index, this->get_run_key(run_index));
+                }
                 this->run_length_vector_sorted_by_F.increment(f_index, delta);
                 uint8_t c = this->get_char(run_index);
                 this->cArray.increase(c, delta);
@@ -961,7 +1105,15 @@ namespace stool
                 }
 
                 this->run_length_vector.insert(run_index, run_length);
+                if (this->use_run_hash)
+                {
+                    this->run_hash_sequence.insert(run_index, BasicDynamicRLBWT::to_run_key(c, run_length));
+                }
                 this->run_length_vector_sorted_by_F.insert(new_f_index, run_length);
+                if (this->use_run_permutation)
+                {
+                    this->run_permutation.insert(run_index, new_f_index);
+                }
                 this->_text_size += run_length;
 
 #ifdef TIME_DEBUG
@@ -988,7 +1140,15 @@ namespace stool
                 this->head_chars_of_RLBWT.remove(run_index);
 
                 this->run_length_vector.remove(run_index);
+                if (this->use_run_hash)
+                {
+                    this->run_hash_sequence.erase(run_index);
+                }
                 this->run_length_vector_sorted_by_F.remove(f_index);
+                if (this->use_run_permutation)
+                {
+                    this->run_permutation.erase(run_index);
+                }
                 // this->update_C_info_for_deletion(c);
                 this->_text_size -= run_length;
 
@@ -1023,6 +1183,10 @@ namespace stool
                 {
                     uint64_t f_index = this->get_f_index(run_index);
                     this->run_length_vector.decrement(run_index, delta);
+                    if (this->use_run_hash)
+                    {
+                        this->run_hash_sequence.set(run_index, this->get_run_key(run_index));
+                    }
                     this->run_length_vector_sorted_by_F.decrement(f_index, delta);
                     uint8_t c = this->get_char(run_index);
                     this->cArray.decrease(c, delta);
@@ -1116,10 +1280,82 @@ namespace stool
             void verify(int mode = 0) const
             {
                 this->verify1();
+                if (this->use_run_hash && this->run_hash_sequence.hash() != this->compute_RLBWT_hash_naively())
+                {
+                    throw std::logic_error("Error: DynamicRLBWT::verify(), the hash of the RLBWT");
+                }
+                if (this->use_run_permutation)
+                {
+                    if ((uint64_t)this->run_permutation.size() != this->run_count())
+                    {
+                        throw std::logic_error("Error: DynamicRLBWT::verify(), the size of the run permutation");
+                    }
+                    for (uint64_t i = 0; i < this->run_count(); i++)
+                    {
+                        if ((int64_t)this->run_permutation.access(i) != this->compute_f_index_by_rank(i))
+                        {
+                            throw std::logic_error("Error: DynamicRLBWT::verify(), the run permutation");
+                        }
+                    }
+                }
                 if (mode == 0)
                 {
                     std::vector<uint64_t> LF_array = this->construct_LF_array();
-                    DynamicRLBWT::verify_permutation(LF_array, "LF");
+                    BasicDynamicRLBWT::verify_permutation(LF_array, "LF");
+                }
+            }
+
+            /**
+             * @brief Verify the invariants of the RLBWT that can be checked without computing the LF array
+             * @details The following are checked: the sizes and the sums of the run length vectors, the run counters, and the C array,
+             * the positivity of run lengths, the size of the run permutation, and the maintained hash value (if it is enabled).
+             * Adjacent runs with the same character are a legitimate state until compact_runs() is called (see DynamicRIndex::compact_runs()),
+             * so the maximality of runs is checked only if \p check_maximality is true.
+             * @param check_maximality Whether to check that no two adjacent runs have the same character (see verify1())
+             * @note O(r log n) time. Throws std::logic_error if verification fails
+             */
+            void verify_structure(bool check_maximality = false) const
+            {
+                uint64_t _run_count = this->run_count();
+                if (this->run_length_vector.size() != _run_count || this->run_length_vector_sorted_by_F.size() != _run_count)
+                {
+                    throw std::logic_error("Error: DynamicRLBWT::verify_structure(), the number of runs");
+                }
+                if ((int64_t)this->run_length_vector.psum() != this->_text_size || (int64_t)this->run_length_vector_sorted_by_F.psum() != this->_text_size)
+                {
+                    throw std::logic_error("Error: DynamicRLBWT::verify_structure(), the sum of run lengths");
+                }
+                for (uint64_t len : this->run_length_vector)
+                {
+                    if (len == 0)
+                    {
+                        throw std::logic_error("Error: DynamicRLBWT::verify_structure(), an empty run");
+                    }
+                }
+                if (this->c_run_counters.psum() != _run_count || this->c_run_counters.size() != this->cArray.effective_alphabet_size())
+                {
+                    throw std::logic_error("Error: DynamicRLBWT::verify_structure(), the run counters");
+                }
+                uint64_t c_sum = 0;
+                for (uint64_t c = 0; c <= UINT8_MAX; c++)
+                {
+                    c_sum += this->cArray.get_c_count(c);
+                }
+                if ((int64_t)c_sum != this->_text_size || (_run_count > 0 && this->cArray.get_c_count(this->get_end_marker()) != 1))
+                {
+                    throw std::logic_error("Error: DynamicRLBWT::verify_structure(), the C array");
+                }
+                if (this->use_run_permutation && (uint64_t)this->run_permutation.size() != _run_count)
+                {
+                    throw std::logic_error("Error: DynamicRLBWT::verify_structure(), the size of the run permutation");
+                }
+                if (check_maximality)
+                {
+                    this->verify1();
+                }
+                if (this->use_run_hash && this->run_hash_sequence.hash() != this->compute_RLBWT_hash_naively())
+                {
+                    throw std::logic_error("Error: DynamicRLBWT::verify_structure(), the hash of the RLBWT");
                 }
             }
 
@@ -1249,38 +1485,31 @@ namespace stool
             }
 
             /**
-             * @brief Compute a hash value for the RLBWT structure
+             * @brief Return the hash value of the RLBWT
+             * @details The hash value is the polynomial hash sum_{i} h(x_{i}) B^{i} mod (2^61 - 1) (see RunHashSequence), where x_{i} is the pair of the character and the length of the i-th run.
+             * Since the weight of each run depends on its index, RLBWTs whose runs are permutations of each other, or have the same pairs of adjacent runs, have different hash values with high probability.
+             * If set_run_hash_enabled() is enabled, it is maintained by insert_new_run(), remove_BWT_run(), increment_run(), and decrement_run() in O(log r) expected time per call;
+             * otherwise, it is computed from scratch by compute_RLBWT_hash_naively().
              * @param message_paragraph Message indentation level
-             * @return Hash value computed from run characters and lengths
-             * @note Used for verification and debugging
+             * @note O(1) time if the hash is maintained, and O(r log r) time otherwise. Two RLBWTs with the same runs in the same order have the same hash value, and two different RLBWTs of r runs have the same hash value with probability at most about r / 2^61.
              */
             uint64_t compute_RLBWT_hash(int message_paragraph = stool::Message::SHOW_MESSAGE) const
             {
+                uint64_t hash = this->use_run_hash ? this->run_hash_sequence.hash() : this->compute_RLBWT_hash_naively();
                 if (message_paragraph >= 0)
                 {
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Computing the hash of the RLBWT..." << std::endl;
-                }
-
-                std::string str = this->head_chars_of_RLBWT.to_string();
-                std::hash<std::string> hasher;
-                uint64_t hash1 = hasher(str);
-
-                uint64_t i = 0;
-                uint64_t hash2 = 0;
-
-                for (uint64_t s : this->run_length_vector)
-                {
-                    hash2 ^= (i ^ s);
-                    i++;
-                }
-                uint64_t r = hash1 ^ hash2;
-
-                if (message_paragraph >= 0)
-                {
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[DONE]" << std::endl;
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "The hash of the RLBWT: " << hash << std::endl;
                 }
+                return hash;
+            }
 
-                return r;
+            /**
+             * @brief Compute the hash value of the RLBWT (see compute_RLBWT_hash()) from scratch
+             * @note O(r log r) time
+             */
+            uint64_t compute_RLBWT_hash_naively() const
+            {
+                return RunHashSequence::compute_hash(this->get_run_keys());
             }
 
             bool verify_inserted_string(const std::vector<uint8_t> &inserted_string) const {
@@ -1352,9 +1581,9 @@ namespace stool
              * @param alphabet The alphabet to use
              * @return A DynamicRLBWT instance initialized with the end marker
              */
-            static DynamicRLBWT build_RLBWT_of_end_marker(const std::vector<uint8_t> &alphabet)
+            static BasicDynamicRLBWT build_RLBWT_of_end_marker(const std::vector<uint8_t> &alphabet)
             {
-                DynamicRLBWT r;
+                BasicDynamicRLBWT r;
                 r.set_alphabet(alphabet);
                 // r.insert_new_run(0, r.get_end_marker(), 1);
                 return r;
@@ -1367,8 +1596,9 @@ namespace stool
              * @param alphabet The alphabet to use
              * @param message_paragraph Message indentation level for progress output
              * @return A new DynamicRLBWT instance built from the RLBWT data
+             * @note The runs are sorted by their characters with a counting sort in O(r) time, and every B-tree is built from its whole input at once.
              */
-            static DynamicRLBWT build_from_RLBWT(const std::vector<uint8_t> &_rlbwt_chars, const std::vector<uint64_t> &_rlbwt_runs, const std::vector<uint8_t> &alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicRLBWT build_from_RLBWT(const std::vector<uint8_t> &_rlbwt_chars, const std::vector<uint64_t> &_rlbwt_runs, const std::vector<uint8_t> &alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
 
                 if (message_paragraph >= 0 && _rlbwt_chars.size() > 0)
@@ -1403,28 +1633,27 @@ namespace stool
                     }
                 }
 
-                stool::dynamic_r_index::CArray tmp_cArray = stool::dynamic_r_index::CArray::build(c_counters);
+                C_ARRAY tmp_cArray = C_ARRAY::build(c_counters);
                 stool::bptree::SimpleDynamicPrefixSum tmp_c_run_counters = stool::bptree::SimpleDynamicPrefixSum::build(c_run_counters2);
 
-                std::vector<uint64_t> indexes;
-                indexes.resize(_rlbwt_chars.size(), UINT64_MAX);
-                for (uint64_t i = 0; i < _rlbwt_chars.size(); i++)
+                // Sort the run lengths by the characters of their runs (stably) by a counting sort,
+                // and build the B-tree from the sorted values at once instead of inserting them one by one.
+                std::vector<uint64_t> run_starting_positions_on_F;
+                run_starting_positions_on_F.resize(256, 0);
+                for (uint64_t c = 1; c < 256; c++)
                 {
-                    indexes[i] = i;
+                    run_starting_positions_on_F[c] = run_starting_positions_on_F[c - 1] + c_run_counters[c - 1];
                 }
-                std::sort(indexes.begin(), indexes.end(), [&](const int64_t &lhs, const int64_t &rhs)
-                          {
-                        if(_rlbwt_chars[lhs] != _rlbwt_chars[rhs]){
-                            return _rlbwt_chars[lhs] < _rlbwt_chars[rhs];
-                        }else{
-                            return lhs < rhs;
-                        } });
-                stool::bptree::SimpleDynamicPrefixSum tmp_run_length_vector_sorted_by_F;
-                for (auto i : indexes)
+                std::vector<uint64_t> run_lengths_sorted_by_F;
+                run_lengths_sorted_by_F.resize(_rlbwt_chars.size(), 0);
+                for (uint64_t i = 0; i < _rlbwt_chars.size(); i++)
                 {
-                    tmp_run_length_vector_sorted_by_F.push_back(_rlbwt_runs[i]);
+                    run_lengths_sorted_by_F[run_starting_positions_on_F[_rlbwt_chars[i]]++] = _rlbwt_runs[i];
                 }
-                DynamicRLBWT r;
+                stool::bptree::SimpleDynamicPrefixSum tmp_run_length_vector_sorted_by_F = stool::bptree::SimpleDynamicPrefixSum::build(run_lengths_sorted_by_F);
+                std::vector<uint64_t>().swap(run_lengths_sorted_by_F);
+
+                BasicDynamicRLBWT r;
                 r.head_chars_of_RLBWT.swap(tmp_head_chars_of_RLBWT);
                 r.run_length_vector.swap(tmp_run_length_vector);
                 r.run_length_vector_sorted_by_F.swap(tmp_run_length_vector_sorted_by_F);
@@ -1453,13 +1682,13 @@ namespace stool
              * @return A new DynamicRLBWT instance built from the BWT
              * @note First converts BWT to RLBWT format, then builds the dynamic structure
              */
-            static DynamicRLBWT build_from_BWT(const std::vector<uint8_t> &_bwt, const std::vector<uint8_t> &alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static BasicDynamicRLBWT build_from_BWT(const std::vector<uint8_t> &_bwt, const std::vector<uint8_t> &alphabet, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
                 std::vector<uint8_t> rlbwt_chars;
                 std::vector<uint64_t> rlbwt_runs;
                 stool::RLEIO::build_RLBWT_from_BWT(_bwt, rlbwt_chars, rlbwt_runs, message_paragraph);
 
-                return DynamicRLBWT::build_from_RLBWT(rlbwt_chars, rlbwt_runs, alphabet, message_paragraph);
+                return BasicDynamicRLBWT::build_from_RLBWT(rlbwt_chars, rlbwt_runs, alphabet, message_paragraph);
 
                 // this->build(rlbwt_chars, rlbwt_runs, alphabet, message_paragraph);
             }
@@ -1469,13 +1698,13 @@ namespace stool
              * @param item The DynamicRLBWT instance to save
              * @param os Output file stream (must be opened in binary mode)
              */
-            static void store_to_file(DynamicRLBWT &item, std::ofstream &os)
+            static void store_to_file(BasicDynamicRLBWT &item, std::ofstream &os)
             {
                 stool::bptree::SimpleDynamicPrefixSum::store_to_file(item.run_length_vector, os);
                 stool::bptree::SimpleDynamicPrefixSum::store_to_file(item.c_run_counters, os);
                 stool::bptree::SimpleDynamicPrefixSum::store_to_file(item.run_length_vector_sorted_by_F, os);
                 stool::bptree::DynamicWaveletTree::store_to_file(item.head_chars_of_RLBWT, os);
-                stool::dynamic_r_index::CArray::store_to_file(item.cArray, os);
+                C_ARRAY::store_to_file(item.cArray, os);
             }
             
             /**
@@ -1483,15 +1712,15 @@ namespace stool
              * @param ifs Input file stream (must be opened in binary mode)
              * @return A new DynamicRLBWT instance loaded from the file
              */
-            static DynamicRLBWT load_from_file(std::ifstream &ifs)
+            static BasicDynamicRLBWT load_from_file(std::ifstream &ifs)
             {
                 stool::bptree::SimpleDynamicPrefixSum tmp_run_length_vector = stool::bptree::SimpleDynamicPrefixSum::load_from_file(ifs);
                 stool::bptree::SimpleDynamicPrefixSum tmp_c_run_counters = stool::bptree::SimpleDynamicPrefixSum::load_from_file(ifs);
                 stool::bptree::SimpleDynamicPrefixSum tmp_run_length_vector_sorted_by_F = stool::bptree::SimpleDynamicPrefixSum::load_from_file(ifs);
                 stool::bptree::DynamicWaveletTree tmp_head_chars_of_RLBWT = stool::bptree::DynamicWaveletTree::load_from_file(ifs);
-                stool::dynamic_r_index::CArray tmp_cArray = stool::dynamic_r_index::CArray::load_from_file(ifs);
+                C_ARRAY tmp_cArray = C_ARRAY::load_from_file(ifs);
 
-                DynamicRLBWT r;
+                BasicDynamicRLBWT r;
                 r.head_chars_of_RLBWT.swap(tmp_head_chars_of_RLBWT);
                 r.run_length_vector.swap(tmp_run_length_vector);
                 r.run_length_vector_sorted_by_F.swap(tmp_run_length_vector_sorted_by_F);
@@ -1535,7 +1764,53 @@ namespace stool
                 }
                 return true;
             }
+
             //@}
+
+        private:
+            /**
+             * @brief Return the key of a run of the character \p c and the length \p run_length used in the hash of the RLBWT
+             */
+            static uint64_t to_run_key(uint8_t c, uint64_t run_length)
+            {
+                return (run_length << 8) | c;
+            }
+
+            /**
+             * @brief Return the key of the run with the index \p run_index used in the hash of the RLBWT
+             */
+            uint64_t get_run_key(uint64_t run_index) const
+            {
+                return BasicDynamicRLBWT::to_run_key(this->head_chars_of_RLBWT.at(run_index), this->run_length_vector.at(run_index));
+            }
+
+            /**
+             * @brief Return the keys of all the runs (see get_run_key())
+             */
+            std::vector<uint64_t> get_run_keys() const
+            {
+                std::vector<uint64_t> r;
+                r.reserve(this->run_count());
+                uint64_t i = 0;
+                for (uint64_t len : this->run_length_vector)
+                {
+                    r.push_back(BasicDynamicRLBWT::to_run_key(this->head_chars_of_RLBWT.at(i), len));
+                    i++;
+                }
+                return r;
+            }
         };
+
+        /**
+         * @brief The dynamic RLBWT with the default C array (CArray)
+         * \ingroup DynamicRIndexes
+         */
+        using DynamicRLBWT = BasicDynamicRLBWT<CArray>;
+
+        /**
+         * @brief The dynamic RLBWT with the C array supporting O(√σ)-time updates (BlockedCArray)
+         * \ingroup DynamicRIndexes
+         */
+        using BlockedDynamicRLBWT = BasicDynamicRLBWT<BlockedCArray>;
     }
 }
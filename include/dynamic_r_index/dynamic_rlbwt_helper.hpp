@@ -24,7 +24,8 @@ namespace stool
              * @param c The character at the current position
              * @return The upper character, or UINT64_MAX if at the beginning
              */
-            static uint64_t get_upper_character(const DynamicRLBWT &dbwt, uint64_t run_index, uint64_t pos_in_run, uint8_t c)
+            template <typename RLBWT>
+            static uint64_t get_upper_character(const RLBWT &dbwt, uint64_t run_index, uint64_t pos_in_run, uint8_t c)
             {
                 if (pos_in_run > 0)
                 {
@@ -48,7 +49,8 @@ namespace stool
              * @param c The character at the current position
              * @return The lower character, or UINT64_MAX if at the end
              */
-            static uint64_t get_lower_character(const DynamicRLBWT &dbwt, uint64_t run_index, uint64_t pos_in_run, uint8_t c)
+            template <typename RLBWT>
+            static uint64_t get_lower_character(const RLBWT &dbwt, uint64_t run_index, uint64_t pos_in_run, uint8_t c)
             {
                 uint64_t run_count = dbwt.run_count();
                 uint64_t len = run_index < run_count ? dbwt.get_run_length(run_index) : UINT64_MAX;
@@ -81,7 +83,8 @@ namespace stool
              * @param new_char The new character to replace with
              * @return DetailedReplacement structure describing the replacement type
              */
-            static DetailedReplacement get_replacement_type2(const DynamicRLBWT &dbwt, uint64_t run_index, uint64_t pos_in_run, uint8_t new_char)
+            template <typename RLBWT>
+            static DetailedReplacement get_replacement_type2(const RLBWT &dbwt, uint64_t run_index, uint64_t pos_in_run, uint8_t new_char)
             {
                 uint64_t len = dbwt.get_run_length(run_index);
                 uint8_t old_c = dbwt.get_char(run_index);
@@ -104,7 +107,8 @@ namespace stool
              * @param new_char The new character to replace with
              * @return RunReplacementType indicating the type of replacement
              */
-            static RunReplacementType get_replacement_type(const DynamicRLBWT &dbwt, uint64_t run_index, uint64_t pos_in_run, uint8_t new_char)
+            template <typename RLBWT>
+            static RunReplacementType get_replacement_type(const RLBWT &dbwt, uint64_t run_index, uint64_t pos_in_run, uint8_t new_char)
             {
                 uint64_t len = dbwt.get_run_length(run_index);
                 uint8_t c = dbwt.get_char(run_index);
@@ -137,7 +141,8 @@ namespace stool
              * @param c The character to search for
              * @return The run position of the successor run starting with character c
              */
-            static RunPosition proper_successor_on_F(const DynamicRLBWT &dbwt, RunPosition x, uint8_t c)
+            template <typename RLBWT>
+            static RunPosition proper_successor_on_F(const RLBWT &dbwt, RunPosition x, uint8_t c)
             {
                 uint8_t xc = dbwt.get_char(x.run_index);
                 uint64_t run_length = dbwt.get_run_length(x.run_index);
@@ -168,14 +173,16 @@ namespace stool
                 }
             }
 
-            static RunPosition proper_successor_on_F(const DynamicRLBWT &dbwt, RunPosition x)
+            template <typename RLBWT>
+            static RunPosition proper_successor_on_F(const RLBWT &dbwt, RunPosition x)
             {
                 uint8_t xc = dbwt.get_char(x.run_index);
                 return proper_successor_on_F(dbwt, x, xc);
             }
 
 
-            static RunPosition proper_predecessor_on_F(const DynamicRLBWT &dbwt, RunPosition x, uint8_t c)
+            template <typename RLBWT>
+            static RunPosition proper_predecessor_on_F(const RLBWT &dbwt, RunPosition x, uint8_t c)
             {
                 uint8_t xc = dbwt.get_char(x.run_index);
                 if (x.position_in_run > 0 && xc == c)
@@ -210,13 +217,15 @@ namespace stool
                     }
                 }
             }
-            static RunPosition proper_predecessor_on_F(const DynamicRLBWT &dbwt, RunPosition x)
+            template <typename RLBWT>
+            static RunPosition proper_predecessor_on_F(const RLBWT &dbwt, RunPosition x)
             {
                 uint8_t xc = dbwt.get_char(x.run_index);
                 return proper_predecessor_on_F(dbwt, x, xc);
             }
 
-            static RunRemovalType remove_char(DynamicRLBWT &dbwt, RunPosition i, [[maybe_unused]] uint8_t c)
+            template <typename RLBWT>
+            static RunRemovalType remove_char(RLBWT &dbwt, RunPosition i, [[maybe_unused]] uint8_t c)
             {
 
                 uint64_t run_length = dbwt.get_run_length(i.run_index);
@@ -258,7 +267,8 @@ namespace stool
                 }
             }
 
-            static bool try_to_merge_runs(DynamicRLBWT &dbwt, uint64_t run_index)
+            template <typename RLBWT>
+            static bool try_to_merge_runs(RLBWT &dbwt, uint64_t run_index)
             {
                 assert(run_index < (uint64_t)dbwt.run_count());
                 uint64_t size = dbwt.run_count();
@@ -289,7 +299,8 @@ namespace stool
             }
             
 
-            static RunPosition insert_char_for_insertion(DynamicRLBWT &dbwt, RunPosition i, uint8_t new_char, RunInsertionType type)
+            template <typename RLBWT>
+            static RunPosition insert_char_for_insertion(RLBWT &dbwt, RunPosition i, uint8_t new_char, RunInsertionType type)
             {
                 if (type == RunInsertionType::NewRunInsertionWithSplit)
                 {
@@ -314,7 +325,8 @@ namespace stool
                 }
             }
 
-            static std::pair<RunInsertionType, RunPosition> compute_insertion_type_and_position(const DynamicRLBWT &dbwt, RunPosition i, uint8_t c)
+            template <typename RLBWT>
+            static std::pair<RunInsertionType, RunPosition> compute_insertion_type_and_position(const RLBWT &dbwt, RunPosition i, uint8_t c)
             {
                 // RunPosition i = dbwt.to_run_position(insertion_position, true);
 
@@ -378,7 +390,8 @@ namespace stool
                 }
             }
 
-            static DetailedReplacement replace_char(DynamicRLBWT &dbwt, RunPosition i, uint8_t new_char)
+            template <typename RLBWT>
+            static DetailedReplacement replace_char(RLBWT &dbwt, RunPosition i, uint8_t new_char)
             {
                 DetailedReplacement r = get_replacement_type2(dbwt, i.run_index, i.position_in_run, new_char);
 
@@ -0,0 +1,166 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include "stool/include/lib.hpp"
+#include "./packed_dna_sequence.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief Streaming reader of FASTA and FASTQ files
+         * @details The sequences of the records are concatenated into a PackedDNASequence in the order of the records,
+         * and two consecutive sequences are separated by the record separator PackedDNASequence::SEPARATOR ('>'),
+         * which is smaller than every base and hence no pattern over the bases matches across a record boundary.
+         * The header lines (the lines starting with '>' or '@') and the quality lines of FASTQ records are skipped, whitespace is ignored,
+         * lowercase characters are converted to uppercase, and every character other than A, C, G, and T (e.g., IUPAC codes) is converted to N.
+         * The name of each record (the first word of its header line) and the starting position of its sequence in the concatenation are recorded.
+         * Sequence lines before the first header line are read as a record with the empty name.
+         * \ingroup DynamicRIndexes
+         */
+        class FASTAReader
+        {
+        public:
+            /**
+             * @brief Return the character of {A, C, G, T, N} representing \p c
+             */
+            static uint8_t normalize(uint8_t c)
+            {
+                switch (c)
+                {
+                case 'A':
+                case 'a':
+                    return 'A';
+                case 'C':
+                case 'c':
+                    return 'C';
+                case 'G':
+                case 'g':
+                    return 'G';
+                case 'T':
+                case 't':
+                    return 'T';
+                default:
+                    return 'N';
+                }
+            }
+
+            /**
+             * @brief Read the records of a FASTA or FASTQ stream
+             * @param is The input stream
+             * @param output_sequence The concatenation S_1 > S_2 > ... > S_d of the normalized sequences, where > is PackedDNASequence::SEPARATOR
+             * @param output_names The name of each record
+             * @param output_starting_positions The starting position of each record in \p output_sequence
+             * @throws std::runtime_error if the quality line of a FASTQ record is missing
+             */
+            static void load(std::istream &is, PackedDNASequence &output_sequence, std::vector<std::string> &output_names, std::vector<uint64_t> &output_starting_positions)
+            {
+                output_sequence.clear();
+                output_names.clear();
+                output_starting_positions.clear();
+
+                std::string line;
+                bool is_fastq_record = false;
+                bool in_quality = false;
+                uint64_t record_length = 0;
+                uint64_t quality_length = 0;
+                while (std::getline(is, line))
+                {
+                    if (line.size() > 0 && line[line.size() - 1] == '\r')
+                    {
+                        line.pop_back();
+                    }
+                    if (in_quality)
+                    {
+                        quality_length += line.size();
+                        in_quality = quality_length < record_length;
+                        continue;
+                    }
+                    if (line.size() == 0)
+                    {
+                        continue;
+                    }
+
+                    if (line[0] == '>' || line[0] == '@')
+                    {
+                        uint64_t name_end = line.find_first_of(" \t", 1);
+                        if (output_names.size() > 0)
+                        {
+                            output_sequence.push_back(PackedDNASequence::SEPARATOR);
+                        }
+                        output_names.push_back(line.substr(1, name_end == std::string::npos ? std::string::npos : name_end - 1));
+                        output_starting_positions.push_back(output_sequence.size());
+                        is_fastq_record = line[0] == '@';
+                        record_length = 0;
+                    }
+                    else if (is_fastq_record && line[0] == '+')
+                    {
+                        quality_length = 0;
+                        in_quality = record_length > 0;
+                        is_fastq_record = false;
+                    }
+                    else
+                    {
+                        if (output_names.size() == 0)
+                        {
+                            output_names.push_back("");
+                            output_starting_positions.push_back(0);
+                        }
+                        for (char c : line)
+                        {
+                            if (c != ' ' && c != '\t')
+                            {
+                                output_sequence.push_back(FASTAReader::normalize(c));
+                                record_length++;
+                            }
+                        }
+                    }
+                }
+                if (in_quality || is_fastq_record)
+                {
+                    throw std::runtime_error("FASTAReader: the quality line of the last FASTQ record is missing or too short");
+                }
+            }
+
+            /**
+             * @brief Read the records of a FASTA or FASTQ file
+             * @throws std::runtime_error if the file cannot be opened or the quality line of a FASTQ record is missing
+             */
+            static void load(const std::string &file_path, PackedDNASequence &output_sequence, std::vector<std::string> &output_names, std::vector<uint64_t> &output_starting_positions,
+                             int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                std::ifstream ifs(file_path, std::ios::binary);
+                if (!ifs)
+                {
+                    throw std::runtime_error("Cannot open the file: " + file_path);
+                }
+                if (message_paragraph >= 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Reading the FASTA/FASTQ file..." << std::flush;
+                }
+                FASTAReader::load(ifs, output_sequence, output_names, output_starting_positions);
+                if (message_paragraph >= 0)
+                {
+                    std::cout << "[END] (" << output_names.size() << " records, " << output_sequence.size() << " bases, " << output_sequence.size_in_bytes() << " bytes)" << std::endl;
+                }
+            }
+
+            /**
+             * @brief Write the name, the starting position, and the length of each record as a tab-separated line
+             * @details The length of a record does not include the separator following it.
+             */
+            static void store_records_to_file(const std::vector<std::string> &names, const std::vector<uint64_t> &starting_positions, uint64_t sequence_length, std::ofstream &os)
+            {
+                for (uint64_t i = 0; i < names.size(); i++)
+                {
+                    uint64_t end = i + 1 < starting_positions.size() ? starting_positions[i + 1] - 1 : sequence_length;
+                    os << names[i] << "\t" << starting_positions[i] << "\t" << (end - starting_positions[i]) << "\n";
+                }
+            }
+        };
+    }
+}
@@ -0,0 +1,232 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include "./random_access_stream.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief A DNA sequence over {A, C, G, T, N} and the record separator stored in 2 bits per character
+         * @details A, C, G, and T are stored as 2-bit codes in 64-bit words, and N is stored as the sorted list of the maximal runs of N,
+         * which is small for genomic sequences (N usually occurs as long runs of unknown bases).
+         * The record separator (SEPARATOR) is stored as the sorted list of its positions, which occurs once per record.
+         * open() returns a seekable stream of the sequence, and hence the sequence can be given to PrefixFreeParsing without unpacking it.
+         * \ingroup DynamicRIndexes
+         */
+        class PackedDNASequence
+        {
+            static inline constexpr uint64_t CHARS_PER_WORD = 32;
+
+            std::vector<uint64_t> words;
+            std::vector<uint64_t> n_run_starting_positions;
+            std::vector<uint64_t> n_run_ending_positions;
+            std::vector<uint64_t> separator_positions;
+            uint64_t _size = 0;
+
+            /**
+             * @brief The source of RandomAccessStream reading the sequence
+             */
+            class SequenceReader
+            {
+                const PackedDNASequence *sequence;
+
+            public:
+                SequenceReader(const PackedDNASequence &_sequence) : sequence(&_sequence)
+                {
+                }
+
+                uint64_t size() const
+                {
+                    return this->sequence->size();
+                }
+
+                uint64_t read(uint64_t pos, char *output, uint64_t max_len)
+                {
+                    return this->sequence->read(pos, output, max_len);
+                }
+            };
+
+            static uint64_t to_code(uint8_t c)
+            {
+                switch (c)
+                {
+                case 'A':
+                    return 0;
+                case 'C':
+                    return 1;
+                case 'G':
+                    return 2;
+                case 'T':
+                    return 3;
+                default:
+                    throw std::invalid_argument("PackedDNASequence: the character must be one of A, C, G, T, N, and the separator");
+                }
+            }
+
+        public:
+            static inline constexpr char CODE_TO_CHAR[4] = {'A', 'C', 'G', 'T'};
+
+            /**
+             * @brief The record separator, which is smaller than A, C, G, T, and N
+             */
+            static inline constexpr uint8_t SEPARATOR = '>';
+
+            /**
+             * @brief Return the length of the sequence
+             */
+            uint64_t size() const
+            {
+                return this->_size;
+            }
+
+            /**
+             * @brief Return the number of the maximal runs of N
+             */
+            uint64_t n_run_count() const
+            {
+                return this->n_run_starting_positions.size();
+            }
+
+            /**
+             * @brief Return the memory usage of this sequence in bytes
+             */
+            uint64_t size_in_bytes() const
+            {
+                return sizeof(PackedDNASequence) + (this->words.capacity() + this->n_run_starting_positions.capacity() + this->n_run_ending_positions.capacity() + this->separator_positions.capacity()) * sizeof(uint64_t);
+            }
+
+            void clear()
+            {
+                std::vector<uint64_t>().swap(this->words);
+                std::vector<uint64_t>().swap(this->n_run_starting_positions);
+                std::vector<uint64_t>().swap(this->n_run_ending_positions);
+                std::vector<uint64_t>().swap(this->separator_positions);
+                this->_size = 0;
+            }
+
+            void swap(PackedDNASequence &item)
+            {
+                this->words.swap(item.words);
+                this->n_run_starting_positions.swap(item.n_run_starting_positions);
+                this->n_run_ending_positions.swap(item.n_run_ending_positions);
+                this->separator_positions.swap(item.separator_positions);
+                std::swap(this->_size, item._size);
+            }
+
+            /**
+             * @brief Append the character \p c (one of A, C, G, T, N, and SEPARATOR)
+             * @throws std::invalid_argument if \p c is not one of A, C, G, T, N, and SEPARATOR
+             */
+            void push_back(uint8_t c)
+            {
+                uint64_t code = 0;
+                if (c == SEPARATOR)
+                {
+                    this->separator_positions.push_back(this->_size);
+                }
+                else if (c == 'N')
+                {
+                    if (this->n_run_ending_positions.size() > 0 && this->n_run_ending_positions[this->n_run_ending_positions.size() - 1] == this->_size)
+                    {
+                        this->n_run_ending_positions[this->n_run_ending_positions.size() - 1]++;
+                    }
+                    else
+                    {
+                        this->n_run_starting_positions.push_back(this->_size);
+                        this->n_run_ending_positions.push_back(this->_size + 1);
+                    }
+                }
+                else
+                {
+                    code = PackedDNASequence::to_code(c);
+                }
+
+                if (this->_size % CHARS_PER_WORD == 0)
+                {
+                    this->words.push_back(0);
+                }
+                this->words[this->words.size() - 1] |= code << (2 * (this->_size % CHARS_PER_WORD));
+                this->_size++;
+            }
+
+            /**
+             * @brief Return the character at the position \p i
+             * @note O(log k + log s) time, where k is the number of the runs of N and s is the number of the separators
+             */
+            uint8_t at(uint64_t i) const
+            {
+                if (std::binary_search(this->separator_positions.begin(), this->separator_positions.end(), i))
+                {
+                    return SEPARATOR;
+                }
+                auto it = std::upper_bound(this->n_run_starting_positions.begin(), this->n_run_starting_positions.end(), i);
+                if (it != this->n_run_starting_positions.begin())
+                {
+                    uint64_t k = std::distance(this->n_run_starting_positions.begin(), it) - 1;
+                    if (i < this->n_run_ending_positions[k])
+                    {
+                        return 'N';
+                    }
+                }
+                return CODE_TO_CHAR[(this->words[i / CHARS_PER_WORD] >> (2 * (i % CHARS_PER_WORD))) & 3];
+            }
+
+            /**
+             * @brief Copy the characters starting at \p pos to \p output (at most \p max_len characters), and return the number of the copied characters
+             * @note O(log k + log s + max_len) time, where k is the number of the runs of N and s is the number of the separators
+             */
+            uint64_t read(uint64_t pos, char *output, uint64_t max_len) const
+            {
+                uint64_t len = std::min(max_len, this->_size > pos ? this->_size - pos : 0);
+
+                // The index of the first run of N ending after pos
+                uint64_t k = std::distance(this->n_run_ending_positions.begin(), std::upper_bound(this->n_run_ending_positions.begin(), this->n_run_ending_positions.end(), pos));
+                for (uint64_t i = pos; i < pos + len; i++)
+                {
+                    if (k < this->n_run_starting_positions.size() && i >= this->n_run_ending_positions[k])
+                    {
+                        k++;
+                    }
+                    if (k < this->n_run_starting_positions.size() && i >= this->n_run_starting_positions[k])
+                    {
+                        output[i - pos] = 'N';
+                    }
+                    else
+                    {
+                        output[i - pos] = CODE_TO_CHAR[(this->words[i / CHARS_PER_WORD] >> (2 * (i % CHARS_PER_WORD))) & 3];
+                    }
+                }
+                for (auto it = std::lower_bound(this->separator_positions.begin(), this->separator_positions.end(), pos); it != this->separator_positions.end() && *it < pos + len; it++)
+                {
+                    output[*it - pos] = SEPARATOR;
+                }
+                return len;
+            }
+
+            /**
+             * @brief Return the sequence as a string
+             */
+            std::string to_string() const
+            {
+                std::string r;
+                r.resize(this->_size);
+                this->read(0, r.data(), this->_size);
+                return r;
+            }
+
+            /**
+             * @brief Return a new seekable stream of the sequence
+             * @note This sequence must be alive while the stream is used.
+             */
+            std::unique_ptr<std::istream> open() const
+            {
+                return std::make_unique<RandomAccessStream<SequenceReader>>(SequenceReader(*this));
+            }
+        };
+    }
+}
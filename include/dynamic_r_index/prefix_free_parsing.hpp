@@ -0,0 +1,602 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <istream>
+#include <memory>
+#include <functional>
+#include <future>
+#include <unordered_map>
+#include <algorithm>
+#include <tuple>
+#include <stdexcept>
+#include "stool/include/lib.hpp"
+#include "../dynamic_fm_index/tools.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief Builder computing the RLBWT of a text and the SA values at the run boundaries by prefix-free parsing (Big-BWT)
+         * @details The text T[0..n-1] is regarded as a circular string ending with the end marker $, and every position q such that
+         * T[q..q+w-1] (circularly) starts with $ or has a Karp-Rabin fingerprint divisible by \p p is a trigger position.
+         * The text is parsed into phrases T[t_j..t_{j+1}+w-1] between consecutive trigger positions t_j and t_{j+1}, which overlap by w characters.
+         * Then the BWT is obtained from the sorted dictionary of the distinct phrases and the suffix array of the parse, and it is emitted run by run together with
+         * the SA values at the first and last positions of each run.
+         * The suffix array of the text is never materialized: the space is O(|D| + |P|) words, where |D| is the total length of the distinct phrases and |P| is the number of phrases,
+         * and the text is read twice from a stream.
+         * The trigger positions can be computed by multiple threads, each of which scans a block of the text from its own stream.
+         * \ingroup DynamicRIndexes
+         */
+        class PrefixFreeParsing
+        {
+        public:
+            static inline constexpr uint64_t DEFAULT_WINDOW_SIZE = 10;
+            static inline constexpr uint64_t DEFAULT_MODULUS = 100;
+
+        private:
+            static inline constexpr uint64_t KR_BASE = 256;
+            static inline constexpr uint64_t KR_PRIME = 1999999973;
+            static inline constexpr uint64_t BUFFER_SIZE = 1ULL << 20;
+
+            /**
+             * @brief Sequential reader of the text stored in a stream; the end marker is appended if the stream does not end with it
+             */
+            class TextReader
+            {
+                std::istream *is;
+                std::vector<char> buffer;
+                uint64_t buffer_size = 0;
+                uint64_t buffer_pos = 0;
+                uint64_t read_size = 0;
+                uint64_t stream_size = 0;
+                uint8_t end_marker;
+                bool append_end_marker;
+
+            public:
+                TextReader(std::istream &_is, uint8_t _end_marker) : is(&_is), end_marker(_end_marker)
+                {
+                    this->is->clear();
+                    this->is->seekg(0, std::ios::end);
+                    this->stream_size = this->is->tellg();
+                    this->append_end_marker = true;
+                    if (this->stream_size > 0)
+                    {
+                        char last_char = 0;
+                        this->is->seekg(this->stream_size - 1, std::ios::beg);
+                        this->is->read(&last_char, 1);
+                        this->append_end_marker = (uint8_t)last_char != this->end_marker;
+                    }
+                    this->buffer.resize(BUFFER_SIZE);
+                    this->reset();
+                }
+
+                /**
+                 * @brief Return the length of the text including the end marker
+                 */
+                uint64_t text_size() const
+                {
+                    return this->stream_size + (this->append_end_marker ? 1 : 0);
+                }
+
+                void reset()
+                {
+                    this->seek(0);
+                }
+
+                /**
+                 * @brief Move the reader to the position \p pos of the text
+                 */
+                void seek(uint64_t pos)
+                {
+                    this->read_size = std::min(pos, this->stream_size);
+                    this->is->clear();
+                    this->is->seekg(this->read_size, std::ios::beg);
+                    this->buffer_size = 0;
+                    this->buffer_pos = 0;
+                }
+
+                uint8_t next()
+                {
+                    if (this->buffer_pos == this->buffer_size)
+                    {
+                        if (this->read_size < this->stream_size)
+                        {
+                            uint64_t len = std::min<uint64_t>(BUFFER_SIZE, this->stream_size - this->read_size);
+                            this->is->read(this->buffer.data(), len);
+                            this->buffer_size = len;
+                            this->buffer_pos = 0;
+                            this->read_size += len;
+                        }
+                        else
+                        {
+                            return this->end_marker;
+                        }
+                    }
+                    return (uint8_t)this->buffer[this->buffer_pos++];
+                }
+            };
+
+        public:
+            /**
+             * @brief Compute the RLBWT of the text in \p is and the SA values at the first and last positions of each run
+             * @param is The input stream of the text (it must support seekg(); the end marker is appended if the last character is not \p end_marker)
+             * @param end_marker The end marker, which must be the smallest character and occur only at the end of the text
+             * @param output_rlbwt_chars The characters of the runs
+             * @param output_rlbwt_runs The lengths of the runs
+             * @param output_fst_sampling_sa The SA value at the first position of each run
+             * @param output_last_sampling_sa The SA value at the last position of each run
+             * @param window_size The length w of the trigger strings
+             * @param modulus The modulus p of the fingerprints of the trigger strings
+             * @param message_paragraph Message indentation level for progress output
+             * @throws std::runtime_error if the end marker is not the unique smallest character of the text
+             */
+            static void build(std::istream &is, uint8_t end_marker, std::vector<uint8_t> &output_rlbwt_chars, std::vector<uint64_t> &output_rlbwt_runs,
+                              std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa,
+                              uint64_t window_size = DEFAULT_WINDOW_SIZE, uint64_t modulus = DEFAULT_MODULUS, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                std::vector<TextReader> readers;
+                readers.emplace_back(is, end_marker);
+                PrefixFreeParsing::build(readers, end_marker, output_rlbwt_chars, output_rlbwt_runs, output_fst_sampling_sa, output_last_sampling_sa, window_size, modulus, message_paragraph);
+            }
+
+            /**
+             * @brief Compute the RLBWT of a text and the SA values at the first and last positions of each run, where the trigger positions are computed by multiple threads
+             * @param open_stream A function returning a new stream of the text (it is called \p thread_count times, and each stream must support seekg())
+             * @param end_marker The end marker, which must be the smallest character and occur only at the end of the text
+             * @param output_rlbwt_chars The characters of the runs
+             * @param output_rlbwt_runs The lengths of the runs
+             * @param output_fst_sampling_sa The SA value at the first position of each run
+             * @param output_last_sampling_sa The SA value at the last position of each run
+             * @param window_size The length w of the trigger strings
+             * @param modulus The modulus p of the fingerprints of the trigger strings
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used to compute the trigger positions
+             * @throws std::runtime_error if the end marker is not the unique smallest character of the text
+             */
+            static void build(const std::function<std::unique_ptr<std::istream>()> &open_stream, uint8_t end_marker, std::vector<uint8_t> &output_rlbwt_chars, std::vector<uint64_t> &output_rlbwt_runs,
+                              std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa,
+                              uint64_t window_size = DEFAULT_WINDOW_SIZE, uint64_t modulus = DEFAULT_MODULUS, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
+            {
+                std::vector<std::unique_ptr<std::istream>> streams;
+                std::vector<TextReader> readers;
+                readers.reserve(std::max<uint64_t>(thread_count, 1));
+                for (uint64_t t = 0; t < std::max<uint64_t>(thread_count, 1); t++)
+                {
+                    streams.push_back(open_stream());
+                    readers.emplace_back(*streams[t], end_marker);
+                }
+                PrefixFreeParsing::build(readers, end_marker, output_rlbwt_chars, output_rlbwt_runs, output_fst_sampling_sa, output_last_sampling_sa, window_size, modulus, message_paragraph);
+            }
+
+        private:
+            /**
+             * @brief Compute the RLBWT and the sampled SA values, where the trigger positions are computed by readers.size() threads and the parse is computed with readers[0]
+             */
+            static void build(std::vector<TextReader> &readers, uint8_t end_marker, std::vector<uint8_t> &output_rlbwt_chars, std::vector<uint64_t> &output_rlbwt_runs,
+                              std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa,
+                              uint64_t window_size, uint64_t modulus, int message_paragraph)
+            {
+                if (window_size == 0 || modulus == 0)
+                {
+                    throw std::invalid_argument("PrefixFreeParsing: the window size and the modulus must be positive");
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                TextReader &reader = readers[0];
+                uint64_t text_size = reader.text_size();
+                if (message_paragraph >= 0 && text_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing RLBWT and sampled suffix arrays by prefix-free parsing..." << std::endl;
+                }
+                uint64_t w = std::max<uint64_t>(1, std::min<uint64_t>(window_size, text_size - 1));
+
+                std::vector<uint64_t> trigger_positions = PrefixFreeParsing::compute_trigger_positions(readers, end_marker, w, modulus);
+
+                std::string dictionary;
+                std::vector<uint64_t> phrase_starts;
+                std::vector<uint64_t> parse;
+                PrefixFreeParsing::compute_parse(reader, trigger_positions, w, dictionary, phrase_starts, parse);
+                if (message_paragraph >= 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph + 1) << "Number of phrases: " << parse.size() << ", number of distinct phrases: " << (phrase_starts.size() - 1) << std::endl;
+                }
+
+                std::vector<uint64_t> parse_isa = PrefixFreeParsing::compute_cyclic_isa(parse);
+
+                output_rlbwt_chars.clear();
+                output_rlbwt_runs.clear();
+                output_fst_sampling_sa.clear();
+                output_last_sampling_sa.clear();
+                PrefixFreeParsing::compute_RLBWT(dictionary, phrase_starts, parse, parse_isa, trigger_positions, text_size, w, output_rlbwt_chars, output_rlbwt_runs, output_fst_sampling_sa, output_last_sampling_sa);
+
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+            }
+
+            /**
+             * @brief Return the trigger positions in increasing order (the last one is the position n-1 of the end marker)
+             * @details The text is divided into readers.size() blocks of almost equal length, and the trigger positions in the i-th block are computed by a thread with readers[i].
+             */
+            static std::vector<uint64_t> compute_trigger_positions(std::vector<TextReader> &readers, uint8_t end_marker, uint64_t w, uint64_t modulus)
+            {
+                uint64_t text_size = readers[0].text_size();
+                uint64_t block_count = std::min<uint64_t>(readers.size(), text_size);
+                if (block_count <= 1)
+                {
+                    return PrefixFreeParsing::compute_trigger_positions(readers[0], end_marker, w, modulus, 0, text_size);
+                }
+
+                uint64_t block_size = (text_size + block_count - 1) / block_count;
+                std::vector<std::future<std::vector<uint64_t>>> futures;
+                for (uint64_t i = 0; i < block_count; i++)
+                {
+                    uint64_t range_begin = std::min(text_size, i * block_size);
+                    uint64_t range_end = std::min(text_size, (i + 1) * block_size);
+                    TextReader *reader = &readers[i];
+                    futures.push_back(std::async(std::launch::async, [reader, end_marker, w, modulus, range_begin, range_end]()
+                                                 { return PrefixFreeParsing::compute_trigger_positions(*reader, end_marker, w, modulus, range_begin, range_end); }));
+                }
+                std::vector<uint64_t> r;
+                for (auto &f : futures)
+                {
+                    std::vector<uint64_t> block_trigger_positions = f.get();
+                    r.insert(r.end(), block_trigger_positions.begin(), block_trigger_positions.end());
+                }
+                return r;
+            }
+
+            /**
+             * @brief Return the trigger positions q with \p range_begin <= q < \p range_end in increasing order
+             * @details The characters T[range_begin..range_end+w-2] are read, and the windows starting at n-w+1, ..., n-1 wrap around the end of the text.
+             */
+            static std::vector<uint64_t> compute_trigger_positions(TextReader &reader, uint8_t end_marker, uint64_t w, uint64_t modulus, uint64_t range_begin, uint64_t range_end)
+            {
+                uint64_t text_size = reader.text_size();
+                reader.seek(range_begin);
+
+                uint64_t highest_power = 1;
+                for (uint64_t i = 1; i < w; i++)
+                {
+                    highest_power = (highest_power * KR_BASE) % KR_PRIME;
+                }
+
+                std::vector<uint8_t> window;
+                window.resize(w, 0);
+                uint64_t hash = 0;
+                std::vector<uint64_t> r;
+                if (range_begin >= range_end)
+                {
+                    return r;
+                }
+
+                for (uint64_t pos = range_begin; pos < range_end + w - 1; pos++)
+                {
+                    if (pos == text_size)
+                    {
+                        reader.seek(0);
+                    }
+                    uint8_t c = reader.next();
+                    if (pos < range_end && (c < end_marker || (c == end_marker && pos + 1 != text_size)))
+                    {
+                        throw std::runtime_error("PrefixFreeParsing: the end marker must be the unique smallest character of the text");
+                    }
+
+                    uint64_t x = pos - range_begin;
+                    if (x >= w)
+                    {
+                        uint8_t removed_char = window[x % w];
+                        hash = (hash + KR_PRIME - ((removed_char * highest_power) % KR_PRIME)) % KR_PRIME;
+                    }
+                    window[x % w] = c;
+                    hash = ((hash * KR_BASE) + c) % KR_PRIME;
+
+                    if (x + 1 >= w)
+                    {
+                        uint64_t q = pos + 1 - w;
+                        if (q + 1 == text_size || hash % modulus == 0)
+                        {
+                            r.push_back(q);
+                        }
+                    }
+                }
+                return r;
+            }
+
+            /**
+             * @brief Parse the text into the phrases T[t_j..t_{j+1}+w-1] (0 <= j < k, t_k = t_0 + n), and return the distinct phrases in lexicographic order and the parse as the ranks of the phrases
+             * @details The distinct phrases are concatenated into \p output_dictionary, and the d-th phrase is output_dictionary[output_phrase_starts[d]..output_phrase_starts[d+1]-1].
+             */
+            static void compute_parse(TextReader &reader, const std::vector<uint64_t> &trigger_positions, uint64_t w, std::string &output_dictionary, std::vector<uint64_t> &output_phrase_starts, std::vector<uint64_t> &output_parse)
+            {
+                uint64_t text_size = reader.text_size();
+                uint64_t k = trigger_positions.size();
+                reader.reset();
+
+                // T[0..t_0+w-1] is read again at the end for the phrase starting at the end marker
+                uint64_t head_size = std::min(text_size, trigger_positions[0] + w);
+                std::string head;
+
+                std::unordered_map<std::string, uint64_t> phrase_ids;
+                std::vector<std::string> phrases;
+                std::vector<uint64_t> parse_ids;
+                parse_ids.reserve(k);
+
+                std::string buffer;
+                uint64_t buffer_start = trigger_positions[0];
+                uint64_t j = 0;
+                uint64_t last_position = trigger_positions[0] + text_size + w - 1;
+                for (uint64_t pos = 0; pos <= last_position; pos++)
+                {
+                    uint8_t c = pos < text_size ? reader.next() : (uint8_t)head[(pos - text_size) % text_size];
+                    if (pos < head_size)
+                    {
+                        head.push_back(c);
+                    }
+                    if (pos < buffer_start)
+                    {
+                        continue;
+                    }
+                    buffer.push_back(c);
+                    uint64_t next_trigger_position = j + 1 < k ? trigger_positions[j + 1] : trigger_positions[0] + text_size;
+                    if (pos == next_trigger_position + w - 1)
+                    {
+                        auto it = phrase_ids.find(buffer);
+                        if (it == phrase_ids.end())
+                        {
+                            it = phrase_ids.insert(std::make_pair(buffer, phrases.size())).first;
+                            phrases.push_back(buffer);
+                        }
+                        parse_ids.push_back(it->second);
+                        buffer.erase(0, next_trigger_position - buffer_start);
+                        buffer_start = next_trigger_position;
+                        j++;
+                    }
+                }
+                assert(parse_ids.size() == k);
+                std::unordered_map<std::string, uint64_t>().swap(phrase_ids);
+
+                std::vector<uint64_t> order;
+                order.resize(phrases.size());
+                for (uint64_t i = 0; i < order.size(); i++)
+                {
+                    order[i] = i;
+                }
+                std::sort(order.begin(), order.end(), [&](uint64_t lhs, uint64_t rhs)
+                          { return phrases[lhs] < phrases[rhs]; });
+                std::vector<uint64_t> ranks;
+                ranks.resize(phrases.size());
+                uint64_t dictionary_size = 0;
+                for (const std::string &phrase : phrases)
+                {
+                    dictionary_size += phrase.size();
+                }
+                output_dictionary.clear();
+                output_dictionary.reserve(dictionary_size);
+                output_phrase_starts.resize(phrases.size() + 1);
+                output_phrase_starts[0] = 0;
+                for (uint64_t i = 0; i < order.size(); i++)
+                {
+                    ranks[order[i]] = i;
+                    output_dictionary.append(phrases[order[i]]);
+                    std::string().swap(phrases[order[i]]);
+                    output_phrase_starts[i + 1] = output_dictionary.size();
+                }
+                output_parse.resize(k);
+                for (uint64_t i = 0; i < k; i++)
+                {
+                    output_parse[i] = ranks[parse_ids[i]];
+                }
+            }
+
+            /**
+             * @brief Return the ranks of the cyclic rotations of the parse by prefix doubling
+             * @note The last phrase starts with the end marker and is the unique smallest phrase, and hence the ranks of the rotations are the ranks of the suffixes.
+             */
+            static std::vector<uint64_t> compute_cyclic_isa(const std::vector<uint64_t> &parse)
+            {
+                uint64_t k = parse.size();
+                std::vector<uint64_t> rank = parse;
+                std::vector<uint64_t> tmp_rank;
+                tmp_rank.resize(k);
+                std::vector<uint64_t> sa;
+                sa.resize(k);
+                for (uint64_t i = 0; i < k; i++)
+                {
+                    sa[i] = i;
+                }
+                for (uint64_t h = 1;; h *= 2)
+                {
+                    auto key = [&](uint64_t i)
+                    {
+                        return std::pair<uint64_t, uint64_t>(rank[i], rank[(i + h) % k]);
+                    };
+                    std::sort(sa.begin(), sa.end(), [&](uint64_t lhs, uint64_t rhs)
+                              { return key(lhs) < key(rhs); });
+                    tmp_rank[sa[0]] = 0;
+                    for (uint64_t i = 1; i < k; i++)
+                    {
+                        tmp_rank[sa[i]] = tmp_rank[sa[i - 1]] + (key(sa[i - 1]) < key(sa[i]) ? 1 : 0);
+                    }
+                    rank.swap(tmp_rank);
+                    if (rank[sa[k - 1]] + 1 == k || h >= k)
+                    {
+                        break;
+                    }
+                }
+                return rank;
+            }
+
+            /**
+             * @brief Compare the suffixes of the phrases starting at the offsets \p lhs and \p rhs of the concatenated dictionary, where phrase_ends[i] is true iff \p dictionary[i] is the last character of its phrase
+             * @return A negative value, zero, or a positive value if the suffix at \p lhs is smaller than, equal to, or larger than the suffix at \p rhs
+             */
+            static int compare_phrase_suffixes(const std::string &dictionary, const std::vector<bool> &phrase_ends, uint64_t lhs, uint64_t rhs)
+            {
+                while (true)
+                {
+                    uint8_t lhs_c = dictionary[lhs];
+                    uint8_t rhs_c = dictionary[rhs];
+                    if (lhs_c != rhs_c)
+                    {
+                        return lhs_c < rhs_c ? -1 : 1;
+                    }
+                    bool lhs_end = phrase_ends[lhs];
+                    bool rhs_end = phrase_ends[rhs];
+                    if (lhs_end || rhs_end)
+                    {
+                        return lhs_end == rhs_end ? 0 : (lhs_end ? -1 : 1);
+                    }
+                    lhs++;
+                    rhs++;
+                }
+            }
+
+            /**
+             * @brief Emit the BWT run by run from the sorted suffixes of the phrases
+             * @details Every text position t_j + o with 0 <= o < |phrase_j| - w corresponds to the suffix of the j-th phrase starting at o, which is longer than w.
+             * Such suffixes of different strings are ordered by the strings, because none of them is a proper prefix of another.
+             * The occurrences of the same string are ordered by the ranks of the rotations of the parse starting at their next phrases.
+             * As in Big-BWT, a suffix of a phrase is represented by its 8-byte offset in the concatenated dictionary (see compute_parse()), and the ends of the phrases are marked by one bit per character.
+             */
+            static void compute_RLBWT(const std::string &dictionary, const std::vector<uint64_t> &phrase_starts, const std::vector<uint64_t> &parse, const std::vector<uint64_t> &parse_isa,
+                                      const std::vector<uint64_t> &trigger_positions, uint64_t text_size, uint64_t w,
+                                      std::vector<uint8_t> &output_rlbwt_chars, std::vector<uint64_t> &output_rlbwt_runs,
+                                      std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa)
+            {
+                uint64_t k = parse.size();
+                uint64_t d_size = phrase_starts.size() - 1;
+
+                // occurrences[occ_starts[d]..occ_starts[d+1]-1] are the occurrences j of the d-th phrase sorted by the ranks of the rotations starting at j+1
+                std::vector<uint64_t> occ_starts;
+                occ_starts.resize(d_size + 1, 0);
+                for (uint64_t d : parse)
+                {
+                    occ_starts[d + 1]++;
+                }
+                for (uint64_t d = 0; d < d_size; d++)
+                {
+                    occ_starts[d + 1] += occ_starts[d];
+                }
+                std::vector<uint64_t> parse_sa;
+                parse_sa.resize(k);
+                for (uint64_t j = 0; j < k; j++)
+                {
+                    parse_sa[parse_isa[j]] = j;
+                }
+                std::vector<uint64_t> occurrences;
+                occurrences.resize(k);
+                {
+                    std::vector<uint64_t> counters(occ_starts.begin(), occ_starts.end() - 1);
+                    for (uint64_t i = 0; i < k; i++)
+                    {
+                        uint64_t j = (parse_sa[i] + k - 1) % k;
+                        occurrences[counters[parse[j]]++] = j;
+                    }
+                }
+                std::vector<uint64_t>().swap(parse_sa);
+
+                std::vector<bool> phrase_ends;
+                phrase_ends.resize(dictionary.size(), false);
+                std::vector<uint64_t> phrase_suffixes;
+                for (uint64_t d = 0; d < d_size; d++)
+                {
+                    phrase_ends[phrase_starts[d + 1] - 1] = true;
+                    for (uint64_t offset = phrase_starts[d]; offset + w < phrase_starts[d + 1]; offset++)
+                    {
+                        phrase_suffixes.push_back(offset);
+                    }
+                }
+                std::sort(phrase_suffixes.begin(), phrase_suffixes.end(), [&](uint64_t lhs, uint64_t rhs)
+                          { return PrefixFreeParsing::compare_phrase_suffixes(dictionary, phrase_ends, lhs, rhs) < 0; });
+                auto get_phrase_index = [&](uint64_t offset)
+                {
+                    return (uint64_t)(std::upper_bound(phrase_starts.begin(), phrase_starts.end(), offset) - phrase_starts.begin()) - 1;
+                };
+
+                auto emit = [&](uint8_t c, uint64_t len, uint64_t fst_sa, uint64_t last_sa)
+                {
+                    if (output_rlbwt_chars.size() > 0 && output_rlbwt_chars[output_rlbwt_chars.size() - 1] == c)
+                    {
+                        output_rlbwt_runs[output_rlbwt_runs.size() - 1] += len;
+                        output_last_sampling_sa[output_last_sampling_sa.size() - 1] = last_sa;
+                    }
+                    else
+                    {
+                        output_rlbwt_chars.push_back(c);
+                        output_rlbwt_runs.push_back(len);
+                        output_fst_sampling_sa.push_back(fst_sa);
+                        output_last_sampling_sa.push_back(last_sa);
+                    }
+                };
+                auto get_text_position = [&](uint64_t j, uint64_t o)
+                {
+                    return (trigger_positions[j] + o) % text_size;
+                };
+
+                // Tuples of (the rank of the rotation starting at j+1, j, o, the preceding character or UINT64_MAX)
+                std::vector<std::tuple<uint64_t, uint64_t, uint64_t, uint64_t>> merged_occurrences;
+                uint64_t emitted_length = 0;
+                uint64_t x = 0;
+                while (x < phrase_suffixes.size())
+                {
+                    uint64_t y = x + 1;
+                    while (y < phrase_suffixes.size() && PrefixFreeParsing::compare_phrase_suffixes(dictionary, phrase_ends, phrase_suffixes[x], phrase_suffixes[y]) == 0)
+                    {
+                        y++;
+                    }
+
+                    uint64_t x_phrase_index = get_phrase_index(phrase_suffixes[x]);
+                    if (y == x + 1 && phrase_suffixes[x] > phrase_starts[x_phrase_index])
+                    {
+                        // All the occurrences are preceded by the same character
+                        uint64_t d = x_phrase_index;
+                        uint64_t o = phrase_suffixes[x] - phrase_starts[d];
+                        uint64_t fst_j = occurrences[occ_starts[d]];
+                        uint64_t last_j = occurrences[occ_starts[d + 1] - 1];
+                        uint64_t freq = occ_starts[d + 1] - occ_starts[d];
+                        emit(dictionary[phrase_suffixes[x] - 1], freq, get_text_position(fst_j, o), get_text_position(last_j, o));
+                        emitted_length += freq;
+                    }
+                    else
+                    {
+                        merged_occurrences.clear();
+                        for (uint64_t z = x; z < y; z++)
+                        {
+                            uint64_t d = get_phrase_index(phrase_suffixes[z]);
+                            uint64_t o = phrase_suffixes[z] - phrase_starts[d];
+                            for (uint64_t e = occ_starts[d]; e < occ_starts[d + 1]; e++)
+                            {
+                                uint64_t j = occurrences[e];
+                                uint64_t c = UINT64_MAX;
+                                if (o > 0)
+                                {
+                                    c = (uint8_t)dictionary[phrase_suffixes[z] - 1];
+                                }
+                                else
+                                {
+                                    uint64_t prev_phrase_end = phrase_starts[parse[(j + k - 1) % k] + 1];
+                                    c = (uint8_t)dictionary[prev_phrase_end - w - 1];
+                                }
+                                merged_occurrences.push_back(std::make_tuple(parse_isa[(j + 1) % k], j, o, c));
+                            }
+                        }
+                        std::sort(merged_occurrences.begin(), merged_occurrences.end());
+                        for (auto &item : merged_occurrences)
+                        {
+                            uint64_t sa_value = get_text_position(std::get<1>(item), std::get<2>(item));
+                            emit((uint8_t)std::get<3>(item), 1, sa_value, sa_value);
+                        }
+                        emitted_length += merged_occurrences.size();
+                    }
+                    x = y;
+                }
+                if (emitted_length != text_size)
+                {
+                    throw std::logic_error("PrefixFreeParsing: the length of the BWT is " + std::to_string(emitted_length) + ", but the length of the text is " + std::to_string(text_size));
+                }
+            }
+        };
+    }
+}
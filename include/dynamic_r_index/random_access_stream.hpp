@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include <istream>
+#include <streambuf>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief A read-only seekable stream buffer over a random-access source of characters
+         * @tparam SOURCE A class supporting size() (the number of characters) and read(pos, output, max_len) (copy at most max_len characters starting at pos to output, and return the number of the copied characters)
+         * \ingroup DynamicRIndexes
+         */
+        template <typename SOURCE>
+        class RandomAccessStreamBuffer : public std::streambuf
+        {
+            static inline constexpr uint64_t BUFFER_SIZE = 1ULL << 20;
+
+            SOURCE source;
+            std::vector<char> buffer;
+
+            // The position of the source following the last character of the buffer
+            uint64_t position = 0;
+
+        public:
+            RandomAccessStreamBuffer(SOURCE &&_source) : source(std::move(_source))
+            {
+                this->buffer.resize(BUFFER_SIZE);
+                this->setg(this->buffer.data(), this->buffer.data(), this->buffer.data());
+            }
+
+        protected:
+            int_type underflow() override
+            {
+                if (this->gptr() < this->egptr())
+                {
+                    return traits_type::to_int_type(*this->gptr());
+                }
+                uint64_t len = this->position < this->source.size() ? this->source.read(this->position, this->buffer.data(), this->buffer.size()) : 0;
+                if (len == 0)
+                {
+                    return traits_type::eof();
+                }
+                this->setg(this->buffer.data(), this->buffer.data(), this->buffer.data() + len);
+                this->position += len;
+                return traits_type::to_int_type(*this->gptr());
+            }
+
+            pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+            {
+                int64_t current_position = this->position - (this->egptr() - this->gptr());
+                int64_t base = dir == std::ios_base::beg ? 0 : (dir == std::ios_base::cur ? current_position : (int64_t)this->source.size());
+                return this->seekpos(pos_type(off_type(base + off)), which);
+            }
+
+            pos_type seekpos(pos_type sp, std::ios_base::openmode which) override
+            {
+                int64_t pos = off_type(sp);
+                if ((which & std::ios_base::in) == 0 || pos < 0 || (uint64_t)pos > this->source.size())
+                {
+                    return pos_type(off_type(-1));
+                }
+                this->position = pos;
+                this->setg(this->buffer.data(), this->buffer.data(), this->buffer.data());
+                return sp;
+            }
+        };
+
+        /**
+         * @brief The source of RandomAccessStream reading a byte vector, which must be alive while the stream is used
+         * \ingroup DynamicRIndexes
+         */
+        class ByteVectorReader
+        {
+            const std::vector<uint8_t> *bytes;
+
+        public:
+            ByteVectorReader(const std::vector<uint8_t> &_bytes) : bytes(&_bytes)
+            {
+            }
+
+            uint64_t size() const
+            {
+                return this->bytes->size();
+            }
+
+            uint64_t read(uint64_t pos, char *output, uint64_t max_len)
+            {
+                uint64_t len = std::min<uint64_t>(max_len, this->bytes->size() - pos);
+                std::memcpy(output, this->bytes->data() + pos, len);
+                return len;
+            }
+        };
+
+        /**
+         * @brief An input stream owning a RandomAccessStreamBuffer
+         * \ingroup DynamicRIndexes
+         */
+        template <typename SOURCE>
+        class RandomAccessStream : public std::istream
+        {
+            RandomAccessStreamBuffer<SOURCE> stream_buffer;
+
+        public:
+            RandomAccessStream(SOURCE &&_source) : std::istream(nullptr), stream_buffer(std::move(_source))
+            {
+                this->rdbuf(&this->stream_buffer);
+            }
+        };
+    }
+}
@@ -22,9 +22,10 @@ namespace stool
              * @brief Preprocess the RLBWT with the first character
              * @param rlbwt The DynamicRLBWT to build
              * @param first_char The first character to insert
+             * @param output_run_position The run position of the inserted character
              * @return The position after insertion
              */
-            static uint64_t preprocess(DynamicRLBWT &rlbwt, uint8_t first_char)
+            static uint64_t preprocess(DynamicRLBWT &rlbwt, uint8_t first_char, RunPosition &output_run_position)
             {
                 uint64_t pos = 1;
 
@@ -32,7 +33,7 @@ namespace stool
                 //rlbwt.insert_new_run(0, first_char, 1);
 
 
-                RLBWTBuilder::append_char_for_online_construction(rlbwt, first_char, pos);
+                output_run_position = RLBWTBuilder::append_char_for_online_construction(rlbwt, first_char, pos);
                 return pos;
             }
             
@@ -74,8 +75,17 @@ namespace stool
             static uint64_t compute_next_position_to_insert(DynamicRLBWT &rlbwt, uint8_t c, uint64_t current_position)
             {
                 RunPosition pos_on_rlbwt = rlbwt.to_run_position(current_position);
+                return RLBWTBuilder::compute_next_position_to_insert(rlbwt, c, pos_on_rlbwt);
+            }
+
+            /**
+             * @brief Compute the next position to insert a character using LF mapping, where the run position of the current position is given
+             * @note If \p c is the character at \p current_run_position (i.e., \p c was inserted in the previous step), the rank is computed within the run without searching the runs of \p c
+             */
+            static uint64_t compute_next_position_to_insert(DynamicRLBWT &rlbwt, uint8_t c, RunPosition current_run_position)
+            {
                 uint64_t freq = rlbwt.get_c_array().at(c);
-                uint64_t rank = rlbwt.rank(c, pos_on_rlbwt);
+                uint64_t rank = rlbwt.rank(c, current_run_position);
                 uint64_t new_pos = freq + rank;
                 return new_pos;
             }
@@ -85,10 +95,12 @@ namespace stool
              * @param rlbwt The DynamicRLBWT to update
              * @param c The character to append
              * @param position_on_BWT The position in the BWT where to insert
+             * @return The run position of the inserted character
              * @note This method handles run merging when adjacent runs have the same character
              */
-            static void append_char_for_online_construction(DynamicRLBWT &rlbwt, uint8_t c, uint64_t position_on_BWT)
+            static RunPosition append_char_for_online_construction(DynamicRLBWT &rlbwt, uint8_t c, uint64_t position_on_BWT)
             {
+                RunPosition result;
                 RunPosition rp = rlbwt.to_run_position(position_on_BWT, true);
 
                 //assert(rp.position_in_run >= 0);
@@ -103,10 +115,12 @@ namespace stool
                     {
 
                         rlbwt.increment_run(rp.run_index - 1, 1);
+                        result = RunPosition(rp.run_index - 1, rlbwt.get_run_length(rp.run_index - 1) - 1);
                     }
                     else
                     {
                         rlbwt.insert_new_run(rp.run_index, c, 1);
+                        result = RunPosition(rp.run_index, 0);
                     }
                 }
                 else if (position_on_BWT == 0)
@@ -121,6 +135,7 @@ namespace stool
                     {
                         rlbwt.insert_new_run(0, c, 1);
                     }
+                    result = RunPosition(0, 0);
                 }
                 else
                 {
@@ -135,16 +150,19 @@ namespace stool
                         if (rp.position_in_run > 0)
                         {
                             rlbwt.increment_run(rp.run_index, 1);
+                            result = rp;
                         }
                         else
                         {
 
                             rlbwt.increment_run(rp.run_index - 1, 1);
+                            result = RunPosition(rp.run_index - 1, rlbwt.get_run_length(rp.run_index - 1) - 1);
                         }
                     }
                     else if (c2 == c)
                     {
                         rlbwt.increment_run(rp.run_index, 1);
+                        result = RunPosition(rp.run_index, 0);
                     }
                     else
                     {
@@ -152,6 +170,7 @@ namespace stool
                         if (rp.position_in_run == 0)
                         {
                             rlbwt.insert_new_run(rp.run_index, c, 1);
+                            result = RunPosition(rp.run_index, 0);
                         }
                         else
                         {
@@ -161,9 +180,12 @@ namespace stool
                             rlbwt.decrement_run(rp.run_index, rl - d1);
                             rlbwt.insert_new_run(rp.run_index + 1, c, 1);
                             rlbwt.insert_new_run(rp.run_index + 2, c2, d2);
+                            result = RunPosition(rp.run_index + 1, 0);
                         }
                     }
                 }
+                assert(rlbwt.to_position(result) == position_on_BWT);
+                return result;
             }
 
         public:
@@ -192,7 +214,9 @@ namespace stool
                     DynamicRLBWT rlbwt = DynamicRLBWT::build_RLBWT_of_end_marker(chars);
 
 
-                    uint64_t pos = RLBWTBuilder::preprocess(rlbwt, rev_text[0]);
+                    // The run position of the last inserted character is kept, and hence each step searches the runs only once (in append_char_for_online_construction)
+                    RunPosition rp;
+                    uint64_t pos = RLBWTBuilder::preprocess(rlbwt, rev_text[0], rp);
                     uint64_t counter = 0;
                     for (uint64_t i = 0; i + 1 < rev_text.size(); i++)
                     {
@@ -204,8 +228,8 @@ namespace stool
                         }
                         uint8_t c1 = rev_text[i];
                         uint8_t c2 = rev_text[i + 1];
-                        uint64_t new_pos = RLBWTBuilder::compute_next_position_to_insert(rlbwt, c1, pos);
-                        RLBWTBuilder::append_char_for_online_construction(rlbwt, c2, new_pos);
+                        uint64_t new_pos = RLBWTBuilder::compute_next_position_to_insert(rlbwt, c1, rp);
+                        rp = RLBWTBuilder::append_char_for_online_construction(rlbwt, c2, new_pos);
                         pos = new_pos;
 
                     }
@@ -259,7 +283,8 @@ namespace stool
                     inputStream.open(file_path, std::ios::binary);
                     stool::OnlineFileReader::read(inputStream, buffer, buffer_size, text_size);
 
-                    uint64_t pos = RLBWTBuilder::preprocess(rlbwt, buffer[0]);
+                    RunPosition rp;
+                    uint64_t pos = RLBWTBuilder::preprocess(rlbwt, buffer[0], rp);
                     uint64_t pos_on_buffer = 0;
                     uint64_t counter = 0;
 
@@ -276,8 +301,8 @@ namespace stool
                         {
                             uint8_t c1 = buffer[pos_on_buffer];
                             uint8_t c2 = buffer[pos_on_buffer + 1];
-                            uint64_t new_pos = RLBWTBuilder::compute_next_position_to_insert(rlbwt, c1, pos);
-                            RLBWTBuilder::append_char_for_online_construction(rlbwt, c2, new_pos);
+                            uint64_t new_pos = RLBWTBuilder::compute_next_position_to_insert(rlbwt, c1, rp);
+                            rp = RLBWTBuilder::append_char_for_online_construction(rlbwt, c2, new_pos);
                             pos = new_pos;
                             pos_on_buffer++;
                         }
@@ -288,8 +313,8 @@ namespace stool
                             if (b)
                             {
                                 uint8_t c2 = buffer[0];
-                                uint64_t new_pos = RLBWTBuilder::compute_next_position_to_insert(rlbwt, c1, pos);
-                                RLBWTBuilder::append_char_for_online_construction(rlbwt, c2, new_pos);
+                                uint64_t new_pos = RLBWTBuilder::compute_next_position_to_insert(rlbwt, c1, rp);
+                                rp = RLBWTBuilder::append_char_for_online_construction(rlbwt, c2, new_pos);
                                 pos = new_pos;
                                 pos_on_buffer = 0;
                             }
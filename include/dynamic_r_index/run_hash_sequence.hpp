@@ -0,0 +1,338 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief A dynamic sequence of keys x_0, x_1, ..., x_{m-1} maintaining the polynomial hash H = sum_{i} h(x_i) B^i mod (2^61 - 1)
+         * @details The keys are stored in an implicit treap, and each node keeps the hash and B^{size} of its subtree,
+         * so that the hash of the concatenation of two subtrees is computed in O(1) time.
+         * Since the weight of a key depends on its position, two different sequences have the same hash only with a small probability,
+         * even if they consist of the same keys or the same pairs of adjacent keys.
+         * @note insert(), erase(), and set() take O(log m) expected time, and hash() takes O(1) time. The space is 40 bytes per key.
+         * \ingroup DynamicRIndexes
+         */
+        class RunHashSequence
+        {
+            static inline constexpr uint64_t MODULUS = (1ULL << 61) - 1;
+            static inline constexpr uint64_t BASE = 0x1f3d5b79a2c4e687ULL % MODULUS;
+            static inline constexpr uint32_t NIL = UINT32_MAX;
+
+            struct Node
+            {
+                uint64_t value;
+                uint64_t hash;
+                uint64_t power;
+                uint32_t size;
+                uint32_t priority;
+                uint32_t left;
+                uint32_t right;
+            };
+
+            std::vector<Node> nodes;
+            std::vector<uint32_t> free_nodes;
+            uint32_t root = NIL;
+            uint64_t priority_counter = 0;
+
+        public:
+            RunHashSequence()
+            {
+            }
+            RunHashSequence(RunHashSequence &&) noexcept = default;
+            RunHashSequence &operator=(RunHashSequence &&) noexcept = default;
+
+            /**
+             * @brief Return the number of keys
+             */
+            uint64_t size() const
+            {
+                return this->root == NIL ? 0 : this->nodes[this->root].size;
+            }
+
+            /**
+             * @brief Return the hash of the sequence (0 for the empty sequence)
+             */
+            uint64_t hash() const
+            {
+                return this->root == NIL ? 0 : this->nodes[this->root].hash;
+            }
+
+            uint64_t size_in_bytes() const
+            {
+                return sizeof(RunHashSequence) + this->nodes.capacity() * sizeof(Node) + this->free_nodes.capacity() * sizeof(uint32_t);
+            }
+
+            void clear()
+            {
+                std::vector<Node>().swap(this->nodes);
+                std::vector<uint32_t>().swap(this->free_nodes);
+                this->root = NIL;
+            }
+
+            void swap(RunHashSequence &item)
+            {
+                this->nodes.swap(item.nodes);
+                this->free_nodes.swap(item.free_nodes);
+                std::swap(this->root, item.root);
+                std::swap(this->priority_counter, item.priority_counter);
+            }
+
+            /**
+             * @brief Insert \p key at the position \p i
+             */
+            void insert(uint64_t i, uint64_t key)
+            {
+                if (i > this->size())
+                {
+                    throw std::out_of_range("RunHashSequence::insert(), the position is out of range");
+                }
+                uint32_t x = this->create_node(key);
+                uint32_t left = NIL, right = NIL;
+                this->split(this->root, i, left, right);
+                this->root = this->merge(this->merge(left, x), right);
+            }
+
+            /**
+             * @brief Remove the key at the position \p i
+             */
+            void erase(uint64_t i)
+            {
+                if (i >= this->size())
+                {
+                    throw std::out_of_range("RunHashSequence::erase(), the position is out of range");
+                }
+                uint32_t left = NIL, middle = NIL, right = NIL;
+                this->split(this->root, i, left, right);
+                this->split(right, 1, middle, right);
+                this->free_nodes.push_back(middle);
+                this->root = this->merge(left, right);
+            }
+
+            /**
+             * @brief Replace the key at the position \p i with \p key
+             */
+            void set(uint64_t i, uint64_t key)
+            {
+                if (i >= this->size())
+                {
+                    throw std::out_of_range("RunHashSequence::set(), the position is out of range");
+                }
+                this->set(this->root, i, RunHashSequence::to_value(key));
+            }
+
+            /**
+             * @brief Build the sequence of the given keys in O(m) time
+             */
+            static RunHashSequence build(const std::vector<uint64_t> &keys)
+            {
+                RunHashSequence r;
+                r.nodes.reserve(keys.size());
+
+                // The Cartesian tree of the priorities is built with the right spine kept in a stack
+                std::vector<uint32_t> right_spine;
+                for (uint64_t key : keys)
+                {
+                    uint32_t x = r.create_node(key);
+                    uint32_t last = NIL;
+                    while (right_spine.size() > 0 && r.nodes[right_spine.back()].priority < r.nodes[x].priority)
+                    {
+                        last = right_spine.back();
+                        right_spine.pop_back();
+                        r.update(last);
+                    }
+                    r.nodes[x].left = last;
+                    if (right_spine.size() > 0)
+                    {
+                        r.nodes[right_spine.back()].right = x;
+                    }
+                    right_spine.push_back(x);
+                }
+                while (right_spine.size() > 0)
+                {
+                    r.update(right_spine.back());
+                    r.root = right_spine.back();
+                    right_spine.pop_back();
+                }
+                return r;
+            }
+
+            /**
+             * @brief Compute the hash of the given keys from scratch
+             */
+            static uint64_t compute_hash(const std::vector<uint64_t> &keys)
+            {
+                uint64_t r = 0;
+                uint64_t power = 1;
+                for (uint64_t key : keys)
+                {
+                    r = RunHashSequence::add(r, RunHashSequence::multiply(RunHashSequence::to_value(key), power));
+                    power = RunHashSequence::multiply(power, BASE);
+                }
+                return r;
+            }
+
+        private:
+            static uint64_t multiply(uint64_t x, uint64_t y)
+            {
+                unsigned __int128 z = (unsigned __int128)x * y;
+                uint64_t r = (uint64_t)(z & MODULUS) + (uint64_t)(z >> 61);
+                return r >= MODULUS ? r - MODULUS : r;
+            }
+            static uint64_t add(uint64_t x, uint64_t y)
+            {
+                uint64_t r = x + y;
+                return r >= MODULUS ? r - MODULUS : r;
+            }
+
+            /**
+             * @brief The finalizer of SplitMix64
+             */
+            static uint64_t mix(uint64_t x)
+            {
+                x ^= x >> 30;
+                x *= 0xbf58476d1ce4e5b9ULL;
+                x ^= x >> 27;
+                x *= 0x94d049bb133111ebULL;
+                x ^= x >> 31;
+                return x;
+            }
+            static uint64_t to_value(uint64_t key)
+            {
+                return RunHashSequence::mix(key) % MODULUS;
+            }
+
+            uint32_t create_node(uint64_t key)
+            {
+                Node node;
+                node.value = RunHashSequence::to_value(key);
+                node.hash = node.value;
+                node.power = BASE;
+                node.size = 1;
+                node.priority = (uint32_t)RunHashSequence::mix(++this->priority_counter);
+                node.left = NIL;
+                node.right = NIL;
+                if (this->free_nodes.size() > 0)
+                {
+                    uint32_t x = this->free_nodes.back();
+                    this->free_nodes.pop_back();
+                    this->nodes[x] = node;
+                    return x;
+                }
+                else
+                {
+                    if (this->nodes.size() >= NIL)
+                    {
+                        throw std::length_error("RunHashSequence: too many keys");
+                    }
+                    this->nodes.push_back(node);
+                    return this->nodes.size() - 1;
+                }
+            }
+
+            /**
+             * @brief Recompute the size, the hash, and B^{size} of the subtree rooted at \p x from its children
+             */
+            void update(uint32_t x)
+            {
+                Node &node = this->nodes[x];
+                uint64_t left_size = 0, left_hash = 0, left_power = 1;
+                if (node.left != NIL)
+                {
+                    const Node &left = this->nodes[node.left];
+                    left_size = left.size;
+                    left_hash = left.hash;
+                    left_power = left.power;
+                }
+                uint64_t right_size = 0, right_hash = 0, right_power = 1;
+                if (node.right != NIL)
+                {
+                    const Node &right = this->nodes[node.right];
+                    right_size = right.size;
+                    right_hash = right.hash;
+                    right_power = right.power;
+                }
+                uint64_t middle_power = RunHashSequence::multiply(left_power, BASE);
+                node.size = left_size + 1 + right_size;
+                node.hash = RunHashSequence::add(RunHashSequence::add(left_hash, RunHashSequence::multiply(node.value, left_power)), RunHashSequence::multiply(right_hash, middle_power));
+                node.power = RunHashSequence::multiply(middle_power, right_power);
+            }
+
+            /**
+             * @brief Split the subtree rooted at \p x into the first \p k keys and the others
+             */
+            void split(uint32_t x, uint64_t k, uint32_t &output_left, uint32_t &output_right)
+            {
+                if (x == NIL)
+                {
+                    output_left = NIL;
+                    output_right = NIL;
+                    return;
+                }
+                uint64_t left_size = this->nodes[x].left == NIL ? 0 : this->nodes[this->nodes[x].left].size;
+                if (k <= left_size)
+                {
+                    uint32_t tmp = NIL;
+                    this->split(this->nodes[x].left, k, output_left, tmp);
+                    this->nodes[x].left = tmp;
+                    output_right = x;
+                }
+                else
+                {
+                    uint32_t tmp = NIL;
+                    this->split(this->nodes[x].right, k - left_size - 1, tmp, output_right);
+                    this->nodes[x].right = tmp;
+                    output_left = x;
+                }
+                this->update(x);
+            }
+
+            uint32_t merge(uint32_t x, uint32_t y)
+            {
+                if (x == NIL)
+                {
+                    return y;
+                }
+                else if (y == NIL)
+                {
+                    return x;
+                }
+                else if (this->nodes[x].priority > this->nodes[y].priority)
+                {
+                    uint32_t tmp = this->merge(this->nodes[x].right, y);
+                    this->nodes[x].right = tmp;
+                    this->update(x);
+                    return x;
+                }
+                else
+                {
+                    uint32_t tmp = this->merge(x, this->nodes[y].left);
+                    this->nodes[y].left = tmp;
+                    this->update(y);
+                    return y;
+                }
+            }
+
+            void set(uint32_t x, uint64_t i, uint64_t value)
+            {
+                uint64_t left_size = this->nodes[x].left == NIL ? 0 : this->nodes[this->nodes[x].left].size;
+                if (i < left_size)
+                {
+                    this->set(this->nodes[x].left, i, value);
+                }
+                else if (i == left_size)
+                {
+                    this->nodes[x].value = value;
+                }
+                else
+                {
+                    this->set(this->nodes[x].right, i - left_size - 1, value);
+                }
+                this->update(x);
+            }
+        };
+    }
+}
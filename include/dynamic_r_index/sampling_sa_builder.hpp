@@ -1,6 +1,10 @@
 #pragma once
 #include "./dynamic_rlbwt_helper.hpp"
+#include "./static_rlbwt_for_construction.hpp"
+#include "../dynamic_fm_index/tools.hpp"
 #include "stool/include/lib.hpp"
+#include <atomic>
+#include <future>
 
 namespace stool
 {
@@ -17,6 +21,16 @@ namespace stool
         class SamplingSATBuilder
         {
             using RLBWT = stool::rlbwt2::RLE<uint8_t>;
+            using LF_DATA = stool::rlbwt2::LFDataStructureBasedOnRLBWT<RLBWT, stool::rlbwt2::LightFPosDataStructure>;
+
+            /**
+             * @brief The result of a walk started by build_in_parallel()
+             */
+            struct Walk
+            {
+                uint64_t next_walk_id = UINT64_MAX; ///< The ID of the walk starting at the row reached by the last LF step
+                uint64_t length = 0;                ///< The number of visited rows
+            };
 
         public:
             /**
@@ -25,10 +39,11 @@ namespace stool
              * @param output_fst_sampling_sa Output vector for first SA values of each run
              * @param output_last_sampling_sa Output vector for last SA values of each run
              * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used for the LF traversal (see build_in_parallel())
              * @throws std::logic_error if sampling fails for any run
-             * @note Uses backward ISA traversal to compute SA values
+             * @note Uses the LF traversal from the end marker to compute SA values
              */
-            static void build(const RLBWT &static_rlbwt, std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            static void build(const RLBWT &static_rlbwt, std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
             {
                 uint64_t text_size = static_rlbwt.str_size();
                 if (message_paragraph >= 0 && text_size > 0)
@@ -42,20 +57,94 @@ namespace stool
                 stool::WT wt = stool::rlbwt2::WaveletTreeOnHeadChars::build(&static_rlbwt);
                 stool::rlbwt2::LightFPosDataStructure fpos_array;
                 fpos_array.build(static_rlbwt.get_head_char_vec(), *static_rlbwt.get_lpos_vec(), &wt, stool::Message::increment_paragraph_level(message_paragraph));
-                using LF_DATA = stool::rlbwt2::LFDataStructureBasedOnRLBWT<RLBWT, stool::rlbwt2::LightFPosDataStructure>;
                 LF_DATA rle_wt(&static_rlbwt, &fpos_array);
 
+                SamplingSATBuilder::build_by_LF(static_rlbwt, rle_wt, output_fst_sampling_sa, output_last_sampling_sa, thread_count, message_paragraph);
+
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+            }
+
+            /**
+             * @brief Build sampled suffix arrays from the run vectors of an RLBWT
+             * @details Unlike the other overload, this function needs no static RLBWT; the LF function is computed on the run vectors (see StaticRLBWTForConstruction),
+             * and hence the same run vectors can be used to build DynamicRLBWT afterwards.
+             * @param rlbwt_chars The characters of the runs
+             * @param rlbwt_runs The lengths of the runs
+             * @param output_fst_sampling_sa Output vector for first SA values of each run
+             * @param output_last_sampling_sa Output vector for last SA values of each run
+             * @param message_paragraph Message indentation level for progress output
+             * @param thread_count The number of threads used for the LF traversal (see build_in_parallel())
+             * @throws std::logic_error if sampling fails for any run
+             */
+            static void build(const std::vector<uint8_t> &rlbwt_chars, const std::vector<uint64_t> &rlbwt_runs, std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa, int message_paragraph = stool::Message::SHOW_MESSAGE, uint64_t thread_count = 1)
+            {
+                StaticRLBWTForConstruction static_rlbwt(rlbwt_chars, rlbwt_runs);
+                uint64_t text_size = static_rlbwt.str_size();
+                if (message_paragraph >= 0 && text_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Constructing two sampled suffix arrays from RLBWT..." << std::endl;
+                }
+                std::chrono::system_clock::time_point st1, st2;
+                st1 = std::chrono::system_clock::now();
+
+                SamplingSATBuilder::build_by_LF(static_rlbwt, static_rlbwt, output_fst_sampling_sa, output_last_sampling_sa, thread_count, message_paragraph);
+
+                st2 = std::chrono::system_clock::now();
+                print_elapsed_time(message_paragraph, st1, st2, text_size);
+            }
+
+        private:
+            /**
+             * @brief Compute the sampled SA values of \p static_rlbwt by the LF function \p lf_data
+             * @tparam RLBWT_DS stool::rlbwt2::RLE or StaticRLBWTForConstruction
+             * @tparam LF_DS A data structure supporting lf(i)
+             */
+            template <typename RLBWT_DS, typename LF_DS>
+            static void build_by_LF(const RLBWT_DS &static_rlbwt, LF_DS &lf_data, std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa, uint64_t thread_count, int message_paragraph)
+            {
+                uint64_t text_size = static_rlbwt.str_size();
+                output_fst_sampling_sa.clear();
+                output_last_sampling_sa.clear();
+                if (text_size == 0)
+                {
+                    return;
+                }
                 uint64_t end_marker_lposition = static_rlbwt.get_end_rle_lposition();
                 uint64_t end_marker_position = static_rlbwt.get_lpos(end_marker_lposition);
 
                 output_fst_sampling_sa.resize(static_rlbwt.rle_size(), UINT64_MAX);
                 output_last_sampling_sa.resize(static_rlbwt.rle_size(), UINT64_MAX);
 
-                stool::bwt::BackwardISA<LF_DATA> isa_ds;
+                if (thread_count > 1 && text_size > 1)
+                {
+                    SamplingSATBuilder::build_in_parallel(static_rlbwt, lf_data, end_marker_position, output_fst_sampling_sa, output_last_sampling_sa, thread_count, message_paragraph);
+                }
+                else
+                {
+                    SamplingSATBuilder::build_sequentially(static_rlbwt, lf_data, end_marker_position, output_fst_sampling_sa, output_last_sampling_sa, message_paragraph);
+                }
 
-                //uint64_t max_value_pos_in_suffix_array = rle_wt.lf(end_marker_position);
-                //assert(max_value_pos_in_suffix_array == 0);
+                for (uint64_t i = 0; i < output_fst_sampling_sa.size(); i++)
+                {
+                    if (output_fst_sampling_sa[i] == UINT64_MAX)
+                    {
+                        throw std::logic_error("Error1/ i = " + std::to_string(i));
+                    }
+                    if (output_last_sampling_sa[i] == UINT64_MAX)
+                    {
+                        throw std::logic_error("Error2");
+                    }
+                }
+            }
 
+            /**
+             * @brief Compute the sampled SA values by a single backward ISA traversal from the end marker
+             */
+            template <typename RLBWT_DS, typename LF_DS>
+            static void build_sequentially(const RLBWT_DS &static_rlbwt, LF_DS &lf_data, uint64_t end_marker_position, std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa, int message_paragraph)
+            {
+                uint64_t text_size = static_rlbwt.str_size();
 
                 if (message_paragraph >= 0 && text_size > 0)
                 {
@@ -64,15 +153,10 @@ namespace stool
                 uint64_t message_counter = 10000000;
                 uint64_t processed_text_length = 0;
 
-
-                isa_ds.set(&rle_wt, end_marker_position, text_size);
-                int64_t text_position = text_size;
-
-
-                for (stool::bwt::BackwardISA<LF_DATA>::iterator it = isa_ds.begin(); it != isa_ds.end(); ++it)
+                // The SA value of the row of the end marker in L is 0, and LF of the row is the row of the SA value n-1
+                uint64_t row = lf_data.lf(end_marker_position);
+                for (int64_t text_position = text_size - 1; text_position >= 0; text_position--)
                 {
-
-                    text_position--;
                     message_counter++;
                     processed_text_length++;
                     if (message_paragraph >= 0 && message_counter > 10000000)
@@ -81,11 +165,10 @@ namespace stool
                         message_counter=0;
                     }
 
-                    uint64_t lindex = static_rlbwt.get_lindex_containing_the_position(*it);
+                    uint64_t lindex = static_rlbwt.get_lindex_containing_the_position(row);
                     uint64_t run_length = static_rlbwt.get_run(lindex);
                     uint64_t starting_position = static_rlbwt.get_lpos(lindex);
-                    uint64_t diff = (*it) - starting_position;
-
+                    uint64_t diff = row - starting_position;
 
                     if (diff == 0)
                     {
@@ -95,37 +178,171 @@ namespace stool
                     {
                         output_last_sampling_sa[lindex] = text_position;
                     }
+                    if (text_position > 0)
+                    {
+                        row = lf_data.lf(row);
+                    }
                 }
                 if (message_paragraph >= 0 && text_size > 0)
                 {
                     std::cout << std::endl;
                     std::cout << stool::Message::get_paragraph_string(message_paragraph+1) << "[END]" << std::endl;
                 }
+            }
 
+            /**
+             * @brief Compute the sampled SA values by walking disjoint segments of the text concurrently
+             * @details The rows i * step (0 <= i * step < n) and the row of the end marker in L are chosen as starting rows.
+             * Starting from each starting row, a walk applies LF until it reaches another starting row, and it stores, for each run boundary it visits,
+             * the number of LF steps from its starting row. Since LF forms a single cycle over all the rows, the walks partition the text into segments,
+             * and the SA values of the starting rows are obtained by following the walks from the row of the end marker, whose SA value is 0.
+             * Finally, the SA value of each run boundary is computed from the SA value of the starting row of its walk.
+             * The walks are assigned to \p thread_count threads dynamically.
+             * @note The walks need O(r) words of extra space (the IDs of the walks visiting the run boundaries).
+             */
+            template <typename RLBWT_DS, typename LF_DS>
+            static void build_in_parallel(const RLBWT_DS &static_rlbwt, LF_DS &lf_data, uint64_t end_marker_position, std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa, uint64_t thread_count, int message_paragraph)
+            {
+                uint64_t text_size = static_rlbwt.str_size();
+                uint64_t run_count = static_rlbwt.rle_size();
+                if (message_paragraph >= 0 && text_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph + 1) << "Reading the input string by LF function with " << thread_count << " threads..." << std::flush;
+                }
 
-                for (uint64_t i = 0; i < output_fst_sampling_sa.size(); i++)
+                // Use more walks than threads so that the threads stay busy even if the walks have different lengths
+                uint64_t segment_count = std::min(text_size, thread_count * 16);
+                uint64_t step = (text_size + segment_count - 1) / segment_count;
+                uint64_t multiple_count = ((text_size - 1) / step) + 1;
+                bool end_marker_is_multiple = end_marker_position % step == 0;
+                uint64_t walk_count = multiple_count + (end_marker_is_multiple ? 0 : 1);
+                uint64_t end_marker_walk_id = end_marker_is_multiple ? end_marker_position / step : multiple_count;
+
+                auto get_walk_id = [&](uint64_t row) -> uint64_t
                 {
-                    if (output_fst_sampling_sa[i] == UINT64_MAX)
+                    if (row % step == 0)
                     {
-                        throw std::logic_error("Error1/ i = " + std::to_string(i));
+                        return row / step;
                     }
-                    if (output_last_sampling_sa[i] == UINT64_MAX)
+                    else if (row == end_marker_position)
                     {
-                        throw std::logic_error("Error2");
+                        return end_marker_walk_id;
+                    }
+                    else
+                    {
+                        return UINT64_MAX;
+                    }
+                };
+
+                std::vector<Walk> walks;
+                walks.resize(walk_count);
+                std::vector<uint32_t> fst_walk_ids;
+                std::vector<uint32_t> last_walk_ids;
+                fst_walk_ids.resize(run_count, UINT32_MAX);
+                last_walk_ids.resize(run_count, UINT32_MAX);
+
+                std::atomic<uint64_t> next_walk(0);
+                std::vector<std::future<void>> futures;
+                for (uint64_t t = 0; t < thread_count; t++)
+                {
+                    futures.push_back(std::async(std::launch::async, [&]()
+                                                 {
+                        while (true)
+                        {
+                            uint64_t walk_id = next_walk.fetch_add(1);
+                            if (walk_id >= walk_count)
+                            {
+                                break;
+                            }
+                            uint64_t row = walk_id < multiple_count ? walk_id * step : end_marker_position;
+                            uint64_t d = 0;
+                            while (true)
+                            {
+                                uint64_t lindex = static_rlbwt.get_lindex_containing_the_position(row);
+                                uint64_t run_length = static_rlbwt.get_run(lindex);
+                                uint64_t diff = row - static_rlbwt.get_lpos(lindex);
+                                if (diff == 0)
+                                {
+                                    output_fst_sampling_sa[lindex] = d;
+                                    fst_walk_ids[lindex] = walk_id;
+                                }
+                                if (diff + 1 == run_length)
+                                {
+                                    output_last_sampling_sa[lindex] = d;
+                                    last_walk_ids[lindex] = walk_id;
+                                }
+                                d++;
+                                row = lf_data.lf(row);
+                                uint64_t next_walk_id = get_walk_id(row);
+                                if (next_walk_id != UINT64_MAX)
+                                {
+                                    walks[walk_id].next_walk_id = next_walk_id;
+                                    walks[walk_id].length = d;
+                                    break;
+                                }
+                            }
+                        } }));
+                }
+                for (auto &f : futures)
+                {
+                    f.get();
+                }
+
+                // The SA value of the row of the end marker in L is 0, and the i-th row visited by a walk starting at a row with the SA value v has the SA value v - i (mod n)
+                std::vector<uint64_t> starting_sa_values;
+                starting_sa_values.resize(walk_count, UINT64_MAX);
+                uint64_t walk_id = end_marker_walk_id;
+                uint64_t sa_value = 0;
+                uint64_t total_length = 0;
+                for (uint64_t i = 0; i < walk_count; i++)
+                {
+                    if (starting_sa_values[walk_id] != UINT64_MAX)
+                    {
+                        throw std::logic_error("SamplingSATBuilder: the walks do not form a single cycle");
                     }
+                    starting_sa_values[walk_id] = sa_value;
+                    total_length += walks[walk_id].length;
+                    sa_value = (sa_value + text_size - (walks[walk_id].length % text_size)) % text_size;
+                    walk_id = walks[walk_id].next_walk_id;
+                }
+                if (walk_id != end_marker_walk_id || total_length != text_size)
+                {
+                    throw std::logic_error("SamplingSATBuilder: the walks do not cover the text");
                 }
 
-                st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && text_size > 0)
+                auto resolve = [&](std::vector<uint64_t> &output, const std::vector<uint32_t> &walk_ids, uint64_t i)
                 {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double) text_size) * 1000000;
+                    if (walk_ids[i] != UINT32_MAX)
+                    {
+                        output[i] = (starting_sa_values[walk_ids[i]] + text_size - output[i]) % text_size;
+                    }
+                };
+                futures.clear();
+                for (uint64_t t = 0; t < thread_count; t++)
+                {
+                    uint64_t begin = (run_count * t) / thread_count;
+                    uint64_t end = (run_count * (t + 1)) / thread_count;
+                    futures.push_back(std::async(std::launch::async, [&, begin, end]()
+                                                 {
+                        for (uint64_t i = begin; i < end; i++)
+                        {
+                            resolve(output_fst_sampling_sa, fst_walk_ids, i);
+                            resolve(output_last_sampling_sa, last_walk_ids, i);
+                        } }));
+                }
+                for (auto &f : futures)
+                {
+                    f.get();
+                }
 
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
+                if (message_paragraph >= 0 && text_size > 0)
+                {
+                    std::cout << "[END]" << std::endl;
                 }
             }
 
+        public:
+
             /*
             static void build(std::string file_path, std::vector<uint64_t> &output_fst_sampling_sa, std::vector<uint64_t> &output_last_sampling_sa, int message_paragraph = stool::Message::SHOW_MESSAGE)
             {
@@ -179,14 +396,7 @@ namespace stool
                 }
 
                 st2 = std::chrono::system_clock::now();
-                if (message_paragraph >= 0 && rlbwt.text_size() > 0)
-                {
-                    uint64_t sec_time = std::chrono::duration_cast<std::chrono::seconds>(st2 - st1).count();
-                    uint64_t ms_time = std::chrono::duration_cast<std::chrono::milliseconds>(st2 - st1).count();
-                    uint64_t per_time = ((double)ms_time / (double)rlbwt.text_size()) * 1000000;
-
-                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "[END] Elapsed Time: " << sec_time << " sec (" << per_time << " ms/MB)" << std::endl;
-                }
+                print_elapsed_time(message_paragraph, st1, st2, rlbwt.text_size());
             }
             */
         };
@@ -0,0 +1,260 @@
+#pragma once
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include "stool/include/lib.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief A static RLBWT supporting LF, built on the run vectors that are also used to build DynamicRLBWT
+         * @details This class stores pointers to the characters and the lengths of the runs, and it additionally stores the starting position of each run in L
+         * and the number of occurrences of the character of each run in the preceding runs.
+         * LF(i) = C[c] + (the number of c in the runs preceding the run containing i) + (the offset of i in the run), where c is the character of the run.
+         * It has the subset of the interface of stool::rlbwt2::RLE used by SamplingSATBuilder.
+         * @note The space is 2r words in addition to the run vectors, and LF takes O(log r) time.
+         * \ingroup DynamicRIndexes
+         */
+        class StaticRLBWTForConstruction
+        {
+            static inline constexpr uint64_t BUFFER_SIZE = 1ULL << 26;
+            static inline constexpr uint64_t RLBWT_RECORD_SIZE = 9;
+
+            const std::vector<uint8_t> *rlbwt_chars;
+            const std::vector<uint64_t> *rlbwt_runs;
+            std::vector<uint64_t> lpos_vector;
+            std::vector<uint64_t> rank_vector;
+            std::vector<uint64_t> C;
+            uint64_t end_marker_lindex = UINT64_MAX;
+            uint64_t _text_size = 0;
+
+        public:
+            /**
+             * @brief Build the LF data for the given runs
+             * @param _rlbwt_chars The characters of the runs (it must be alive while this instance is used)
+             * @param _rlbwt_runs The lengths of the runs (it must be alive while this instance is used)
+             * @throws std::runtime_error if the smallest character does not occur exactly once
+             */
+            StaticRLBWTForConstruction(const std::vector<uint8_t> &_rlbwt_chars, const std::vector<uint64_t> &_rlbwt_runs) : rlbwt_chars(&_rlbwt_chars), rlbwt_runs(&_rlbwt_runs)
+            {
+                uint64_t run_count = _rlbwt_chars.size();
+                std::vector<uint64_t> counters;
+                counters.resize(256, 0);
+                this->lpos_vector.resize(run_count + 1, 0);
+                this->rank_vector.resize(run_count, 0);
+                for (uint64_t i = 0; i < run_count; i++)
+                {
+                    uint8_t c = _rlbwt_chars[i];
+                    this->lpos_vector[i + 1] = this->lpos_vector[i] + _rlbwt_runs[i];
+                    this->rank_vector[i] = counters[c];
+                    counters[c] += _rlbwt_runs[i];
+                }
+                this->_text_size = this->lpos_vector[run_count];
+
+                this->C.resize(257, 0);
+                for (uint64_t c = 0; c < 256; c++)
+                {
+                    this->C[c + 1] = this->C[c] + counters[c];
+                }
+
+                for (uint64_t i = 0; i < run_count; i++)
+                {
+                    if (this->end_marker_lindex == UINT64_MAX || _rlbwt_chars[i] < _rlbwt_chars[this->end_marker_lindex])
+                    {
+                        this->end_marker_lindex = i;
+                    }
+                }
+                if (run_count > 0 && counters[_rlbwt_chars[this->end_marker_lindex]] != 1)
+                {
+                    throw std::runtime_error("The smallest character of the BWT must occur exactly once.");
+                }
+            }
+
+            uint64_t str_size() const
+            {
+                return this->_text_size;
+            }
+            uint64_t rle_size() const
+            {
+                return this->rlbwt_chars->size();
+            }
+            uint64_t get_run(uint64_t lindex) const
+            {
+                return (*this->rlbwt_runs)[lindex];
+            }
+            uint64_t get_lpos(uint64_t lindex) const
+            {
+                return this->lpos_vector[lindex];
+            }
+            uint64_t get_end_rle_lposition() const
+            {
+                return this->end_marker_lindex;
+            }
+
+            /**
+             * @brief Return the index of the run containing the position \p i in L
+             */
+            uint64_t get_lindex_containing_the_position(uint64_t i) const
+            {
+                auto it = std::upper_bound(this->lpos_vector.begin(), this->lpos_vector.end(), i);
+                return std::distance(this->lpos_vector.begin(), it) - 1;
+            }
+
+            uint64_t lf(uint64_t i) const
+            {
+                uint64_t lindex = this->get_lindex_containing_the_position(i);
+                uint8_t c = (*this->rlbwt_chars)[lindex];
+                return this->C[c] + this->rank_vector[lindex] + (i - this->lpos_vector[lindex]);
+            }
+
+            /**
+             * @brief Compute the run vectors of the BWT stored in a file by a single sequential scan with large reads
+             * @throws std::runtime_error if the file cannot be opened or read to the end
+             */
+            static void load_RLBWT_from_BWT_file(std::string file_path, std::vector<uint8_t> &output_rlbwt_chars, std::vector<uint64_t> &output_rlbwt_runs, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                std::ifstream ifs(file_path, std::ios::binary);
+                if (!ifs)
+                {
+                    throw std::runtime_error("Cannot open the file: " + file_path);
+                }
+                ifs.seekg(0, std::ios::end);
+                uint64_t file_size = ifs.tellg();
+                ifs.seekg(0, std::ios::beg);
+                if (message_paragraph >= 0 && file_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Reading the BWT file..." << std::flush;
+                }
+
+                output_rlbwt_chars.clear();
+                output_rlbwt_runs.clear();
+                std::vector<char> buffer;
+                buffer.resize(std::min(BUFFER_SIZE, std::max<uint64_t>(file_size, 1)));
+                uint64_t read_size = 0;
+                while (read_size < file_size)
+                {
+                    uint64_t len = std::min<uint64_t>(buffer.size(), file_size - read_size);
+                    ifs.read(buffer.data(), len);
+                    if (!ifs || (uint64_t)ifs.gcount() != len)
+                    {
+                        throw std::runtime_error("Cannot read the file to the end (the file may be truncated or changed during the reading): " + file_path);
+                    }
+                    for (uint64_t i = 0; i < len; i++)
+                    {
+                        uint8_t c = buffer[i];
+                        if (output_rlbwt_chars.size() > 0 && output_rlbwt_chars[output_rlbwt_chars.size() - 1] == c)
+                        {
+                            output_rlbwt_runs[output_rlbwt_runs.size() - 1]++;
+                        }
+                        else
+                        {
+                            output_rlbwt_chars.push_back(c);
+                            output_rlbwt_runs.push_back(1);
+                        }
+                    }
+                    read_size += len;
+                }
+                if (message_paragraph >= 0 && file_size > 0)
+                {
+                    std::cout << "[END]" << std::endl;
+                }
+            }
+
+            /**
+             * @brief Load the run vectors from an RLBWT file by a single sequential scan with large reads
+             * @details The RLBWT file is a sequence of 9-byte records, one per run: the character (1 byte) followed by the length of the run (8 bytes, little-endian).
+             * The file has no header, and the number of runs is the file size divided by 9. Adjacent records with the same character are merged.
+             * @throws std::runtime_error if the file cannot be opened or read to the end, its size is not a multiple of 9, or a run length is zero
+             */
+            static void load_RLBWT_from_RLBWT_file(std::string file_path, std::vector<uint8_t> &output_rlbwt_chars, std::vector<uint64_t> &output_rlbwt_runs, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                std::ifstream ifs(file_path, std::ios::binary);
+                if (!ifs)
+                {
+                    throw std::runtime_error("Cannot open the file: " + file_path);
+                }
+                ifs.seekg(0, std::ios::end);
+                uint64_t file_size = ifs.tellg();
+                ifs.seekg(0, std::ios::beg);
+                if (file_size % RLBWT_RECORD_SIZE != 0)
+                {
+                    throw std::runtime_error("The size of the RLBWT file must be a multiple of " + std::to_string(RLBWT_RECORD_SIZE) + ": " + file_path);
+                }
+                if (message_paragraph >= 0 && file_size > 0)
+                {
+                    std::cout << stool::Message::get_paragraph_string(message_paragraph) << "Reading the RLBWT file..." << std::flush;
+                }
+
+                output_rlbwt_chars.clear();
+                output_rlbwt_runs.clear();
+                output_rlbwt_chars.reserve(file_size / RLBWT_RECORD_SIZE);
+                output_rlbwt_runs.reserve(file_size / RLBWT_RECORD_SIZE);
+                std::vector<char> buffer;
+                uint64_t block_size = (BUFFER_SIZE / RLBWT_RECORD_SIZE) * RLBWT_RECORD_SIZE;
+                buffer.resize(std::min(block_size, std::max<uint64_t>(file_size, 1)));
+                uint64_t read_size = 0;
+                while (read_size < file_size)
+                {
+                    uint64_t len = std::min<uint64_t>(buffer.size(), file_size - read_size);
+                    ifs.read(buffer.data(), len);
+                    if (!ifs || (uint64_t)ifs.gcount() != len)
+                    {
+                        throw std::runtime_error("Cannot read the file to the end (the file may be truncated or changed during the reading): " + file_path);
+                    }
+                    for (uint64_t i = 0; i < len; i += RLBWT_RECORD_SIZE)
+                    {
+                        uint8_t c = buffer[i];
+                        uint64_t run_length = 0;
+                        for (uint64_t x = 0; x < 8; x++)
+                        {
+                            run_length |= ((uint64_t)(uint8_t)buffer[i + 1 + x]) << (8 * x);
+                        }
+                        if (run_length == 0)
+                        {
+                            throw std::runtime_error("The RLBWT file contains a run of length zero: " + file_path);
+                        }
+                        if (output_rlbwt_chars.size() > 0 && output_rlbwt_chars[output_rlbwt_chars.size() - 1] == c)
+                        {
+                            output_rlbwt_runs[output_rlbwt_runs.size() - 1] += run_length;
+                        }
+                        else
+                        {
+                            output_rlbwt_chars.push_back(c);
+                            output_rlbwt_runs.push_back(run_length);
+                        }
+                    }
+                    read_size += len;
+                }
+                if (message_paragraph >= 0 && file_size > 0)
+                {
+                    std::cout << "[END]" << std::endl;
+                }
+            }
+
+            /**
+             * @brief Write the run vectors to a file in the format read by load_RLBWT_from_RLBWT_file()
+             */
+            static void store_RLBWT_to_RLBWT_file(const std::vector<uint8_t> &rlbwt_chars, const std::vector<uint64_t> &rlbwt_runs, std::ofstream &os)
+            {
+                std::vector<char> buffer;
+                for (uint64_t i = 0; i < rlbwt_chars.size(); i++)
+                {
+                    buffer.push_back(rlbwt_chars[i]);
+                    for (uint64_t x = 0; x < 8; x++)
+                    {
+                        buffer.push_back((char)((rlbwt_runs[i] >> (8 * x)) & 255));
+                    }
+                    if (buffer.size() >= BUFFER_SIZE)
+                    {
+                        os.write(buffer.data(), buffer.size());
+                        buffer.clear();
+                    }
+                }
+                os.write(buffer.data(), buffer.size());
+            }
+        };
+    }
+}
@@ -17,10 +17,16 @@ namespace stool
 
             void update_for_deletion(uint64_t removed_position_on_text, SAIndex removed_position_on_sa, uint64_t upper_sa_value, uint64_t lower_sa_value)
             {
-                if (this->value_at_p > removed_position_on_text)
-                {
-                    this->value_at_p--;
-                }
+                this->remove_for_deletion(removed_position_on_text, removed_position_on_sa, upper_sa_value, lower_sa_value);
+                this->shrink_text(removed_position_on_text, 1);
+            }
+
+            /**
+             * @brief Update this information for the removal of a row from the BWT without shifting the SA values.
+             * @details Used while a string is deleted: the SA values keep referring to the text before the deletion until shrink_text is called once for the whole deleted range.
+             */
+            void remove_for_deletion(uint64_t removed_position_on_text, SAIndex removed_position_on_sa, uint64_t upper_sa_value, uint64_t lower_sa_value)
+            {
                 if (removed_position_on_sa < this->p)
                 {
                     this->p--;
@@ -29,18 +35,28 @@ namespace stool
                 {
                     this->value_at_p_minus = upper_sa_value;
                 }
-                if (this->value_at_p_minus > removed_position_on_text)
+                if (this->value_at_p_plus == removed_position_on_text)
                 {
-                    this->value_at_p_minus--;
+                    this->value_at_p_plus = lower_sa_value;
                 }
+            }
 
-                if (this->value_at_p_plus == removed_position_on_text)
+            /**
+             * @brief Shift the SA values for the removal of T[removed_position..removed_position+len-1] from the text.
+             */
+            void shrink_text(uint64_t removed_position, uint64_t len)
+            {
+                if (this->value_at_p != UINT64_MAX && this->value_at_p >= removed_position + len)
                 {
-                    this->value_at_p_plus = lower_sa_value;
+                    this->value_at_p -= len;
+                }
+                if (this->value_at_p_minus != UINT64_MAX && this->value_at_p_minus >= removed_position + len)
+                {
+                    this->value_at_p_minus -= len;
                 }
-                if (this->value_at_p_plus > removed_position_on_text)
+                if (this->value_at_p_plus != UINT64_MAX && this->value_at_p_plus >= removed_position + len)
                 {
-                    this->value_at_p_plus--;
+                    this->value_at_p_plus -= len;
                 }
             }
         };
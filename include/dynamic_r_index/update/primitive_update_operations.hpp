@@ -6,6 +6,8 @@
 #include "./../rlbwt_builder.hpp"
 
 #include "./additional_information_updating_r_index.hpp"
+#include "./position_information.hpp"
+#include "./r_index_update_log.hpp"
 
 namespace stool
 {
@@ -18,15 +20,26 @@ namespace stool
         class PrimitiveUpdateOperations
         {
         public:
-            static void r_replace(TextIndex x, RunPosition x_on_rlbwt, uint8_t new_char, SAValue phi_x, SAValue inv_phi_x, DynamicRLBWT &dbwt, DynamicPhi &disa)
+            template <typename RLBWT>
+            static void r_replace(TextIndex x, RunPosition x_on_rlbwt, uint8_t new_char, SAValue phi_x, SAValue inv_phi_x, RLBWT &dbwt, DynamicPhi &disa, RIndexUpdateLog *log = nullptr)
             {
+                if (log != nullptr)
+                {
+                    log->write_operation(UpdateLogOperation::Replace);
+                    log->write_value(x);
+                    log->write_value(dbwt.get_position(x_on_rlbwt.run_index, x_on_rlbwt.position_in_run));
+                    log->write_value(new_char);
+                    log->write_value(phi_x);
+                    log->write_value(inv_phi_x);
+                }
                 assert(dbwt.run_count() == disa.run_count());
                 DetailedReplacement type = DynamicRLBWTHelper::replace_char(dbwt, x_on_rlbwt, new_char);
                 disa.replace_element_for_insertion(x_on_rlbwt.run_index, phi_x, x, inv_phi_x, type);
                 assert(dbwt.run_count() == disa.run_count());
             }
 
-            static void r_insert(TextIndex u, RunPosition i_on_rlbwt, uint8_t c, SAValue value_at_i_minus, SAValue value_at_i_plus, DynamicRLBWT &dbwt, DynamicPhi &disa)
+            template <typename RLBWT>
+            static void r_insert(TextIndex u, RunPosition i_on_rlbwt, uint8_t c, SAValue value_at_i_minus, SAValue value_at_i_plus, RLBWT &dbwt, DynamicPhi &disa)
             {
 
                 auto pair = DynamicRLBWTHelper::compute_insertion_type_and_position(dbwt, i_on_rlbwt, c);
@@ -34,27 +47,100 @@ namespace stool
                 disa.insert_element_for_insertion(pair.second.run_index, value_at_i_minus, u, value_at_i_plus, pair.first);
                 assert(dbwt.run_count() == disa.run_count());
             }
-            static void r_insert(TextIndex u, uint64_t i, uint8_t c, SAValue value_at_i_minus, SAValue value_at_i_plus, DynamicRLBWT &dbwt, DynamicPhi &disa)
+            template <typename RLBWT>
+            static void r_insert(TextIndex u, uint64_t i, uint8_t c, SAValue value_at_i_minus, SAValue value_at_i_plus, RLBWT &dbwt, DynamicPhi &disa, RIndexUpdateLog *log = nullptr)
             {
+                if (log != nullptr)
+                {
+                    log->write_operation(UpdateLogOperation::Insert);
+                    log->write_value(u);
+                    log->write_value(i);
+                    log->write_value(c);
+                    log->write_value(value_at_i_minus);
+                    log->write_value(value_at_i_plus);
+                }
                 RunPosition i_on_rlbwt = dbwt.to_run_position(i, true);
                 r_insert(u, i_on_rlbwt, c, value_at_i_minus, value_at_i_plus, dbwt, disa);
             }
 
-            static std::pair<SAValue, SAValue> r_delete(RunPosition u_on_rlbwt, uint8_t u_c, SAValue phi_u, SAValue inv_phi_u, DynamicRLBWT &dbwt, DynamicPhi &disa)
+            template <typename RLBWT>
+            static std::pair<SAValue, SAValue> r_delete(RunPosition u_on_rlbwt, uint8_t u_c, SAValue phi_u, SAValue inv_phi_u, RLBWT &dbwt, DynamicPhi &disa)
             {
 
                 RunRemovalType type = DynamicRLBWTHelper::remove_char(dbwt, u_on_rlbwt, u_c);
                 disa.remove_element_for_insertion(u_on_rlbwt.run_index, phi_u, inv_phi_u, type);
                 return std::make_pair(phi_u, inv_phi_u);
             }
-            static std::pair<SAValue, SAValue> r_delete_for_deletion(RunPosition u_on_rlbwt, uint8_t u_c, SAValue phi_u, SAValue inv_phi_u, uint64_t remove_value, DynamicRLBWT &dbwt, DynamicPhi &disa)
+            /**
+             * @brief Move the row \p y_on_rlbwt (whose character is \p y_char) to the position \p z, where \p z is a position of the BWT after the row is removed
+             * @details This is equivalent to r_delete followed by r_insert.
+             * If the row stays inside its run (i.e., the run has at least two rows and \p z is a position of the run after the removal), the BWT is unchanged.
+             * In this case, the RLBWT is not updated at all, and at most one sampled SA value is replaced in each of the two sampled arrays of the dynamic phi.
+             * @param y The position of the moved row before the move
+             * @param y_PI The SA values of the moved row and its neighbors
+             * @param z_PI The insertion position and the SA values around it
+             * @return true if the move has been performed without updating the RLBWT
+             */
+            template <typename RLBWT>
+            static bool r_move(SAIndex y, RunPosition y_on_rlbwt, uint8_t y_char, const PositionInformation &y_PI, const PositionInformation &z_PI, RLBWT &dbwt, DynamicPhi &disa, RIndexUpdateLog *log = nullptr)
             {
+                if (log != nullptr)
+                {
+                    log->write_operation(UpdateLogOperation::Move);
+                    log->write_value(y);
+                    log->write_value(y_char);
+                    log->write_value(y_PI.value_at_p);
+                    log->write_value(y_PI.value_at_p_minus);
+                    log->write_value(y_PI.value_at_p_plus);
+                    log->write_value(z_PI.p);
+                    log->write_value(z_PI.value_at_p_minus);
+                    log->write_value(z_PI.value_at_p_plus);
+                }
+                uint64_t run_length = dbwt.get_run_length(y_on_rlbwt.run_index);
+                uint64_t run_start = y - y_on_rlbwt.position_in_run;
+                if (run_length >= 2 && run_start <= z_PI.p && z_PI.p < run_start + run_length)
+                {
+                    disa.move_element_in_run(y_on_rlbwt.run_index, run_length, y_on_rlbwt.position_in_run, z_PI.p - run_start, y_PI.value_at_p, y_PI.value_at_p_minus, y_PI.value_at_p_plus);
+                    assert(dbwt.run_count() == disa.run_count());
+                    return true;
+                }
+                else
+                {
+                    r_delete(y_on_rlbwt, y_char, y_PI.value_at_p_minus, y_PI.value_at_p_plus, dbwt, disa);
+                    r_insert(y_PI.value_at_p, z_PI.p, y_char, z_PI.value_at_p_minus, z_PI.value_at_p_plus, dbwt, disa);
+                    return false;
+                }
+            }
+            template <typename RLBWT>
+            static std::pair<SAValue, SAValue> r_delete_for_deletion(RunPosition u_on_rlbwt, uint8_t u_c, SAValue phi_u, SAValue inv_phi_u, RLBWT &dbwt, DynamicPhi &disa, RIndexUpdateLog *log = nullptr)
+            {
+                if (log != nullptr)
+                {
+                    log->write_operation(UpdateLogOperation::DeleteForDeletion);
+                    log->write_value(dbwt.get_position(u_on_rlbwt.run_index, u_on_rlbwt.position_in_run));
+                    log->write_value(u_c);
+                    log->write_value(phi_u);
+                    log->write_value(inv_phi_u);
+                }
 
                 RunRemovalType type = DynamicRLBWTHelper::remove_char(dbwt, u_on_rlbwt, u_c);
                 disa.remove_element_for_insertion(u_on_rlbwt.run_index, phi_u, inv_phi_u, type);
-                disa.shrink_text(remove_value);
                 return std::make_pair(phi_u, inv_phi_u);
             }
+
+            /**
+             * @brief Shift the sampled SA values for the removal of T[u..u+len-1], after the rows of the removed suffixes have been removed by r_delete_for_deletion
+             */
+            static void r_shrink_text(TextIndex u, uint64_t len, DynamicPhi &disa, RIndexUpdateLog *log = nullptr)
+            {
+                if (log != nullptr)
+                {
+                    log->write_operation(UpdateLogOperation::ShrinkText);
+                    log->write_value(u);
+                    log->write_value(len);
+                }
+                disa.shrink_text(u, len);
+            }
         };
     }
 }
\ No newline at end of file
@@ -36,13 +36,14 @@ namespace stool
         {
 
         public:
-            static PreprocessingResultForInsertion phase_AB_for_insertion(TextIndex i, const std::vector<uint8_t> &inserted_string, FMIndexEditHistory &editHistory, DynamicRLBWT &dbwt, DynamicPhi &disa)
+            template <typename RLBWT>
+            static PreprocessingResultForInsertion phase_AB_for_insertion(TextIndex i, const std::vector<uint8_t> &inserted_string, FMIndexEditHistory &editHistory, RLBWT &dbwt, DynamicPhi &disa, RIndexUpdateLog *log = nullptr, SAIndex isa_of_i = UINT64_MAX)
             {
                 uint8_t prev_c = inserted_string[inserted_string.size() - 1];
 
                 PreprocessingResultForInsertion result;
                 uint64_t original_text_size = dbwt.text_size();
-                result.ISA_i_PI.p = disa.isa(i, dbwt);
+                result.ISA_i_PI.p = isa_of_i != UINT64_MAX ? isa_of_i : disa.isa(i, dbwt);
                 RunPosition i_on_rlbwt = dbwt.to_run_position(result.ISA_i_PI.p);
                 result.value_at_y_minus = disa.phi(i > 0 ? i - 1 : original_text_size - 1);
                 result.value_at_y_plus = disa.inverse_phi(i > 0 ? i - 1 : original_text_size - 1);
@@ -52,7 +53,7 @@ namespace stool
                 result.ISA_i_PI.value_at_p_minus = disa.phi(i);
                 result.ISA_i_PI.value_at_p_plus = disa.inverse_phi(i);
 
-                PrimitiveUpdateOperations::r_replace(i, i_on_rlbwt, prev_c, result.ISA_i_PI.value_at_p_minus, result.ISA_i_PI.value_at_p_plus, dbwt, disa);
+                PrimitiveUpdateOperations::r_replace(i, i_on_rlbwt, prev_c, result.ISA_i_PI.value_at_p_minus, result.ISA_i_PI.value_at_p_plus, dbwt, disa, log);
                 // result.ISA_i_PI.p_on_rlbwt = dbwt.to_run_position(result.ISA_i_PI.p_on_sa);
 
                 editHistory.replaced_sa_index = result.ISA_i_PI.p;
@@ -60,7 +61,8 @@ namespace stool
 
                 return result;
             }
-            static AdditionalInformationUpdatingRIndex phase_C_for_insertion(TextIndex i, const std::vector<uint8_t> &inserted_string, FMIndexEditHistory &editHistory, DynamicRLBWT &dbwt, DynamicPhi &disa, const PreprocessingResultForInsertion &phaseABResult)
+            template <typename RLBWT>
+            static AdditionalInformationUpdatingRIndex phase_C_for_insertion(TextIndex i, const std::vector<uint8_t> &inserted_string, FMIndexEditHistory &editHistory, RLBWT &dbwt, DynamicPhi &disa, const PreprocessingResultForInsertion &phaseABResult, RIndexUpdateLog *log = nullptr)
             {
                 PositionInformation current_ISA_i_PI = phaseABResult.ISA_i_PI;
                 SAValue current_value_at_y_plus = phaseABResult.value_at_y_plus;
@@ -73,25 +75,32 @@ namespace stool
                 SAValue final_value_at_y_plus = UINT64_MAX;
                 SAValue final_value_at_y_minus = UINT64_MAX;
 
-                for (uint64_t k = 0; k < inserted_string.size(); k++)
+                // Shift the sampled SA values by |inserted_string| at once
                 {
-                    disa.extend_text(i);
+                    uint64_t m = inserted_string.size();
+                    disa.extend_text(i, m);
+                    if (log != nullptr)
+                    {
+                        log->write_operation(UpdateLogOperation::ExtendText);
+                        log->write_value(i);
+                        log->write_value(m);
+                    }
                     if (current_ISA_i_PI.value_at_p_plus >= i)
                     {
-                        current_ISA_i_PI.value_at_p_plus++;
+                        current_ISA_i_PI.value_at_p_plus += m;
                     }
                     if (current_ISA_i_PI.value_at_p_minus >= i)
                     {
-                        current_ISA_i_PI.value_at_p_minus++;
+                        current_ISA_i_PI.value_at_p_minus += m;
                     }
 
                     if (current_value_at_y_plus >= i)
                     {
-                        current_value_at_y_plus++;
+                        current_value_at_y_plus += m;
                     }
                     if (current_value_at_y_minus >= i)
                     {
-                        current_value_at_y_minus++;
+                        current_value_at_y_minus += m;
                     }
                 }
 
@@ -121,7 +130,7 @@ namespace stool
                     const uint64_t ins_character = w + 1 < inserted_string.size() ? inserted_string[inserted_string.size() - w - 2] : phaseABResult.old_char;
                     uint64_t insert_sa_value = i + inserted_string.size() - w - 1;
 
-                    PrimitiveUpdateOperations::r_insert(insert_sa_value, next_x_PI.p, ins_character, next_x_PI.value_at_p_minus, next_x_PI.value_at_p_plus, dbwt, disa);
+                    PrimitiveUpdateOperations::r_insert(insert_sa_value, next_x_PI.p, ins_character, next_x_PI.value_at_p_minus, next_x_PI.value_at_p_plus, dbwt, disa, log);
 
                     // Update positions and sa-values.
                     {
@@ -225,20 +234,22 @@ namespace stool
                 return inf;
             }
 
-            static AdditionalInformationUpdatingRIndex preprocess_of_string_insertion_operation(TextIndex i, const std::vector<uint8_t> &inserted_string, FMIndexEditHistory &editHistory, DynamicRLBWT &dbwt, DynamicPhi &disa)
+            template <typename RLBWT>
+            static AdditionalInformationUpdatingRIndex preprocess_of_string_insertion_operation(TextIndex i, const std::vector<uint8_t> &inserted_string, FMIndexEditHistory &editHistory, RLBWT &dbwt, DynamicPhi &disa, RIndexUpdateLog *log = nullptr, SAIndex isa_of_i = UINT64_MAX)
             {
-                PreprocessingResultForInsertion phaseABResult = phase_AB_for_insertion(i, inserted_string, editHistory, dbwt, disa);
-                return phase_C_for_insertion(i, inserted_string, editHistory, dbwt, disa, phaseABResult);
+                PreprocessingResultForInsertion phaseABResult = phase_AB_for_insertion(i, inserted_string, editHistory, dbwt, disa, log, isa_of_i);
+                return phase_C_for_insertion(i, inserted_string, editHistory, dbwt, disa, phaseABResult, log);
             }
 
-            static bool phase_D(FMIndexEditHistory &editHistory, DynamicRLBWT &dbwt, DynamicPhi &disa, PositionInformation &y_PI, PositionInformation &z_PI)
+            template <typename RLBWT>
+            static bool phase_D(FMIndexEditHistory &editHistory, RLBWT &dbwt, DynamicPhi &disa, PositionInformation &y_PI, PositionInformation &z_PI, RIndexUpdateLog *log = nullptr)
             {
 
                 if (y_PI.p != z_PI.p)
                 {
 
                     editHistory.move_history.push_back(SAMove(y_PI.p, z_PI.p));
-                    RIndexHelperForUpdate::phase_D_iteration(dbwt, disa, y_PI, z_PI);
+                    RIndexHelperForUpdate::phase_D_iteration(dbwt, disa, y_PI, z_PI, log);
 
                     return false;
                 }
@@ -247,23 +258,25 @@ namespace stool
                     return true;
                 }
             }
-            static AdditionalInformationUpdatingRIndex preprocess_of_string_deletion_operation(TextIndex u, int64_t len, FMIndexEditHistory &editHistory, DynamicRLBWT &dbwt, DynamicPhi &disa, std::vector<std::vector<uint64_t>> *sa_arrays_for_debug)
+            template <typename RLBWT>
+            static AdditionalInformationUpdatingRIndex preprocess_of_string_deletion_operation(TextIndex u, int64_t len, FMIndexEditHistory &editHistory, RLBWT &dbwt, DynamicPhi &disa, std::vector<std::vector<uint64_t>> *sa_arrays_for_debug, RIndexUpdateLog *log = nullptr, SAIndex isa_of_v = UINT64_MAX)
             {
                 if (len < 1)
                 {
                     throw std::logic_error("The length of the deleted substring is at least 1.");
                 }
-                PreprocessingResultForDeletion phaseABResult = phase_AB_for_deletion(u, len, editHistory, dbwt, disa);
-                return phase_C_for_deletion(u, len, editHistory, dbwt, disa, phaseABResult, sa_arrays_for_debug);
+                PreprocessingResultForDeletion phaseABResult = phase_AB_for_deletion(u, len, editHistory, dbwt, disa, isa_of_v);
+                return phase_C_for_deletion(u, len, editHistory, dbwt, disa, phaseABResult, sa_arrays_for_debug, log);
             }
 
         private:
-            static PreprocessingResultForDeletion phase_AB_for_deletion(TextIndex u, uint64_t len, FMIndexEditHistory &editHistory, DynamicRLBWT &dbwt, DynamicPhi &disa)
+            template <typename RLBWT>
+            static PreprocessingResultForDeletion phase_AB_for_deletion(TextIndex u, uint64_t len, FMIndexEditHistory &editHistory, RLBWT &dbwt, DynamicPhi &disa, SAIndex isa_of_v = UINT64_MAX)
             {
                 PreprocessingResultForDeletion inf;
 
                 inf.ISA_v_PI.value_at_p = u + len;
-                inf.ISA_v_PI.p = disa.isa(inf.ISA_v_PI.value_at_p, dbwt);
+                inf.ISA_v_PI.p = isa_of_v != UINT64_MAX ? isa_of_v : disa.isa(inf.ISA_v_PI.value_at_p, dbwt);
                 inf.ISA_v_PI.value_at_p_minus = disa.phi(inf.ISA_v_PI.value_at_p);
                 inf.ISA_v_PI.value_at_p_plus = disa.inverse_phi(inf.ISA_v_PI.value_at_p);
 
@@ -296,7 +309,8 @@ namespace stool
 
                 return inf;
             }
-            static AdditionalInformationUpdatingRIndex phase_C_for_deletion(TextIndex u, int64_t len, FMIndexEditHistory &editHistory, DynamicRLBWT &dbwt, DynamicPhi &disa, const PreprocessingResultForDeletion &phaseABResult, std::vector<std::vector<uint64_t>> *sa_arrays_for_debug)
+            template <typename RLBWT>
+            static AdditionalInformationUpdatingRIndex phase_C_for_deletion(TextIndex u, int64_t len, FMIndexEditHistory &editHistory, RLBWT &dbwt, DynamicPhi &disa, const PreprocessingResultForDeletion &phaseABResult, std::vector<std::vector<uint64_t>> *sa_arrays_for_debug, RIndexUpdateLog *log = nullptr)
             {
 
                 PositionInformation ISA_u_minus_PI = phaseABResult.ISA_u_minus_PI;
@@ -306,7 +320,7 @@ namespace stool
                 SAValue inv_phi_x = disa.inverse_phi(u + len - 1);
 
                 RunPosition v_on_rlbwt = dbwt.to_run_position(ISA_v_PI.p);
-                PrimitiveUpdateOperations::r_replace(u+len, v_on_rlbwt, phaseABResult.new_char, ISA_v_PI.value_at_p_minus, ISA_v_PI.value_at_p_plus, dbwt, disa);
+                PrimitiveUpdateOperations::r_replace(u+len, v_on_rlbwt, phaseABResult.new_char, ISA_v_PI.value_at_p_minus, ISA_v_PI.value_at_p_plus, dbwt, disa, log);
 
                 uint64_t current_x = phaseABResult.LF_v;
                 RunPosition x_on_rlbwt = dbwt.to_run_position(current_x);
@@ -336,6 +350,8 @@ namespace stool
                     }
                 }
 
+                // The SA values keep referring to the text before the deletion during this loop,
+                // and they are shifted once after the loop (see shrink_text below).
                 uint64_t counter = 0;
                 for (int64_t w = len - 1; w >= 0; w--)
                 {
@@ -348,24 +364,14 @@ namespace stool
                         next_x--;
                     }
 
-                    SAValue next_phi_x = disa.LF_phi_for_deletion(x_on_rlbwt, phi_x, dbwt, current_x, next_x, u + w + 1, ISA_v_PI.value_at_p_minus);
+                    SAValue next_phi_x = disa.LF_phi_for_deletion(x_on_rlbwt, phi_x, dbwt, current_x, next_x, u + len, ISA_v_PI.value_at_p_minus);
 
-                    SAValue next_inv_phi_x = disa.LF_inverse_phi_for_deletion(x_on_rlbwt, inv_phi_x, dbwt, current_x, next_x, u + w + 1, ISA_v_PI.value_at_p_plus);
+                    SAValue next_inv_phi_x = disa.LF_inverse_phi_for_deletion(x_on_rlbwt, inv_phi_x, dbwt, current_x, next_x, u + len, ISA_v_PI.value_at_p_plus);
 
-                    PrimitiveUpdateOperations::r_delete_for_deletion(x_on_rlbwt, x_character, phi_x, inv_phi_x, u + w, dbwt, disa);
-
-                    if (next_phi_x > u + w)
-                    {
-                        next_phi_x--;
-                    }
-                    if (next_inv_phi_x > u + w)
-                    {
-                        next_inv_phi_x--;
-                    }
+                    PrimitiveUpdateOperations::r_delete_for_deletion(x_on_rlbwt, x_character, phi_x, inv_phi_x, dbwt, disa, log);
 
-
-                    ISA_u_minus_PI.update_for_deletion(u + w, current_x, phi_x, inv_phi_x);
-                    ISA_v_PI.update_for_deletion(u + w, current_x, phi_x, inv_phi_x);
+                    ISA_u_minus_PI.remove_for_deletion(u + w, current_x, phi_x, inv_phi_x);
+                    ISA_v_PI.remove_for_deletion(u + w, current_x, phi_x, inv_phi_x);
 
                     counter++;
 
@@ -375,6 +381,9 @@ namespace stool
                     {
                         uint64_t debug_phi_x = next_x > 0 ? (*sa_arrays_for_debug)[counter][next_x - 1] : (*sa_arrays_for_debug)[counter][(*sa_arrays_for_debug)[counter].size() - 1];
                         uint64_t debug_inv_phi_x = next_x + 1 < dbwt.size() ? (*sa_arrays_for_debug)[counter][next_x + 1] : (*sa_arrays_for_debug)[counter][0];
+                        // The debug arrays are shifted after each deleted character.
+                        debug_phi_x = debug_phi_x >= u + len - counter ? debug_phi_x + counter : debug_phi_x;
+                        debug_inv_phi_x = debug_inv_phi_x >= u + len - counter ? debug_inv_phi_x + counter : debug_inv_phi_x;
                         if (next_phi_x != debug_phi_x)
                         {
                             stool::DebugPrinter::print_integers((*sa_arrays_for_debug)[counter]);
@@ -398,6 +407,10 @@ namespace stool
                     }
                 }
 
+                PrimitiveUpdateOperations::r_shrink_text(u, len, disa, log);
+                ISA_u_minus_PI.shrink_text(u, len);
+                ISA_v_PI.shrink_text(u, len);
+
                 //RunPosition v_on_rlbwt = dbwt.to_run_position(ISA_v_PI.p);
                 //PrimitiveUpdateOperations::r_replace(u, v_on_rlbwt, phaseABResult.new_char, ISA_v_PI.value_at_p_minus, ISA_v_PI.value_at_p_plus, dbwt, disa);
 
@@ -421,7 +434,8 @@ namespace stool
                 return inf;
             }
 
-            static void phase_D_iteration(DynamicRLBWT &dbwt, DynamicPhi &disa, PositionInformation &y_PI, PositionInformation &z_PI)
+            template <typename RLBWT>
+            static void phase_D_iteration(RLBWT &dbwt, DynamicPhi &disa, PositionInformation &y_PI, PositionInformation &z_PI, RIndexUpdateLog *log = nullptr)
             {
 
 #ifdef TIME_DEBUG
@@ -439,8 +453,7 @@ namespace stool
                 next_y_PI.value_at_p_plus = disa.LF_inverse_phi_for_move(y_on_rlbwt, y_PI.value_at_p_plus, dbwt);
                 next_y_PI.value_at_p = y_PI.value_at_p > 0 ? y_PI.value_at_p - 1 : dbwt.text_size() - 1;
 
-                PrimitiveUpdateOperations::r_delete(y_on_rlbwt, y_char, y_PI.value_at_p_minus, y_PI.value_at_p_plus, dbwt, disa);
-                PrimitiveUpdateOperations::r_insert(y_PI.value_at_p, z_PI.p, y_char, z_PI.value_at_p_minus, z_PI.value_at_p_plus, dbwt, disa);
+                PrimitiveUpdateOperations::r_move(y_PI.p, y_on_rlbwt, y_char, y_PI, z_PI, dbwt, disa, log);
 
                 RunPosition z_on_rlbwt = dbwt.to_run_position(z_PI.p);
 
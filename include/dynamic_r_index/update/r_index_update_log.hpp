@@ -0,0 +1,250 @@
+#pragma once
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include "../../dynamic_fm_index/tools.hpp"
+
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+        /**
+         * @brief The types of the records stored in RIndexUpdateLog
+         * \ingroup DynamicRIndexes
+         */
+        enum class UpdateLogOperation : uint8_t
+        {
+            Replace = 1,           ///< PrimitiveUpdateOperations::r_replace
+            Insert = 2,            ///< PrimitiveUpdateOperations::r_insert
+            DeleteForDeletion = 3, ///< PrimitiveUpdateOperations::r_delete_for_deletion
+            Move = 4,              ///< PrimitiveUpdateOperations::r_move
+            ExtendText = 5,        ///< DynamicPhi::extend_text
+            MergeRuns = 6,         ///< A merge of two adjacent runs performed by the run compaction
+            ExtendAlphabet = 7,    ///< DynamicRLBWT::extend_alphabet
+            Rebuild = 8,           ///< A rebuild of the index from the edited text
+            Checksum = 9,          ///< The hash of the RLBWT after an update (see DynamicRIndex::compute_RLBWT_hash())
+            ShrinkText = 10        ///< PrimitiveUpdateOperations::r_shrink_text
+        };
+
+        /**
+         * @brief A compact binary log of the primitive operations performed by updates of a dynamic r-index
+         * @details The log starts with a version byte (VERSION). Each record consists of an operation byte (UpdateLogOperation) followed by its arguments, and each argument is encoded as a variable-length integer (7 bits per byte).
+         * The arguments are the values computed by the updated index (positions on the BWT, characters, and SA values), and hence
+         * a replica can apply the log by DynamicRIndex::apply_update_log() without computing LF, phi, or ISA.
+         * Each update is followed by a Checksum record, by which the replica detects that it has diverged from the recorded index.
+         * @note A Rebuild record stores the edit (the position, the deleted length, and the inserted string), and the replica rebuilds its index from the edited text.
+         * \ingroup DynamicRIndexes
+         */
+        class RIndexUpdateLog
+        {
+        public:
+            /**
+             * @brief The version of the log format, which is stored in the first byte of the log
+             */
+            static inline constexpr uint8_t VERSION = 2;
+
+            /**
+             * @brief The maximum number of bytes of an encoded 64-bit integer
+             */
+            static inline constexpr uint64_t MAX_VALUE_BYTES = 10;
+
+        private:
+            std::vector<uint8_t> bytes = {VERSION};
+
+        public:
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Properties
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Return the size of the log in bytes (including the version byte)
+             */
+            uint64_t size() const
+            {
+                return this->bytes.size();
+            }
+
+            /**
+             * @brief Return the log as a byte vector
+             */
+            const std::vector<uint8_t> &get_bytes() const
+            {
+                return this->bytes;
+            }
+
+            /**
+             * @brief Remove all the records, keeping the version byte
+             */
+            void clear()
+            {
+                this->bytes.clear();
+                this->bytes.push_back(VERSION);
+            }
+
+            void swap(RIndexUpdateLog &item)
+            {
+                this->bytes.swap(item.bytes);
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Writers
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            void write_operation(UpdateLogOperation op)
+            {
+                this->bytes.push_back((uint8_t)op);
+            }
+
+            /**
+             * @brief Append an integer encoded with 7 bits per byte (the highest bit indicates that the next byte follows)
+             */
+            void write_value(uint64_t value)
+            {
+                while (value >= 128)
+                {
+                    this->bytes.push_back((uint8_t)((value & 127) | 128));
+                    value >>= 7;
+                }
+                this->bytes.push_back((uint8_t)value);
+            }
+
+            void write_string(const std::vector<uint8_t> &str)
+            {
+                this->write_value(str.size());
+                this->bytes.insert(this->bytes.end(), str.begin(), str.end());
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Readers
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Read the version byte at \p pos and advance \p pos
+             * @throws std::runtime_error if the log is empty or was written in another version of the format
+             */
+            void read_version(uint64_t &pos) const
+            {
+                if (pos >= this->bytes.size())
+                {
+                    throw std::runtime_error("RIndexUpdateLog: unexpected end of the log");
+                }
+                uint8_t version = this->bytes[pos++];
+                if (version != VERSION)
+                {
+                    throw std::runtime_error("RIndexUpdateLog: unsupported version " + std::to_string(version) + " (expected " + std::to_string(VERSION) + ")");
+                }
+            }
+
+            /**
+             * @brief Read the operation byte at \p pos and advance \p pos
+             * @throws std::runtime_error if the byte is not a valid operation
+             */
+            UpdateLogOperation read_operation(uint64_t &pos) const
+            {
+                if (pos >= this->bytes.size())
+                {
+                    throw std::runtime_error("RIndexUpdateLog: unexpected end of the log");
+                }
+                uint8_t op = this->bytes[pos++];
+                if (op < (uint8_t)UpdateLogOperation::Replace || op > (uint8_t)UpdateLogOperation::ShrinkText)
+                {
+                    throw std::runtime_error("RIndexUpdateLog: invalid operation " + std::to_string(op));
+                }
+                return (UpdateLogOperation)op;
+            }
+
+            /**
+             * @brief Read the integer at \p pos and advance \p pos
+             * @throws std::runtime_error if the log ends in the integer, or the integer does not fit in 64 bits (more than MAX_VALUE_BYTES bytes)
+             */
+            uint64_t read_value(uint64_t &pos) const
+            {
+                uint64_t value = 0;
+                for (uint64_t shift = 0; shift < 64; shift += 7)
+                {
+                    if (pos >= this->bytes.size())
+                    {
+                        throw std::runtime_error("RIndexUpdateLog: unexpected end of the log");
+                    }
+                    uint8_t b = this->bytes[pos++];
+                    uint64_t payload = b & 127;
+                    if (shift == 63 && payload > 1)
+                    {
+                        throw std::runtime_error("RIndexUpdateLog: the integer does not fit in 64 bits");
+                    }
+                    value |= payload << shift;
+                    if (b < 128)
+                    {
+                        return value;
+                    }
+                }
+                throw std::runtime_error("RIndexUpdateLog: the integer is longer than " + std::to_string(MAX_VALUE_BYTES) + " bytes");
+            }
+
+            std::vector<uint8_t> read_string(uint64_t &pos) const
+            {
+                uint64_t len = this->read_value(pos);
+                if (pos + len > this->bytes.size())
+                {
+                    throw std::runtime_error("RIndexUpdateLog: unexpected end of the log");
+                }
+                std::vector<uint8_t> r(this->bytes.begin() + pos, this->bytes.begin() + pos + len);
+                pos += len;
+                return r;
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Load, save, and builder functions
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Build a log from the bytes returned by get_bytes()
+             * @note The version byte is checked when the log is read (see read_version())
+             */
+            static RIndexUpdateLog build(const std::vector<uint8_t> &bytes)
+            {
+                RIndexUpdateLog r;
+                r.bytes = bytes;
+                return r;
+            }
+
+            static void store_to_file(const RIndexUpdateLog &item, std::ofstream &os)
+            {
+                uint64_t size = item.bytes.size();
+                os.write(reinterpret_cast<const char *>(&size), sizeof(uint64_t));
+                os.write(reinterpret_cast<const char *>(item.bytes.data()), size);
+            }
+
+            /**
+             * @brief Load a log written by store_to_file()
+             * @throws std::runtime_error if the stream ends before the log
+             */
+            static RIndexUpdateLog load_from_file(std::ifstream &ifs)
+            {
+                uint64_t size = 0;
+                ifs.read(reinterpret_cast<char *>(&size), sizeof(uint64_t));
+                if (!ifs || ifs.gcount() != (std::streamsize)sizeof(uint64_t))
+                {
+                    throw std::runtime_error("RIndexUpdateLog: cannot read the size of the log");
+                }
+                RIndexUpdateLog r;
+                r.bytes.resize(size);
+                ifs.read(reinterpret_cast<char *>(r.bytes.data()), size);
+                if (!ifs || (uint64_t)ifs.gcount() != size)
+                {
+                    throw std::runtime_error("RIndexUpdateLog: the log is truncated");
+                }
+                return r;
+            }
+            //@}
+        };
+    }
+}
@@ -0,0 +1,341 @@
+#pragma once
+#include "./dynamic_r_index.hpp"
+namespace stool
+{
+    namespace dynamic_r_index
+    {
+
+        /**
+         * @brief Compatibility shim indexing a text over an integer alphabet (e.g., word IDs stored as uint16_t or uint32_t) with the byte-level dynamic r-index
+         *
+         * @warning This is not a word-level index. The encoded text is \p w times longer than the symbol text (w = 3 to 5), and its BWT usually has more runs than the BWT of the symbol text,
+         * so this index takes several times the memory of a native integer-alphabet index, and each update and query performs \p w times as many steps.
+         * A native index requires the dynamic RLBWT and the C array to be templated on the symbol type.
+         *
+         * The dynamic RLBWT stores its characters in a byte-wise dynamic wavelet tree.
+         * This class therefore represents each symbol \p s as a fixed-width sequence of \p w bytes (the base-127 digits of \p s with the most significant digit first),
+         * and stores the encoded text in a DynamicRIndex:
+         * - The first byte of each symbol is taken from [128, 255], and the other bytes are taken from [1, 127]. The byte 0 is the end marker.
+         * - Since a first byte occurs only at the beginning of a symbol, every occurrence of an encoded pattern starts at a symbol boundary, and count queries need no filtering.
+         * - The encoding preserves the order of symbols, so the SA of the encoded text restricted to symbol boundaries is the SA of the original text.
+         *
+         * @tparam SYMBOL The unsigned integer type of symbols
+         * @note The width \p w is the smallest integer satisfying max_symbol < 128 * 127^{w-1}; it is 3 for every uint16_t symbol.
+         * The width is fixed rather than variable, because the symbol position \p i is then the byte position \p i w, and updates and locate queries need no position map.
+         * \ingroup StringIndexes
+         * \ingroup DynamicRIndexes
+         */
+        template <typename SYMBOL = uint32_t>
+        class IntegerAlphabetDynamicRIndex
+        {
+            static inline constexpr uint64_t HEAD_BYTE_OFFSET = 128;
+            static inline constexpr uint64_t HEAD_BASE = 128;
+            static inline constexpr uint64_t TAIL_BYTE_OFFSET = 1;
+            static inline constexpr uint64_t TAIL_BASE = 127;
+
+            DynamicRIndex index;
+            uint64_t symbol_width = 1;
+
+        public:
+            IntegerAlphabetDynamicRIndex()
+            {
+            }
+            IntegerAlphabetDynamicRIndex &operator=(const IntegerAlphabetDynamicRIndex &) = delete;
+            IntegerAlphabetDynamicRIndex(IntegerAlphabetDynamicRIndex &&) noexcept = default;
+            IntegerAlphabetDynamicRIndex &operator=(IntegerAlphabetDynamicRIndex &&) noexcept = default;
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Properties
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Get the number of symbols in the indexed text (excluding the end marker)
+             */
+            uint64_t size() const
+            {
+                return (this->index.size() - 1) / this->symbol_width;
+            }
+
+            /**
+             * @brief Get the number of bytes used to represent a symbol
+             */
+            uint64_t get_symbol_width() const
+            {
+                return this->symbol_width;
+            }
+
+            /**
+             * @brief Get the smallest symbol which cannot be stored in this index
+             */
+            uint64_t get_symbol_capacity() const
+            {
+                return IntegerAlphabetDynamicRIndex::compute_symbol_capacity(this->symbol_width);
+            }
+
+            /**
+             * @brief Get the underlying dynamic r-index of the encoded text
+             */
+            const DynamicRIndex &get_r_index() const
+            {
+                return this->index;
+            }
+
+            /**
+             * @brief Get the original text as a vector of symbols (excluding the end marker)
+             */
+            std::vector<SYMBOL> get_text() const
+            {
+                std::vector<uint8_t> encoded_text = this->index.get_text();
+                encoded_text.pop_back();
+                return this->decode(encoded_text);
+            }
+
+            uint64_t run_count() const
+            {
+                return this->index.run_count();
+            }
+
+            uint64_t size_in_bytes() const
+            {
+                return sizeof(this->symbol_width) + this->index.size_in_bytes();
+            }
+
+            void swap(IntegerAlphabetDynamicRIndex &item)
+            {
+                this->index.swap(item.index);
+                std::swap(this->symbol_width, item.symbol_width);
+            }
+
+            void verify(int mode = 0) const
+            {
+                this->index.verify(mode);
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Queries
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Count the number of occurrences of a pattern
+             * @note Time complexity: O(wm log σ log n) where m is pattern length
+             */
+            uint64_t count_query(const std::vector<SYMBOL> &pattern) const
+            {
+                return this->index.count_query(this->encode(pattern));
+            }
+
+            /**
+             * @brief Find all occurrence positions of a pattern
+             * @return Vector of occurrence positions in the original text
+             */
+            std::vector<uint64_t> locate_query(const std::vector<SYMBOL> &pattern) const
+            {
+                std::vector<uint64_t> r = this->index.locate_query(this->encode(pattern));
+                for (uint64_t &p : r)
+                {
+                    assert(p % this->symbol_width == 0);
+                    p /= this->symbol_width;
+                }
+                return r;
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Updates
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Insert a string at a given position
+             * @param u The symbol position to insert at (0-indexed)
+             * @param inserted_string The string to insert
+             * @return The number of BWT reorder operations performed
+             * @throws std::runtime_error if a symbol cannot be represented with the symbol width of this index
+             */
+            uint64_t insert_string(uint64_t u, const std::vector<SYMBOL> &inserted_string)
+            {
+                if (u > this->size())
+                {
+                    throw std::logic_error("The insertion position must be at most the length of the text.");
+                }
+                return this->index.insert_string(u * this->symbol_width, this->encode(inserted_string));
+            }
+
+            /**
+             * @brief Insert a symbol at a given position
+             */
+            uint64_t insert_char(uint64_t u, SYMBOL c)
+            {
+                std::vector<SYMBOL> inserted_string = {c};
+                return this->insert_string(u, inserted_string);
+            }
+
+            /**
+             * @brief Delete a substring from the text
+             * @param u The starting symbol position of the substring to delete (0-indexed)
+             * @param len The number of deleted symbols
+             * @return The number of BWT reorder operations performed
+             * @throws std::logic_error if len < 1 or u + len > size()
+             * @note The bounds are checked on symbol positions before they are converted to byte positions, so that the conversion cannot overflow.
+             */
+            uint64_t delete_string(uint64_t u, uint64_t len)
+            {
+                if (len < 1)
+                {
+                    throw std::logic_error("The length of the deleted substring is at least 1.");
+                }
+                if (u > this->size() || len > this->size() - u)
+                {
+                    throw std::logic_error("The ending position of the deleted substring must be less than the ending position of the text.");
+                }
+                return this->index.delete_string(u * this->symbol_width, len * this->symbol_width);
+            }
+
+            /**
+             * @brief Delete a symbol from the text
+             */
+            uint64_t delete_char(uint64_t u)
+            {
+                return this->delete_string(u, 1);
+            }
+            //@}
+
+            ////////////////////////////////////////////////////////////////////////////////
+            ///   @name Load, save, and builder functions
+            ////////////////////////////////////////////////////////////////////////////////
+            //@{
+
+            /**
+             * @brief Build the index of a text over an integer alphabet
+             * @param text The text (without an end marker)
+             * @param max_symbol The largest symbol that can be inserted into the index later
+             * @param message_paragraph Message indentation level for progress output
+             */
+            static IntegerAlphabetDynamicRIndex build_from_text(const std::vector<SYMBOL> &text, uint64_t max_symbol, int message_paragraph = stool::Message::NO_MESSAGE)
+            {
+                for (SYMBOL c : text)
+                {
+                    if ((uint64_t)c > max_symbol)
+                    {
+                        max_symbol = c;
+                    }
+                }
+
+                IntegerAlphabetDynamicRIndex r;
+                r.symbol_width = IntegerAlphabetDynamicRIndex::compute_symbol_width(max_symbol);
+
+                std::vector<uint8_t> encoded_text = r.encode(text);
+                encoded_text.push_back(0);
+                std::vector<uint8_t> alphabet;
+                for (uint64_t i = 0; i <= UINT8_MAX; i++)
+                {
+                    alphabet.push_back(i);
+                }
+                DynamicRIndex tmp = DynamicRIndex::build_from_text(encoded_text, alphabet, message_paragraph);
+                r.index.swap(tmp);
+                return r;
+            }
+
+            /**
+             * @brief Save the index to a binary file
+             */
+            static void store_to_file(IntegerAlphabetDynamicRIndex &item, std::ofstream &os, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                os.write(reinterpret_cast<const char *>(&item.symbol_width), sizeof(uint64_t));
+                DynamicRIndex::store_to_file(item.index, os, message_paragraph);
+            }
+
+            /**
+             * @brief Load the index from a binary file
+             */
+            static IntegerAlphabetDynamicRIndex load_from_file(std::ifstream &ifs, int message_paragraph = stool::Message::SHOW_MESSAGE)
+            {
+                IntegerAlphabetDynamicRIndex r;
+                ifs.read(reinterpret_cast<char *>(&r.symbol_width), sizeof(uint64_t));
+                DynamicRIndex tmp = DynamicRIndex::load_from_file(ifs, message_paragraph);
+                r.index.swap(tmp);
+                return r;
+            }
+            //@}
+
+            /**
+             * @brief Return the smallest symbol width \p w satisfying max_symbol < 128 * 127^{w-1}
+             */
+            static uint64_t compute_symbol_width(uint64_t max_symbol)
+            {
+                uint64_t w = 1;
+                uint64_t capacity = HEAD_BASE;
+                while (capacity <= max_symbol)
+                {
+                    capacity = capacity > (UINT64_MAX / TAIL_BASE) ? UINT64_MAX : capacity * TAIL_BASE;
+                    w++;
+                }
+                return w;
+            }
+            /**
+             * @brief Return 128 * 127^{w-1}, or UINT64_MAX if it overflows
+             */
+            static uint64_t compute_symbol_capacity(uint64_t w)
+            {
+                uint64_t capacity = HEAD_BASE;
+                for (uint64_t i = 1; i < w; i++)
+                {
+                    capacity = capacity > (UINT64_MAX / TAIL_BASE) ? UINT64_MAX : capacity * TAIL_BASE;
+                }
+                return capacity;
+            }
+
+            /**
+             * @brief Encode a string of symbols into the byte string stored in the underlying dynamic r-index
+             * @throws std::runtime_error if a symbol cannot be represented with the symbol width of this index
+             */
+            std::vector<uint8_t> encode(const std::vector<SYMBOL> &str) const
+            {
+                uint64_t capacity = this->get_symbol_capacity();
+                std::vector<uint8_t> r;
+                r.resize(str.size() * this->symbol_width, 0);
+                for (uint64_t i = 0; i < str.size(); i++)
+                {
+                    uint64_t value = str[i];
+                    if (value >= capacity)
+                    {
+                        throw std::runtime_error("The symbol " + std::to_string(value) + " cannot be represented with " + std::to_string(this->symbol_width) + " bytes.");
+                    }
+                    uint64_t offset = i * this->symbol_width;
+                    for (int64_t j = this->symbol_width - 1; j > 0; j--)
+                    {
+                        r[offset + j] = TAIL_BYTE_OFFSET + (value % TAIL_BASE);
+                        value /= TAIL_BASE;
+                    }
+                    r[offset] = HEAD_BYTE_OFFSET + value;
+                }
+                return r;
+            }
+
+            /**
+             * @brief Decode a byte string produced by encode()
+             */
+            std::vector<SYMBOL> decode(const std::vector<uint8_t> &encoded_str) const
+            {
+                assert(encoded_str.size() % this->symbol_width == 0);
+                std::vector<SYMBOL> r;
+                r.resize(encoded_str.size() / this->symbol_width, 0);
+                for (uint64_t i = 0; i < r.size(); i++)
+                {
+                    uint64_t offset = i * this->symbol_width;
+                    uint64_t value = encoded_str[offset] - HEAD_BYTE_OFFSET;
+                    for (uint64_t j = 1; j < this->symbol_width; j++)
+                    {
+                        value = (value * TAIL_BASE) + (encoded_str[offset + j] - TAIL_BYTE_OFFSET);
+                    }
+                    r[i] = value;
+                }
+                return r;
+            }
+        };
+
+    }
+}
@@ -5,8 +5,18 @@
  * This program computes the Burrows-Wheeler Transform (BWT) of a text file
  * and writes it to an output file.
  * 
+ * With -f 1, the input is a FASTA or FASTQ file: the headers, the quality lines, and the newlines
+ * are removed, and the sequences are normalized to {A, C, G, T, N} and concatenated with the record separator '>'.
+ * The name, the starting position, and the length of each record are written to the output path
+ * with the suffix ".records".
+ * 
+ * With -t T (T > 1), the BWT of a text file is computed by prefix-free parsing with T threads,
+ * which reads the file as a stream and does not load the text or compute its suffix array.
+ * 
  * Usage:
  *   ./build_bwt -i input.txt -o output.bwt -c "$"
+ *   ./build_bwt -i input.fa -o output.bwt -c "$" -f 1
+ *   ./build_bwt -i input.txt -o output.bwt -c "$" -t 8
  * 
  * @author TNishimoto
  * @date 2025
@@ -22,6 +32,8 @@
 #include <filesystem>
 #include "stool/include/lib.hpp"
 #include "../include/dynamic_r_index/rlbwt_builder.hpp"
+#include "../include/dynamic_r_index/prefix_free_parsing.hpp"
+#include "../include/dynamic_r_index/fasta_reader.hpp"
 
 /**
  * @brief Extract the first character from a string, handling escape sequences
@@ -68,6 +80,8 @@ std::cout << "\e[m" << std::endl;
     p.add<std::string>("output_bwt_path", 'o', "Output BWT file path", false, "");
     p.add<std::string>("null_terminated_string", 'c', "End-of-text character", false, "\\0");
     p.add<uint>("detailed_message_flag", 'e', "Print detailed messages if 1", false, 0);
+    p.add<uint>("fasta", 'f', "Set to 1 if input is a FASTA or FASTQ file", false, 0);
+    p.add<uint>("thread_count", 't', "The number of threads (prefix-free parsing is used if it is larger than 1)", false, 1);
 
     p.parse_check(argc, argv);
     std::string input_file_path = p.get<std::string>("input_text_path");
@@ -77,6 +91,8 @@ std::cout << "\e[m" << std::endl;
 
     //uint8_t null_terminated_string = p.get<std::string>("null_terminated_string")[0];
     uint detailed_message_flag = p.get<uint>("detailed_message_flag");
+    uint is_fasta = p.get<uint>("fasta");
+    uint thread_count = p.get<uint>("thread_count");
 
     if (output_file_path.size() == 0)
     {
@@ -87,25 +103,87 @@ std::cout << "\e[m" << std::endl;
 
     
     std::vector<uint8_t> text;
-    stool::FileReader::load_vector(input_file_path, text);
-
-    //bool null_terminated_string_check = true;
-    for(uint i = 0; i < text.size(); i++){
-        if(text[i] == null_terminated_string){
-            throw std::runtime_error("The input text must not contain the null terminated string: " + stool::ConverterToString::to_visible_string(null_terminated_string));
+    stool::dynamic_r_index::DynamicRLBWT rlbwt;
+    if (is_fasta == 1)
+    {
+        if (null_terminated_string >= stool::dynamic_r_index::PackedDNASequence::SEPARATOR)
+        {
+            throw std::runtime_error("The null terminated string must be smaller than the record separator '>' for a FASTA file: " + stool::ConverterToString::to_visible_string(null_terminated_string));
         }
-        if(text[i] < null_terminated_string){
-            throw std::runtime_error("The null terminated string must be smallest among all characters in the input text: " + stool::ConverterToString::to_visible_string(null_terminated_string));
+        st1 = std::chrono::system_clock::now();
+
+        // The sequences are kept in 2 bits per base, and the RLBWT is computed by prefix-free parsing without unpacking them
+        stool::dynamic_r_index::PackedDNASequence sequence;
+        std::vector<std::string> names;
+        std::vector<uint64_t> starting_positions;
+        stool::dynamic_r_index::FASTAReader::load(input_file_path, sequence, names, starting_positions, stool::Message::SHOW_MESSAGE);
+        {
+            std::ofstream records_os(output_file_path + ".records");
+            stool::dynamic_r_index::FASTAReader::store_records_to_file(names, starting_positions, sequence.size(), records_os);
         }
+
+        std::vector<uint8_t> rlbwt_chars;
+        std::vector<uint64_t> rlbwt_runs, fst_sa, last_sa;
+        stool::dynamic_r_index::PrefixFreeParsing::build([&sequence]()
+                                                         { return sequence.open(); }, null_terminated_string, rlbwt_chars, rlbwt_runs, fst_sa, last_sa,
+                                                         stool::dynamic_r_index::PrefixFreeParsing::DEFAULT_WINDOW_SIZE, stool::dynamic_r_index::PrefixFreeParsing::DEFAULT_MODULUS, stool::Message::SHOW_MESSAGE, thread_count);
+        std::vector<uint64_t>().swap(fst_sa);
+        std::vector<uint64_t>().swap(last_sa);
+        std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(rlbwt_chars);
+        stool::dynamic_r_index::DynamicRLBWT tmp_rlbwt = stool::dynamic_r_index::DynamicRLBWT::build_from_RLBWT(rlbwt_chars, rlbwt_runs, alphabet, stool::Message::SHOW_MESSAGE);
+        rlbwt.swap(tmp_rlbwt);
+        if (sequence.size() < 1000)
+        {
+            std::string str = sequence.to_string();
+            text.insert(text.end(), str.begin(), str.end());
+        }
+        st2 = std::chrono::system_clock::now();
     }
-    
-    
+    else if (thread_count > 1)
+    {
+        st1 = std::chrono::system_clock::now();
 
-    st1 = std::chrono::system_clock::now();
-    stool::dynamic_r_index::DynamicRLBWT rlbwt = stool::dynamic_r_index::RLBWTBuilder::build(text, null_terminated_string);
-    
-    st2 = std::chrono::system_clock::now();
+        if (!std::ifstream(input_file_path, std::ios::binary))
+        {
+            throw std::runtime_error("Cannot open the file: " + input_file_path);
+        }
+
+        // The end marker is checked by PrefixFreeParsing, which throws if it is not the unique smallest character
+        std::vector<uint8_t> rlbwt_chars;
+        std::vector<uint64_t> rlbwt_runs, fst_sa, last_sa;
+        stool::dynamic_r_index::PrefixFreeParsing::build([&input_file_path]()
+                                                         { return std::unique_ptr<std::istream>(new std::ifstream(input_file_path, std::ios::binary)); }, null_terminated_string, rlbwt_chars, rlbwt_runs, fst_sa, last_sa,
+                                                         stool::dynamic_r_index::PrefixFreeParsing::DEFAULT_WINDOW_SIZE, stool::dynamic_r_index::PrefixFreeParsing::DEFAULT_MODULUS, stool::Message::SHOW_MESSAGE, thread_count);
+        std::vector<uint64_t>().swap(fst_sa);
+        std::vector<uint64_t>().swap(last_sa);
+        std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(rlbwt_chars);
+        stool::dynamic_r_index::DynamicRLBWT tmp_rlbwt = stool::dynamic_r_index::DynamicRLBWT::build_from_RLBWT(rlbwt_chars, rlbwt_runs, alphabet, stool::Message::SHOW_MESSAGE);
+        rlbwt.swap(tmp_rlbwt);
+        if (rlbwt.text_size() < 1000)
+        {
+            stool::FileReader::load_vector(input_file_path, text);
+        }
+        st2 = std::chrono::system_clock::now();
+    }
+    else
+    {
+        stool::FileReader::load_vector(input_file_path, text);
+
+        //bool null_terminated_string_check = true;
+        for(uint i = 0; i < text.size(); i++){
+            if(text[i] == null_terminated_string){
+                throw std::runtime_error("The input text must not contain the null terminated string: " + stool::ConverterToString::to_visible_string(null_terminated_string));
+            }
+            if(text[i] < null_terminated_string){
+                throw std::runtime_error("The null terminated string must be smallest among all characters in the input text: " + stool::ConverterToString::to_visible_string(null_terminated_string));
+            }
+        }
 
+        st1 = std::chrono::system_clock::now();
+        stool::dynamic_r_index::DynamicRLBWT tmp_rlbwt = stool::dynamic_r_index::RLBWTBuilder::build(text, null_terminated_string);
+        rlbwt.swap(tmp_rlbwt);
+        st2 = std::chrono::system_clock::now();
+    }
 
     rlbwt.write_BWT(output_file_path);
     st3 = std::chrono::system_clock::now();
@@ -6,9 +6,17 @@
  * a raw text file or a pre-computed BWT file. The resulting index is
  * saved to a binary file (.dfmi format).
  * 
+ * For a raw text file, the sampled suffix array is extracted directly from the suffix array,
+ * and the BWT is written over the suffix array, so that the peak memory stays at about 9n bytes.
+ * These two steps use the number of threads given by -t; the suffix sorting (libdivsufsort) is sequential.
+ * 
+ * A BWT file (-u 1) is read in blocks into the dynamic BWT, and the sampled suffix array is computed
+ * by one LF traversal over the dynamic BWT, so the BWT is never loaded into memory as a whole.
+ * 
  * Usage:
  *   ./build_fm_index -i input.txt -o output.dfmi
  *   ./build_fm_index -i input.bwt -o output.dfmi -u 1 -s 32
+ *   ./build_fm_index -i input.txt -o output.dfmi -t 8
  * 
  * @author TNishimoto
  * @date 2025
@@ -71,12 +79,14 @@ std::cout << "\e[m" << std::endl;
     p.add<std::string>("null_terminated_string", 'c', "End-of-text character", false, "\\0");
     p.add<uint>("is_bwt", 'u', "Set to 1 if input is BWT", false, 0);
     p.add<uint>("sampling_interval", 's', "SA sampling interval", false, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL);
+    p.add<uint>("thread_count", 't', "The number of threads used to extract the sampled SA and the BWT from SA (the suffix sorting is sequential)", false, 1);
 
     p.parse_check(argc, argv);
     std::string input_file_path = p.get<std::string>("input_file_path");
     std::string output_file_path = p.get<std::string>("output_index_path");
     uint text_type = p.get<uint>("is_bwt");
     uint sampling_interval = p.get<uint>("sampling_interval");
+    uint thread_count = p.get<uint>("thread_count");
     std::string tmp_null_terminated_string = p.get<std::string>("null_terminated_string");
     uint8_t null_terminated_string = get_first_character(tmp_null_terminated_string);
 
@@ -102,10 +112,7 @@ std::cout << "\e[m" << std::endl;
     stool::dynamic_r_index::DynamicFMIndex dfmi;
     if (text_type == is_bwt)
     {
-        std::vector<uint8_t> bwt;
-        stool::FileReader::load_vector(input_file_path, bwt);
-        std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(bwt);
-        stool::dynamic_r_index::DynamicFMIndex tmp_dfmi = stool::dynamic_r_index::DynamicFMIndex::build(bwt, alphabet, sampling_interval, stool::Message::SHOW_MESSAGE);
+        stool::dynamic_r_index::DynamicFMIndex tmp_dfmi = stool::dynamic_r_index::DynamicFMIndex::build_from_BWT_file(input_file_path, sampling_interval, stool::Message::SHOW_MESSAGE);
         dfmi.swap(tmp_dfmi);
     }
     else
@@ -114,10 +121,7 @@ std::cout << "\e[m" << std::endl;
         stool::FileReader::load_vector_with_end_marker_if_no_end_marker(input_file_path, text, null_terminated_string);
         std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(text);
 
-        std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text, stool::Message::SHOW_MESSAGE);
-        std::vector<uint64_t> isa = stool::ArrayConstructor::construct_ISA(sa, stool::Message::SHOW_MESSAGE);
-        std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text, sa, stool::Message::SHOW_MESSAGE);
-        stool::dynamic_r_index::DynamicFMIndex tmp_dfmi = stool::dynamic_r_index::DynamicFMIndex::build(bwt, alphabet, isa, sampling_interval, stool::Message::SHOW_MESSAGE);
+        stool::dynamic_r_index::DynamicFMIndex tmp_dfmi = stool::dynamic_r_index::DynamicFMIndex::build_from_text_in_place(text, alphabet, sampling_interval, stool::Message::SHOW_MESSAGE, thread_count);
         dfmi.swap(tmp_dfmi);
     }
 
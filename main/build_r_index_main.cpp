@@ -2,13 +2,34 @@
  * @file build_r_index_main.cpp
  * @brief Build dynamic r-index from text or BWT file
  * 
- * This program constructs a dynamic r-index data structure from either
- * a raw text file or a pre-computed BWT file. The resulting index is
+ * This program constructs a dynamic r-index data structure from
+ * a raw text file, a pre-computed BWT file, or a pre-computed RLBWT file. The resulting index is
  * saved to a binary file (.dri format).
  * 
+ * With -l 1, the input is a directory or a list of files (one path per line),
+ * and the index of the concatenation of the files separated by the separator character (-s)
+ * is built without writing the concatenation to disk. The starting positions of the documents
+ * are saved to the output path with the suffix ".docs".
+ * 
+ * With -f 1, the input is a FASTA or FASTQ file, and the index of the concatenation of its
+ * sequences normalized to {A, C, G, T, N} and separated by '>' is built. The name, the starting position, and the length
+ * of each record are saved to the output path with the suffix ".records".
+ * 
+ * With -n 1 (or -n 2), the index of the text (or the reversed text) is built by online construction,
+ * which reads the input once in blocks. The input path "-" reads the text from the standard input.
+ * 
+ * An RLBWT file is a sequence of 9-byte records, one per run: the character (1 byte)
+ * followed by the length of the run (8 bytes, little-endian).
+ * 
  * Usage:
  *   ./build_r_index -i input.txt -o output.dri
  *   ./build_r_index -i input.bwt -o output.dri -u 1
+ *   ./build_r_index -i input.bwt -o output.dri -u 1 -t 8
+ *   ./build_r_index -i input.rlbwt -o output.dri -u 2
+ *   ./build_r_index -i input.txt -o output.dri -p 1
+ *   ./build_r_index -i input_dir -o output.dri -l 1 -s "\1" -t 8
+ *   ./build_r_index -i input.fa -o output.dri -f 1 -t 8
+ *   cat input.txt | ./build_r_index -i - -o output.dri -n 1
  * 
  * @author TNishimoto
  * @date 2025
@@ -70,7 +91,13 @@ std::cout << "\e[m" << std::endl;
     p.add<std::string>("input_file_path", 'i', "Input file path (text or BWT)", true);
     p.add<std::string>("output_index_path", 'o', "Output index file path (.dri)", false, "");
     p.add<std::string>("null_terminated_string", 'c', "End-of-text character", false, "\\0");
-    p.add<uint>("is_bwt", 'u', "Set to 1 if input is BWT", false, 0);
+    p.add<uint>("is_bwt", 'u', "Set to 1 if input is BWT, or 2 if input is RLBWT (9-byte records of a character and a little-endian 64-bit run length)", false, 0);
+    p.add<uint>("thread_count", 't', "The number of threads used to build the index from a BWT file, an RLBWT file, a collection, a FASTA file, or a text file by prefix-free parsing", false, 1);
+    p.add<uint>("prefix_free_parsing", 'p', "Set to 1 to build the index from a text by prefix-free parsing without constructing the suffix array", false, 0);
+    p.add<uint>("collection", 'l', "Set to 1 if input is a directory or a list of files (one path per line) to be indexed as one text", false, 0);
+    p.add<std::string>("separator", 's', "Separator character between documents (used with -l 1)", false, "\\1");
+    p.add<uint>("fasta", 'f', "Set to 1 if input is a FASTA or FASTQ file", false, 0);
+    p.add<uint>("online", 'n', "Set to 1 (or 2) to build the index of the text (or the reversed text) by online construction (the input path - reads the standard input)", false, 0);
 
     p.parse_check(argc, argv);
     std::string input_file_path = p.get<std::string>("input_file_path");
@@ -78,11 +105,22 @@ std::cout << "\e[m" << std::endl;
     std::string tmp_null_terminated_string = p.get<std::string>("null_terminated_string");
     uint8_t null_terminated_string = get_first_character(tmp_null_terminated_string);
     uint text_type = p.get<uint>("is_bwt");
+    uint thread_count = p.get<uint>("thread_count");
+    uint use_prefix_free_parsing = p.get<uint>("prefix_free_parsing");
+    uint is_collection = p.get<uint>("collection");
+    uint is_fasta = p.get<uint>("fasta");
+    uint online_mode = p.get<uint>("online");
+    uint8_t separator = get_first_character(p.get<std::string>("separator"), 1);
 
     uint IS_BWT = 1;
+    uint IS_RLBWT = 2;
 
     if (output_file_path.size() == 0)
     {
+        if (input_file_path == "-")
+        {
+            throw std::runtime_error("The output path must be given if the text is read from the standard input.");
+        }
         output_file_path = input_file_path + ".drfmi";
     }
     std::ofstream os;
@@ -98,9 +136,68 @@ std::cout << "\e[m" << std::endl;
     st1 = std::chrono::system_clock::now();
     // uint is_r_index = 1;
     stool::dynamic_r_index::DynamicRIndex drfmi;
-    if (text_type == IS_BWT)
+    if (online_mode == 1 || online_mode == 2)
+    {
+        bool reversed = online_mode == 2;
+        if (input_file_path == "-")
+        {
+            stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_online(std::cin, null_terminated_string, reversed, stool::Message::SHOW_MESSAGE);
+            drfmi.swap(tmp_drfmi);
+        }
+        else
+        {
+            std::ifstream ifs(input_file_path, std::ios::binary);
+            if (!ifs)
+            {
+                throw std::runtime_error("Cannot open the file: " + input_file_path);
+            }
+            stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_online(ifs, null_terminated_string, reversed, stool::Message::SHOW_MESSAGE);
+            drfmi.swap(tmp_drfmi);
+        }
+    }
+    else if (is_collection == 1)
+    {
+        std::vector<std::string> file_paths = stool::dynamic_r_index::DocumentCollection::get_file_paths(input_file_path);
+        stool::dynamic_r_index::DocumentCollection collection(file_paths, separator);
+        stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_document_collection(collection, null_terminated_string, stool::Message::SHOW_MESSAGE, thread_count);
+        drfmi.swap(tmp_drfmi);
+
+        std::ofstream docs_os(output_file_path + ".docs", std::ios::binary);
+        if (!docs_os)
+        {
+            std::cerr << "Error: Could not open file for writing." << std::endl;
+            throw std::runtime_error("File open error");
+        }
+        stool::dynamic_r_index::DocumentCollection::store_starting_positions_to_file(collection, docs_os);
+    }
+    else if (is_fasta == 1)
+    {
+        std::vector<std::string> names;
+        std::vector<uint64_t> starting_positions;
+        stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_FASTA_file(input_file_path, null_terminated_string, names, starting_positions, stool::Message::SHOW_MESSAGE, thread_count);
+        drfmi.swap(tmp_drfmi);
+
+        std::ofstream records_os(output_file_path + ".records");
+        if (!records_os)
+        {
+            std::cerr << "Error: Could not open file for writing." << std::endl;
+            throw std::runtime_error("File open error");
+        }
+        stool::dynamic_r_index::FASTAReader::store_records_to_file(names, starting_positions, drfmi.size() - 1, records_os);
+    }
+    else if (text_type == IS_BWT)
+    {
+        stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_BWT_file(input_file_path, stool::Message::SHOW_MESSAGE, thread_count);
+        drfmi.swap(tmp_drfmi);
+    }
+    else if (text_type == IS_RLBWT)
+    {
+        stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_RLBWT_file(input_file_path, stool::Message::SHOW_MESSAGE, thread_count);
+        drfmi.swap(tmp_drfmi);
+    }
+    else if (use_prefix_free_parsing == 1)
     {
-        stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_BWT_file(input_file_path, stool::Message::SHOW_MESSAGE);
+        stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_text_file_by_prefix_free_parsing(input_file_path, null_terminated_string, stool::Message::SHOW_MESSAGE, thread_count);
         drfmi.swap(tmp_drfmi);
     }
     else
@@ -111,8 +208,8 @@ std::cout << "\e[m" << std::endl;
         std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(text);
 
         std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text, stool::Message::SHOW_MESSAGE);
-        std::vector<uint64_t> isa = stool::ArrayConstructor::construct_ISA(sa, stool::Message::SHOW_MESSAGE);
         std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text, sa, stool::Message::SHOW_MESSAGE);
+        std::vector<uint64_t>().swap(sa);
         stool::dynamic_r_index::DynamicRIndex tmp_drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(bwt, alphabet, stool::Message::SHOW_MESSAGE);
 
         drfmi.swap(tmp_drfmi);
@@ -131,7 +228,7 @@ std::cout << "\e[m" << std::endl;
     std::cout << "=============RESULT===============" << std::endl;
     std::cout << "Input File: \t\t\t\t\t" << input_file_path << std::endl;
     std::cout << "Output File: \t\t\t\t\t" << output_file_path << std::endl;
-    std::cout << "The type of the input file: \t\t\t" << (text_type == IS_BWT ? "bwt" : "text") << std::endl;
+    std::cout << "The type of the input file: \t\t\t" << (online_mode == 1 ? "text (online)" : online_mode == 2 ? "reversed text (online)" : is_collection == 1 ? "collection" : is_fasta == 1 ? "fasta" : (text_type == IS_BWT ? "bwt" : (text_type == IS_RLBWT ? "rlbwt" : "text"))) << std::endl;
     drfmi.print_light_statistics();
     if (text_size > 0)
     {
@@ -134,9 +134,20 @@ void fm_index_test(uint64_t text_size, uint64_t mode, bool detailed_check, uint6
     {
         stool::DynamicStringTest::random_test<stool::dynamic_r_index::DynamicFMIndex, stool::NaiveDynamicString, false, true>(text_size, 0, 100, 10, true, detailed_check, seed);
     }
+    else if (mode == 8)
+    {
+        run_for_each_alphabet_type("DynamicFMIndexTest::build_from_text_in_place_test", trial_num, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                   { DynamicFMIndexTest::build_from_text_in_place_test(text_size, alphabet_type, trial_seed); });
+    }
+    else if (mode == 9)
+    {
+        run_for_each_alphabet_type("DynamicFMIndexTest::build_from_BWT_file_test", trial_num, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                   { DynamicFMIndexTest::build_from_BWT_file_test(text_size, alphabet_type, trial_seed); });
+    }
     else
     {
-        for (uint64_t i = 1; i <= 6; i++)
+        // The mode 7 (the comparison with a naive dynamic string) is run only when it is given explicitly
+        for (uint64_t i : {1, 2, 3, 4, 5, 6, 8, 9})
         {
             fm_index_test(text_size, i, detailed_check, seed);
         }
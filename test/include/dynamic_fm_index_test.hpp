@@ -4,6 +4,8 @@
 #include <iostream>
 #include <stack>
 #include <unordered_map>
+#include <cstdio>
+#include <functional>
 #include "../../include/all.hpp"
 #include "stool/include/lib.hpp"
 #include "./naive_dynamic_string_x.hpp"
@@ -71,6 +73,40 @@ namespace stool
                 return alphabet_with_end_marker;
             }
 
+            /**
+             * @brief A random text of a given alphabet type with its end marker, suffix array, inverse suffix array and BWT
+             * @details The text consists of \p text_size characters drawn uniformly from the alphabet, followed by the end marker.
+             */
+            struct RandomTextFixture
+            {
+                std::mt19937_64 mt64;
+                std::vector<uint8_t> chars;
+                std::vector<uint8_t> alphabet_with_end_marker;
+                uint8_t end_marker;
+                std::vector<uint8_t> text;
+                std::vector<uint64_t> sa;
+                std::vector<uint64_t> isa;
+                std::vector<uint8_t> bwt;
+
+                RandomTextFixture(uint64_t text_size, uint8_t alphabet_type, uint64_t seed) : mt64(seed)
+                {
+                    this->chars = stool::Alphabet::create_alphabet(alphabet_type);
+                    this->alphabet_with_end_marker = create_alphabet_with_end_marker(this->chars);
+                    this->end_marker = this->alphabet_with_end_marker[0];
+
+                    std::uniform_int_distribution<uint64_t> get_rand_uni_char(0, this->chars.size() - 1);
+                    for (uint64_t i = 0; i < text_size; i++)
+                    {
+                        this->text.push_back(this->chars[get_rand_uni_char(this->mt64)]);
+                    }
+                    this->text.push_back(this->end_marker);
+
+                    this->sa = libdivsufsort::construct_suffix_array(this->text, stool::Message::NO_MESSAGE);
+                    this->isa = stool::ArrayConstructor::construct_ISA(this->sa, stool::Message::NO_MESSAGE);
+                    this->bwt = stool::ArrayConstructor::construct_BWT(this->text, this->sa, stool::Message::NO_MESSAGE);
+                }
+            };
+
             static void bwt_test_random_insertion(stool::NaiveDynamicStringX &nds, stool::dynamic_r_index::DynamicFMIndex &dfmi, std::vector<uint8_t> &chars, std::mt19937_64 &mt64)
             {
                 uint64_t size = nds.size();
@@ -291,6 +327,55 @@ namespace stool
                 // stool::EqualChecker::equal_check("ISA", isa, test_isa2);
             }
 
+            static void build_from_text_in_place_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                RandomTextFixture input(text_size, alphabet_type, seed);
+
+                for (uint64_t sampling_interval : {1, 3, 32})
+                {
+                    stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(input.bwt, input.alphabet_with_end_marker, input.isa, sampling_interval, stool::Message::NO_MESSAGE);
+                    for (uint64_t thread_count : {1, 4})
+                    {
+                        std::vector<uint8_t> tmp_text = input.text;
+                        stool::dynamic_r_index::DynamicFMIndex dfmi2 = stool::dynamic_r_index::DynamicFMIndex::build_from_text_in_place(tmp_text, input.alphabet_with_end_marker, sampling_interval, stool::Message::NO_MESSAGE, thread_count);
+
+                        stool::EqualChecker::equal_check(input.bwt, tmp_text, "BWT (overwritten text)");
+                        stool::EqualChecker::equal_check(dfmi.to_bwt(), dfmi2.to_bwt(), "BWT");
+                        stool::EqualChecker::equal_check(dfmi.get_sa(), dfmi2.get_sa(), "SA");
+                        stool::EqualChecker::equal_check(dfmi.get_isa(), dfmi2.get_isa(), "ISA");
+                    }
+                }
+            }
+
+            static void build_from_BWT_file_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                RandomTextFixture input(text_size, alphabet_type, seed);
+                std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(input.text);
+
+                std::string filepath = "dfmi.bwt";
+                {
+                    std::ofstream os;
+                    os.open(filepath, std::ios::binary);
+                    if (!os)
+                    {
+                        std::cerr << "Error: Could not open file for writing." << std::endl;
+                        throw std::runtime_error("File open error");
+                    }
+                    os.write(reinterpret_cast<const char *>(input.bwt.data()), input.bwt.size());
+                }
+
+                for (uint64_t sampling_interval : {1, 3, 32})
+                {
+                    stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(input.bwt, alphabet, input.isa, sampling_interval, stool::Message::NO_MESSAGE);
+                    stool::dynamic_r_index::DynamicFMIndex dfmi2 = stool::dynamic_r_index::DynamicFMIndex::build_from_BWT_file(filepath, sampling_interval, stool::Message::NO_MESSAGE);
+
+                    stool::EqualChecker::equal_check(dfmi.to_bwt(), dfmi2.to_bwt(), "BWT");
+                    stool::EqualChecker::equal_check(dfmi.get_sa(), dfmi2.get_sa(), "SA");
+                    stool::EqualChecker::equal_check(dfmi.get_isa(), dfmi2.get_isa(), "ISA");
+                }
+                std::remove(filepath.c_str());
+            }
+
             static void character_insertion_and_deletion_test(uint64_t item_num, uint8_t alphabet_type, bool detailed_check, uint64_t seed)
             {
                 std::mt19937_64 mt64(seed);
@@ -481,5 +566,23 @@ namespace stool
             }
         };
 
+        /**
+         * @brief Run \p test \p trial_count times for each alphabet type, printing the alphabet type before each trial
+         * @details Each trial receives a new seed, and \p seed is advanced past the seeds used.
+         */
+        inline void run_for_each_alphabet_type(const std::string &test_name, uint64_t trial_count, uint64_t &seed, const std::function<void(uint8_t, uint64_t)> &test)
+        {
+            std::cout << "Execute " << test_name << "." << std::endl;
+            for (uint64_t alphabet_type = 0; alphabet_type <= stool::Alphabet::get_max_alphabet_type(); alphabet_type++)
+            {
+                for (uint64_t i = 0; i < trial_count; i++)
+                {
+                    std::cout << alphabet_type << std::flush;
+                    test(alphabet_type, seed++);
+                }
+            }
+            std::cout << std::endl;
+        }
+
     }
 }
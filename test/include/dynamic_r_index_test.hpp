@@ -4,6 +4,8 @@
 #include <iostream>
 #include <stack>
 #include <unordered_map>
+#include <sstream>
+#include <cstdio>
 #include "libdivsufsort/sa.hpp"
 #include "stool/include/lib.hpp"
 #include "../../include/all.hpp"
@@ -456,6 +458,1638 @@ namespace stool
                 BWT_and_SA::bwt_sa_and_isa_check(drfmi, drfmi2);
             }
 
+            /**
+             * @brief Return the number of the updates performed by the guarded rebuild
+             */
+            static uint64_t rebuild_guard_test(uint64_t text_size, uint64_t rebuild_threshold, uint8_t alphabet_type, uint64_t seed)
+            {
+                std::mt19937_64 mt64(seed);
+                std::vector<uint8_t> chars = stool::Alphabet::create_alphabet(alphabet_type);
+                std::vector<uint8_t> alphabet_with_end_marker = DynamicFMIndexTest::create_alphabet_with_end_marker(chars);
+
+                // A highly repetitive text, so that some updates have long LCPs at the edit positions
+                std::vector<uint8_t> unit = DynamicRIndexTest::create_text(8, chars, alphabet_with_end_marker[0], mt64);
+                unit.pop_back();
+                std::vector<uint8_t> text;
+                while (text.size() < text_size)
+                {
+                    text.push_back(unit[text.size() % unit.size()]);
+                }
+                text.push_back(alphabet_with_end_marker[0]);
+
+                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text, stool::Message::NO_MESSAGE);
+                std::vector<uint64_t> isa = stool::ArrayConstructor::construct_ISA(sa, stool::Message::NO_MESSAGE);
+                std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text, sa, stool::Message::NO_MESSAGE);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(bwt, alphabet_with_end_marker, isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, stool::Message::NO_MESSAGE);
+                DynamicRIndex drfmi = DynamicRIndex::build_from_BWT(bwt, alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                drfmi.set_rebuild_threshold(rebuild_threshold);
+
+                std::uniform_int_distribution<uint64_t> get_rand_uni_char(0, chars.size() - 1);
+                for (uint64_t i = 0; i < 11; i++)
+                {
+                    uint64_t size = dfmi.size();
+                    // The guard is triggered only if the estimate is also at least a 1 / DEFAULT_REBUILD_RATIO fraction of the text length
+                    uint64_t threshold = drfmi.get_effective_rebuild_threshold();
+                    if (threshold != std::max<uint64_t>(rebuild_threshold, (size + DynamicRIndex::DEFAULT_REBUILD_RATIO - 1) / DynamicRIndex::DEFAULT_REBUILD_RATIO))
+                    {
+                        throw std::logic_error("Error: rebuild_guard_test, the effective threshold");
+                    }
+                    std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, size - 2);
+                    uint64_t pos = get_rand_uni_int(mt64);
+                    if (i == 10)
+                    {
+                        // An update whose estimate exceeds the threshold
+                        pos = size - 2;
+                        while (pos > 0 && drfmi.estimate_delete_cost(pos, 1, threshold) < threshold)
+                        {
+                            pos--;
+                        }
+                        if (pos == 0)
+                        {
+                            // No update exceeds the threshold (e.g., a unary text)
+                            break;
+                        }
+                    }
+
+                    dynamic_r_index::FMIndexEditHistory history;
+                    uint64_t rebuild_count = drfmi.get_guarded_rebuild_count();
+                    uint64_t estimate = 0;
+                    uint64_t reorder_count = 0;
+                    if (i % 3 == 0 && i != 10)
+                    {
+                        uint8_t new_char = chars[get_rand_uni_char(mt64)];
+                        estimate = drfmi.estimate_update_cost(pos, {new_char}, threshold);
+                        dfmi.insert_char(pos, new_char);
+                        reorder_count = drfmi.insert_char(pos, new_char, history);
+                    }
+                    else if (i % 3 == 1 && i != 10)
+                    {
+                        std::vector<uint8_t> pattern = {chars[get_rand_uni_char(mt64)], chars[get_rand_uni_char(mt64)]};
+                        estimate = drfmi.estimate_update_cost(pos, pattern, threshold);
+                        dfmi.insert_string(pos, pattern);
+                        reorder_count = drfmi.insert_string(pos, pattern, history);
+                    }
+                    else
+                    {
+                        estimate = drfmi.estimate_delete_cost(pos, 1, threshold);
+                        dfmi.delete_char(pos);
+                        reorder_count = drfmi.delete_char(pos, history);
+                    }
+
+                    // The guarded rebuild runs if and only if the estimate reaches the threshold
+                    bool guarded = drfmi.get_guarded_rebuild_count() == rebuild_count + 1;
+                    if (guarded != (estimate >= threshold) || (!guarded && drfmi.get_guarded_rebuild_count() != rebuild_count))
+                    {
+                        throw std::logic_error("Error: rebuild_guard_test, the guarded rebuild path");
+                    }
+                    if (guarded && (reorder_count != 0 || history.move_history.size() != 0))
+                    {
+                        throw std::logic_error("Error: rebuild_guard_test, the phase D ran in a guarded update");
+                    }
+                    if (!guarded && reorder_count != history.move_history.size())
+                    {
+                        throw std::logic_error("Error: rebuild_guard_test, the reorder count");
+                    }
+
+                    DynamicRIndexTest::verify_r_index(drfmi);
+                    BWT_and_SA::bwt_sa_and_isa_check(dfmi, drfmi);
+                }
+                return drfmi.get_guarded_rebuild_count();
+            }
+
+            static void update_cost_estimation_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                DynamicRIndex drfmi = DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                std::uniform_int_distribution<uint64_t> get_rand_uni_char(0, input.chars.size() - 1);
+                std::uniform_int_distribution<uint64_t> get_rand_uni_len(1, 8);
+
+                // The estimates are compared with the numbers of reorder operations actually performed by the updates
+                uint64_t update_count = 40;
+                uint64_t exact_count = 0;
+                uint64_t actual_sum = 0;
+                uint64_t error_sum = 0;
+                for (uint64_t i = 0; i < update_count; i++)
+                {
+                    uint64_t hash = drfmi.compute_RLBWT_hash(stool::Message::NO_MESSAGE);
+                    uint64_t estimated_value = 0;
+                    uint64_t actual_value = 0;
+                    if (i % 2 == 0)
+                    {
+                        std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, input.text.size() - 1);
+                        uint64_t pos = get_rand_uni_int(input.mt64);
+                        std::vector<uint8_t> pattern;
+                        uint64_t len = get_rand_uni_len(input.mt64);
+                        for (uint64_t x = 0; x < len; x++)
+                        {
+                            pattern.push_back(input.chars[get_rand_uni_char(input.mt64)]);
+                        }
+
+                        estimated_value = drfmi.estimate_update_cost(pos, pattern);
+                        if (drfmi.estimate_update_cost(pos, pattern, 2) != std::min<uint64_t>(estimated_value, 2))
+                        {
+                            throw std::logic_error("Error: update_cost_estimation_test, the limit is ignored");
+                        }
+                        if (hash != drfmi.compute_RLBWT_hash(stool::Message::NO_MESSAGE))
+                        {
+                            throw std::logic_error("Error: update_cost_estimation_test, the index was modified");
+                        }
+                        actual_value = drfmi.insert_string(pos, pattern);
+                        input.text.insert(input.text.begin() + pos, pattern.begin(), pattern.end());
+                    }
+                    else
+                    {
+                        std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, input.text.size() - 2);
+                        uint64_t pos = get_rand_uni_int(input.mt64);
+                        uint64_t len = std::min<uint64_t>(get_rand_uni_len(input.mt64), input.text.size() - 1 - pos);
+
+                        estimated_value = drfmi.estimate_delete_cost(pos, len);
+                        if (drfmi.estimate_delete_cost(pos, len, 2) != std::min<uint64_t>(estimated_value, 2))
+                        {
+                            throw std::logic_error("Error: update_cost_estimation_test, the limit is ignored");
+                        }
+                        if (hash != drfmi.compute_RLBWT_hash(stool::Message::NO_MESSAGE))
+                        {
+                            throw std::logic_error("Error: update_cost_estimation_test, the index was modified");
+                        }
+                        actual_value = drfmi.delete_string(pos, len);
+                        input.text.erase(input.text.begin() + pos, input.text.begin() + pos + len);
+                    }
+
+                    actual_sum += actual_value;
+                    error_sum += estimated_value > actual_value ? estimated_value - actual_value : actual_value - estimated_value;
+                    if (estimated_value == actual_value)
+                    {
+                        exact_count++;
+                    }
+                }
+
+                // On random texts, the estimate differs from the actual value only when a new suffix starting in the inserted string or a deleted suffix lies close to X'_d
+                if (exact_count * 2 < update_count || error_sum * 4 > actual_sum + update_count)
+                {
+                    std::cout << "exact: " << exact_count << "/" << update_count << ", error: " << error_sum << ", actual: " << actual_sum << std::endl;
+                    throw std::logic_error("Error: update_cost_estimation_test, the estimates are far from the actual values");
+                }
+
+                std::vector<uint64_t> new_sa = libdivsufsort::construct_suffix_array(input.text, stool::Message::NO_MESSAGE);
+                std::vector<uint8_t> new_bwt = stool::ArrayConstructor::construct_BWT(input.text, new_sa, stool::Message::NO_MESSAGE);
+                stool::EqualChecker::equal_check(new_bwt, drfmi.get_bwt(), "BWT");
+            }
+
+            static void run_compaction_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(input.bwt, input.alphabet_with_end_marker, input.isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, stool::Message::NO_MESSAGE);
+                DynamicRIndex drfmi = DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                for (uint64_t i = 0; i < 30; i++)
+                {
+                    DynamicRIndexTest::bwt_test_random_insertion(dfmi, drfmi, input.chars, input.mt64, false);
+                    DynamicRIndexTest::bwt_test_random_deletion(dfmi, drfmi, input.mt64, false);
+                }
+
+                // Compaction in small slices
+                uint64_t cursor = 0;
+                while (cursor < drfmi.run_count())
+                {
+                    drfmi.compact_runs(cursor, 3);
+                }
+
+                std::vector<uint8_t> new_bwt = drfmi.get_bwt();
+                uint64_t maximal_run_count = 0;
+                for (uint64_t i = 0; i < new_bwt.size(); i++)
+                {
+                    if (i == 0 || new_bwt[i] != new_bwt[i - 1])
+                    {
+                        maximal_run_count++;
+                    }
+                }
+                if (drfmi.run_count() != maximal_run_count)
+                {
+                    throw std::logic_error("Error: run_compaction_test, the runs are not maximal");
+                }
+                DynamicRIndexTest::verify_r_index(drfmi);
+                BWT_and_SA::bwt_sa_and_isa_check(dfmi, drfmi);
+            }
+
+            /**
+             * @brief Compare count and locate queries on \p drfmi (DynamicRIndex or DynamicFMIndex) with the naive search on \p text for all the substrings of \p text of length at most 3 starting at \p k random positions
+             */
+            template <typename INDEX>
+            static void query_check(const INDEX &drfmi, const std::vector<uint8_t> &text, uint64_t k, std::mt19937_64 &mt64, std::string name)
+            {
+                std::uniform_int_distribution<uint64_t> get_rand_pos(0, text.size() - 2);
+                for (uint64_t i = 0; i < k; i++)
+                {
+                    uint64_t pos = get_rand_pos(mt64);
+                    uint64_t len = std::min<uint64_t>(1 + (mt64() % 3), text.size() - 1 - pos);
+                    std::vector<uint8_t> pattern(text.begin() + pos, text.begin() + pos + len);
+
+                    std::vector<uint64_t> naive_result;
+                    for (uint64_t j = 0; j + pattern.size() <= text.size(); j++)
+                    {
+                        if (std::equal(pattern.begin(), pattern.end(), text.begin() + j))
+                        {
+                            naive_result.push_back(j);
+                        }
+                    }
+                    std::vector<uint64_t> result = drfmi.locate_query(pattern);
+                    std::sort(result.begin(), result.end());
+                    stool::EqualChecker::equal_check(naive_result, result, name + " (locate)");
+                    if (drfmi.count_query(pattern) != naive_result.size())
+                    {
+                        throw std::logic_error("Error: " + name + " (count)");
+                    }
+                }
+            }
+
+            static void non_maximal_run_compaction_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                // Every maximal run of length at least 2 is split into two adjacent runs with the same character
+                std::vector<uint8_t> rlbwt_chars;
+                std::vector<uint64_t> rlbwt_runs;
+                uint64_t split_count = 0;
+                for (uint64_t i = 0; i < input.bwt.size();)
+                {
+                    uint64_t j = i;
+                    while (j < input.bwt.size() && input.bwt[j] == input.bwt[i])
+                    {
+                        j++;
+                    }
+                    uint64_t len = j - i;
+                    if (len >= 2)
+                    {
+                        uint64_t first_len = 1 + (input.mt64() % (len - 1));
+                        rlbwt_chars.push_back(input.bwt[i]);
+                        rlbwt_runs.push_back(first_len);
+                        rlbwt_chars.push_back(input.bwt[i]);
+                        rlbwt_runs.push_back(len - first_len);
+                        split_count++;
+                    }
+                    else
+                    {
+                        rlbwt_chars.push_back(input.bwt[i]);
+                        rlbwt_runs.push_back(len);
+                    }
+                    i = j;
+                }
+                if (split_count == 0)
+                {
+                    return;
+                }
+
+                DynamicRIndex drfmi = DynamicRIndex::build_from_RLBWT(rlbwt_chars, rlbwt_runs, stool::Message::NO_MESSAGE);
+                drfmi.verify_structure();
+                DynamicRIndexTest::query_check(drfmi, input.text, 20, input.mt64, "non_maximal_run_compaction_test, before the compaction");
+
+                uint64_t cursor = 0;
+                uint64_t merge_count = 0;
+                while (cursor < drfmi.run_count())
+                {
+                    merge_count += drfmi.compact_runs(cursor, std::chrono::microseconds(1));
+                }
+                if (merge_count == 0 || merge_count != split_count || drfmi.run_count() != rlbwt_runs.size() - split_count)
+                {
+                    throw std::logic_error("Error: non_maximal_run_compaction_test, the number of merged runs");
+                }
+                drfmi.verify_structure(true);
+                DynamicRIndexTest::verify_r_index(drfmi);
+                stool::EqualChecker::equal_check(input.bwt, drfmi.get_bwt(), "BWT");
+                DynamicRIndexTest::query_check(drfmi, input.text, 20, input.mt64, "non_maximal_run_compaction_test, after the compaction");
+            }
+
+            static void blocked_c_array_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                DynamicRLBWT dbwt1 = DynamicRLBWT::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                BlockedDynamicRLBWT dbwt2 = BlockedDynamicRLBWT::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                std::uniform_int_distribution<uint64_t> get_rand_uni_char(0, input.chars.size() - 1);
+                for (uint64_t i = 0; i < 100; i++)
+                {
+                    std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, dbwt1.size() - 1);
+                    uint64_t pos = get_rand_uni_int(input.mt64);
+                    if (i % 2 == 0)
+                    {
+                        uint8_t c = input.chars[get_rand_uni_char(input.mt64)];
+                        dbwt1.insert(pos, c);
+                        dbwt2.insert(pos, c);
+                    }
+                    else if (dbwt1.access(pos) != dbwt1.get_end_marker())
+                    {
+                        dbwt1.remove(pos);
+                        dbwt2.remove(pos);
+                    }
+                }
+
+                stool::EqualChecker::equal_check(dbwt1.get_bwt(), dbwt2.get_bwt(), "BWT");
+                stool::EqualChecker::equal_check(dbwt1.get_effective_alphabet(), dbwt2.get_effective_alphabet(), "Effective alphabet");
+                for (uint64_t i = 0; i < dbwt1.size(); i++)
+                {
+                    if (dbwt1.LF(i) != dbwt2.LF(i))
+                    {
+                        throw std::logic_error("Error: blocked_c_array_test, LF(" + std::to_string(i) + ")");
+                    }
+                }
+            }
+
+            /**
+             * @brief Check BlockedDynamicRIndex and BlockedDynamicFMIndex (the indexes with BlockedCArray) against the naive text and SA under random updates
+             */
+            static void blocked_index_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::BlockedDynamicRIndex drfmi = stool::dynamic_r_index::BlockedDynamicRIndex::build_from_text(input.text, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                stool::dynamic_r_index::BlockedDynamicFMIndex dfmi = stool::dynamic_r_index::BlockedDynamicFMIndex::build_from_text(input.text, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                std::uniform_int_distribution<uint64_t> get_rand_uni_char(0, input.chars.size() - 1);
+                std::uniform_int_distribution<uint64_t> get_rand_uni_len(1, 4);
+                for (uint64_t i = 0; i < 20; i++)
+                {
+                    if (i % 2 == 0)
+                    {
+                        std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, input.text.size() - 1);
+                        uint64_t pos = get_rand_uni_int(input.mt64);
+                        std::vector<uint8_t> pattern;
+                        uint64_t len = get_rand_uni_len(input.mt64);
+                        for (uint64_t j = 0; j < len; j++)
+                        {
+                            pattern.push_back(input.chars[get_rand_uni_char(input.mt64)]);
+                        }
+                        drfmi.insert_string(pos, pattern);
+                        dfmi.insert_string(pos, pattern);
+                        input.text.insert(input.text.begin() + pos, pattern.begin(), pattern.end());
+                    }
+                    else if (input.text.size() > 2)
+                    {
+                        uint64_t len = std::min(get_rand_uni_len(input.mt64), (uint64_t)input.text.size() - 2);
+                        std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, input.text.size() - 1 - len);
+                        uint64_t pos = get_rand_uni_int(input.mt64);
+                        drfmi.delete_string(pos, len);
+                        dfmi.delete_string(pos, len);
+                        input.text.erase(input.text.begin() + pos, input.text.begin() + pos + len);
+                    }
+                }
+
+                drfmi.verify();
+                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(input.text, stool::Message::NO_MESSAGE);
+                stool::EqualChecker::equal_check(input.text, drfmi.get_text(), "Text (BlockedDynamicRIndex)");
+                stool::EqualChecker::equal_check(sa, drfmi.get_sa(), "SA (BlockedDynamicRIndex)");
+                stool::EqualChecker::equal_check(sa, dfmi.get_sa(), "SA (BlockedDynamicFMIndex)");
+                DynamicRIndexTest::query_check(drfmi, input.text, 20, input.mt64, "blocked_index_test (BlockedDynamicRIndex)");
+                DynamicRIndexTest::query_check(dfmi, input.text, 20, input.mt64, "blocked_index_test (BlockedDynamicFMIndex)");
+            }
+
+            static void integer_alphabet_test(uint64_t text_size, uint64_t max_symbol, uint64_t seed)
+            {
+                std::mt19937_64 mt64(seed);
+                std::uniform_int_distribution<uint64_t> get_rand_symbol(0, max_symbol);
+                std::vector<uint32_t> text;
+                for (uint64_t i = 0; i < text_size; i++)
+                {
+                    text.push_back(get_rand_symbol(mt64) % 4 == 0 ? get_rand_symbol(mt64) : text.size() % 5);
+                }
+
+                IntegerAlphabetDynamicRIndex<uint32_t> index = IntegerAlphabetDynamicRIndex<uint32_t>::build_from_text(text, max_symbol);
+                for (uint64_t i = 0; i < 20; i++)
+                {
+                    std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, text.size() - 1);
+                    uint64_t pos = get_rand_uni_int(mt64);
+                    if (i % 2 == 0)
+                    {
+                        std::vector<uint32_t> pattern = {(uint32_t)get_rand_symbol(mt64), (uint32_t)(pos % 5)};
+                        index.insert_string(pos, pattern);
+                        text.insert(text.begin() + pos, pattern.begin(), pattern.end());
+                    }
+                    else
+                    {
+                        index.delete_char(pos);
+                        text.erase(text.begin() + pos);
+                    }
+                }
+                index.verify();
+                stool::EqualChecker::equal_check(text, index.get_text(), "Text");
+
+                // Out-of-range deletions are rejected before the positions are converted to byte positions
+                std::vector<std::pair<uint64_t, uint64_t>> invalid_deletions = {{0, 0}, {0, text.size() + 1}, {text.size(), 1}, {text.size() - 1, 2}, {UINT64_MAX / 2, 2}, {1, UINT64_MAX}};
+                for (auto [u, len] : invalid_deletions)
+                {
+                    bool thrown = false;
+                    try
+                    {
+                        index.delete_string(u, len);
+                    }
+                    catch (const std::logic_error &)
+                    {
+                        thrown = true;
+                    }
+                    if (!thrown)
+                    {
+                        throw std::logic_error("Error: integer_alphabet_test, an out-of-range deletion is accepted");
+                    }
+                }
+                stool::EqualChecker::equal_check(text, index.get_text(), "Text");
+
+                for (uint64_t i = 0; i < 20; i++)
+                {
+                    std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, text.size() - 3);
+                    uint64_t pos = get_rand_uni_int(mt64);
+                    std::vector<uint32_t> pattern(text.begin() + pos, text.begin() + pos + 3);
+
+                    std::vector<uint64_t> naive_result;
+                    for (uint64_t j = 0; j + pattern.size() <= text.size(); j++)
+                    {
+                        if (std::equal(pattern.begin(), pattern.end(), text.begin() + j))
+                        {
+                            naive_result.push_back(j);
+                        }
+                    }
+                    std::vector<uint64_t> result = index.locate_query(pattern);
+                    std::sort(result.begin(), result.end());
+                    stool::EqualChecker::equal_check(naive_result, result, "Locate");
+                    if (index.count_query(pattern) != naive_result.size())
+                    {
+                        throw std::logic_error("Error: integer_alphabet_test, count query");
+                    }
+                }
+            }
+
+            static void alphabet_growth_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                std::mt19937_64 mt64(seed);
+                std::vector<uint8_t> chars = stool::Alphabet::create_alphabet(alphabet_type);
+                if (chars.size() < 2)
+                {
+                    return;
+                }
+
+                // The indexes are built over the first half of the characters, and the other characters are inserted later
+                std::vector<uint8_t> initial_chars(chars.begin(), chars.begin() + (chars.size() / 2));
+                std::vector<uint8_t> alphabet_with_end_marker = DynamicFMIndexTest::create_alphabet_with_end_marker(initial_chars);
+                std::vector<uint8_t> text = DynamicRIndexTest::create_text(text_size, initial_chars, alphabet_with_end_marker[0], mt64);
+                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text, stool::Message::NO_MESSAGE);
+                std::vector<uint64_t> isa = stool::ArrayConstructor::construct_ISA(sa, stool::Message::NO_MESSAGE);
+                std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text, sa, stool::Message::NO_MESSAGE);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(bwt, alphabet_with_end_marker, isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, stool::Message::NO_MESSAGE);
+                DynamicRIndex drfmi = DynamicRIndex::build_from_BWT(bwt, alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                for (uint64_t i = 0; i < 20; i++)
+                {
+                    DynamicRIndexTest::bwt_test_random_insertion(dfmi, drfmi, chars, mt64, false);
+                    DynamicRIndexTest::bwt_test_random_deletion(dfmi, drfmi, mt64, false);
+                }
+                DynamicRIndexTest::verify_r_index(drfmi);
+                BWT_and_SA::bwt_sa_and_isa_check(dfmi, drfmi);
+
+                std::vector<uint8_t> alphabet = drfmi.get_dynamic_rlbwt().to_alphabet_vector();
+                for (uint8_t c : drfmi.get_text())
+                {
+                    if (std::find(alphabet.begin(), alphabet.end(), c) == alphabet.end())
+                    {
+                        throw std::logic_error("Error: alphabet_growth_test, the alphabet does not contain " + std::to_string(c));
+                    }
+                }
+            }
+
+            static void sliding_window_test(uint64_t window_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(window_size / 2, alphabet_type, seed);
+
+                DynamicRIndex drfmi = DynamicRIndex::build_from_text(input.text, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                drfmi.set_window_size(window_size);
+                input.text.pop_back();
+
+                std::uniform_int_distribution<uint64_t> get_rand_uni_char(0, input.chars.size() - 1);
+                std::uniform_int_distribution<uint64_t> get_rand_uni_len(1, window_size / 4);
+                for (uint64_t i = 0; i < 30; i++)
+                {
+                    // Appended strings occasionally fill the whole window
+                    uint64_t len = i % 10 == 9 ? window_size + 1 : get_rand_uni_len(input.mt64);
+                    std::vector<uint8_t> appended_string;
+                    for (uint64_t j = 0; j < len; j++)
+                    {
+                        appended_string.push_back(input.chars[get_rand_uni_char(input.mt64)]);
+                    }
+                    drfmi.append_string(appended_string);
+
+                    input.text.insert(input.text.end(), appended_string.begin(), appended_string.end());
+                    if (input.text.size() > window_size)
+                    {
+                        input.text.erase(input.text.begin(), input.text.end() - window_size);
+                    }
+                }
+                input.text.push_back(input.alphabet_with_end_marker[0]);
+
+                DynamicRIndexTest::verify_r_index(drfmi);
+                stool::EqualChecker::equal_check(input.text, drfmi.get_text(), "Text");
+                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(input.text, stool::Message::NO_MESSAGE);
+                stool::EqualChecker::equal_check(sa, drfmi.get_sa(), "SA");
+            }
+
+            static void replace_all_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build_from_text(input.text, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                DynamicRIndex drfmi = DynamicRIndex::build_from_text(input.text, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                std::uniform_int_distribution<uint64_t> get_rand_uni_char(0, input.chars.size() - 1);
+                std::uniform_int_distribution<uint64_t> get_rand_uni_len(0, 3);
+                for (uint64_t i = 0; i < 5 && input.text.size() > 4; i++)
+                {
+                    std::uniform_int_distribution<uint64_t> get_rand_uni_int(0, input.text.size() - 4);
+                    uint64_t pos = get_rand_uni_int(input.mt64);
+                    std::vector<uint8_t> P(input.text.begin() + pos, input.text.begin() + pos + 1 + (i % 3));
+                    std::vector<uint8_t> Q;
+                    uint64_t q_len = get_rand_uni_len(input.mt64);
+                    for (uint64_t j = 0; j < q_len; j++)
+                    {
+                        Q.push_back(input.chars[get_rand_uni_char(input.mt64)]);
+                    }
+
+                    // Naive replacement from left to right
+                    std::vector<uint8_t> new_text;
+                    uint64_t naive_count = 0;
+                    uint64_t x = 0;
+                    while (x + 1 < input.text.size())
+                    {
+                        if (x + P.size() < input.text.size() && std::equal(P.begin(), P.end(), input.text.begin() + x))
+                        {
+                            new_text.insert(new_text.end(), Q.begin(), Q.end());
+                            x += P.size();
+                            naive_count++;
+                        }
+                        else
+                        {
+                            new_text.push_back(input.text[x]);
+                            x++;
+                        }
+                    }
+                    new_text.push_back(input.alphabet_with_end_marker[0]);
+                    input.text.swap(new_text);
+
+                    uint64_t count1 = dfmi.replace_all(P, Q);
+                    uint64_t count2 = drfmi.replace_all(P, Q);
+                    if (count1 != naive_count || count2 != naive_count)
+                    {
+                        throw std::logic_error("Error: replace_all_test, the number of replaced occurrences");
+                    }
+                    stool::EqualChecker::equal_check(input.text, drfmi.get_text(), "Text");
+                    DynamicRIndexTest::verify_r_index(drfmi);
+                    BWT_and_SA::bwt_sa_and_isa_check(dfmi, drfmi);
+                }
+            }
+
+            static void copy_and_move_substring_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed, uint64_t max_len = 10)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                DynamicRIndex drfmi = DynamicRIndex::build_from_text(input.text, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                std::uniform_int_distribution<uint64_t> get_rand_uni_len(1, max_len);
+                for (uint64_t i = 0; i < 20; i++)
+                {
+                    uint64_t len = std::min(get_rand_uni_len(input.mt64), (uint64_t)input.text.size() - 1);
+                    std::uniform_int_distribution<uint64_t> get_rand_src(0, input.text.size() - 1 - len);
+                    uint64_t src = get_rand_src(input.mt64);
+                    std::vector<uint8_t> substring(input.text.begin() + src, input.text.begin() + src + len);
+
+                    if (i % 2 == 0)
+                    {
+                        std::uniform_int_distribution<uint64_t> get_rand_dst(0, input.text.size() - 1);
+                        uint64_t dst = get_rand_dst(input.mt64);
+                        drfmi.copy_substring(src, len, dst);
+                        input.text.insert(input.text.begin() + dst, substring.begin(), substring.end());
+                    }
+                    else
+                    {
+                        // Choose a destination outside the moved substring
+                        std::uniform_int_distribution<uint64_t> get_rand_dst(0, input.text.size() - len);
+                        uint64_t dst = get_rand_dst(input.mt64);
+                        if (dst > src)
+                        {
+                            dst += len - 1;
+                        }
+                        drfmi.move_substring(src, len, dst);
+                        if (dst > src)
+                        {
+                            input.text.insert(input.text.begin() + dst, substring.begin(), substring.end());
+                            input.text.erase(input.text.begin() + src, input.text.begin() + src + len);
+                        }
+                        else
+                        {
+                            input.text.erase(input.text.begin() + src, input.text.begin() + src + len);
+                            input.text.insert(input.text.begin() + dst, substring.begin(), substring.end());
+                        }
+                    }
+                }
+
+                DynamicRIndexTest::verify_r_index(drfmi);
+                stool::EqualChecker::equal_check(input.text, drfmi.get_text(), "Text");
+                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(input.text, stool::Message::NO_MESSAGE);
+                stool::EqualChecker::equal_check(sa, drfmi.get_sa(), "SA");
+            }
+
+            static void run_permutation_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(input.bwt, input.alphabet_with_end_marker, input.isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, stool::Message::NO_MESSAGE);
+                DynamicRIndex drfmi = DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                drfmi.set_run_permutation_enabled(true);
+
+                for (uint64_t i = 0; i < 20; i++)
+                {
+                    DynamicRIndexTest::bwt_test_random_insertion(dfmi, drfmi, input.chars, input.mt64, false);
+                    DynamicRIndexTest::bwt_test_random_deletion(dfmi, drfmi, input.mt64, false);
+                }
+                DynamicRIndexTest::verify_r_index(drfmi);
+                BWT_and_SA::bwt_sa_and_isa_check(dfmi, drfmi);
+
+                drfmi.set_run_permutation_enabled(false);
+                for (uint64_t i = 0; i < 5; i++)
+                {
+                    DynamicRIndexTest::bwt_test_random_insertion(dfmi, drfmi, input.chars, input.mt64, false);
+                }
+                DynamicRIndexTest::verify_r_index(drfmi);
+                BWT_and_SA::bwt_sa_and_isa_check(dfmi, drfmi);
+            }
+
+            static void update_log_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(input.bwt, input.alphabet_with_end_marker, input.isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, stool::Message::NO_MESSAGE);
+                DynamicRIndex primary = DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                DynamicRIndex replica = DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                RIndexUpdateLog log;
+                primary.set_update_log(&log);
+                for (uint64_t i = 0; i < 10; i++)
+                {
+                    log.clear();
+                    DynamicRIndexTest::bwt_test_random_insertion(dfmi, primary, input.chars, input.mt64, false);
+                    DynamicRIndexTest::bwt_test_random_deletion(dfmi, primary, input.mt64, false);
+                    primary.compact_runs();
+
+                    RIndexUpdateLog received = RIndexUpdateLog::build(log.get_bytes());
+                    replica.apply_update_log(received);
+                    DynamicRIndexTest::verify_r_index(replica);
+                    BWT_and_SA::bwt_sa_and_isa_check(dfmi, replica);
+                    if (replica.run_count() != primary.run_count())
+                    {
+                        throw std::logic_error("Error: update_log_test (run count)");
+                    }
+                }
+                primary.set_update_log(nullptr);
+
+                // A wrong checksum is detected, and the log of the replica is restored
+                {
+                    RIndexUpdateLog tampered;
+                    tampered.write_operation(UpdateLogOperation::Checksum);
+                    tampered.write_value(replica.compute_RLBWT_hash(stool::Message::NO_MESSAGE) + 1);
+
+                    RIndexUpdateLog replica_log;
+                    replica.set_update_log(&replica_log);
+                    bool thrown = false;
+                    try
+                    {
+                        replica.apply_update_log(tampered);
+                    }
+                    catch (const std::runtime_error &)
+                    {
+                        thrown = true;
+                    }
+                    if (!thrown)
+                    {
+                        throw std::logic_error("Error: update_log_test (divergence)");
+                    }
+                    if (replica.get_update_log() != &replica_log)
+                    {
+                        throw std::logic_error("Error: update_log_test (the log of the replica is not restored)");
+                    }
+                    replica.set_update_log(nullptr);
+
+                    std::vector<uint8_t> bytes = tampered.get_bytes();
+                    bytes[0] = RIndexUpdateLog::VERSION + 1;
+                    thrown = false;
+                    try
+                    {
+                        replica.apply_update_log(RIndexUpdateLog::build(bytes));
+                    }
+                    catch (const std::runtime_error &)
+                    {
+                        thrown = true;
+                    }
+                    if (!thrown)
+                    {
+                        throw std::logic_error("Error: update_log_test (version)");
+                    }
+                }
+
+                // The encoding of integers, and malformed or truncated logs
+                {
+                    RIndexUpdateLog values;
+                    std::vector<uint64_t> items = {0, 127, 128, (1ULL << 63) - 1, 1ULL << 63, UINT64_MAX};
+                    for (uint64_t x : items)
+                    {
+                        values.write_value(x);
+                    }
+                    uint64_t pos = 0;
+                    values.read_version(pos);
+                    for (uint64_t x : items)
+                    {
+                        if (values.read_value(pos) != x)
+                        {
+                            throw std::logic_error("Error: update_log_test (read_value)");
+                        }
+                    }
+
+                    std::vector<std::vector<uint8_t>> malformed_values = {
+                        std::vector<uint8_t>(11, 0xFF),
+                        {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02},
+                        {0x80, 0x80}};
+                    for (const std::vector<uint8_t> &bytes : malformed_values)
+                    {
+                        RIndexUpdateLog malformed = RIndexUpdateLog::build(bytes);
+                        uint64_t malformed_pos = 0;
+                        bool thrown = false;
+                        try
+                        {
+                            malformed.read_value(malformed_pos);
+                        }
+                        catch (const std::runtime_error &)
+                        {
+                            thrown = true;
+                        }
+                        if (!thrown)
+                        {
+                            throw std::logic_error("Error: update_log_test (malformed value)");
+                        }
+                    }
+
+                    std::string filepath = "drfmi_update_log.bin";
+                    {
+                        std::ofstream os(filepath, std::ios::binary);
+                        RIndexUpdateLog::store_to_file(values, os);
+                    }
+                    {
+                        std::ifstream ifs(filepath, std::ios::binary);
+                        RIndexUpdateLog loaded = RIndexUpdateLog::load_from_file(ifs);
+                        if (loaded.get_bytes() != values.get_bytes())
+                        {
+                            throw std::logic_error("Error: update_log_test (load_from_file)");
+                        }
+                    }
+                    std::filesystem::resize_file(filepath, sizeof(uint64_t) + values.size() - 1);
+                    {
+                        std::ifstream ifs(filepath, std::ios::binary);
+                        bool thrown = false;
+                        try
+                        {
+                            RIndexUpdateLog::load_from_file(ifs);
+                        }
+                        catch (const std::runtime_error &)
+                        {
+                            thrown = true;
+                        }
+                        if (!thrown)
+                        {
+                            throw std::logic_error("Error: update_log_test (truncated log)");
+                        }
+                    }
+                    std::remove(filepath.c_str());
+                }
+            }
+
+            static void rlbwt_hash_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(input.bwt, input.alphabet_with_end_marker, input.isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, stool::Message::NO_MESSAGE);
+                DynamicRIndex drfmi = DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                drfmi.set_run_hash_enabled(true);
+
+                for (uint64_t i = 0; i < 10; i++)
+                {
+                    DynamicRIndexTest::bwt_test_random_insertion(dfmi, drfmi, input.chars, input.mt64, false);
+                    DynamicRIndexTest::bwt_test_random_deletion(dfmi, drfmi, input.mt64, false);
+                    drfmi.compact_runs();
+
+                    DynamicRIndex rebuilt = DynamicRIndex::build_from_BWT(drfmi.get_bwt(), input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                    if (drfmi.compute_RLBWT_hash(stool::Message::NO_MESSAGE) != rebuilt.compute_RLBWT_hash(stool::Message::NO_MESSAGE))
+                    {
+                        throw std::logic_error("Error: rlbwt_hash_test");
+                    }
+                }
+                DynamicRIndexTest::verify_r_index(drfmi);
+            }
+
+            /**
+             * @brief Check that two RLBWTs with the same multiset of adjacent runs but different orders have different hash values
+             */
+            static void rlbwt_hash_collision_test()
+            {
+                std::vector<uint8_t> alphabet = {'$', 'a', 'b', 'c'};
+                // The runs a b a c a and a c a b a have the same pairs of adjacent runs, (a, b), (b, a), (a, c), and (c, a)
+                std::vector<uint8_t> chars1 = {'a', 'b', 'a', 'c', 'a', '$'};
+                std::vector<uint8_t> chars2 = {'a', 'c', 'a', 'b', 'a', '$'};
+                std::vector<uint64_t> runs = {2, 1, 2, 1, 2, 1};
+
+                stool::dynamic_r_index::DynamicRLBWT rlbwt1 = stool::dynamic_r_index::DynamicRLBWT::build_from_RLBWT(chars1, runs, alphabet, stool::Message::NO_MESSAGE);
+                stool::dynamic_r_index::DynamicRLBWT rlbwt2 = stool::dynamic_r_index::DynamicRLBWT::build_from_RLBWT(chars2, runs, alphabet, stool::Message::NO_MESSAGE);
+                rlbwt1.set_run_hash_enabled(true);
+                rlbwt2.set_run_hash_enabled(true);
+                uint64_t hash1 = rlbwt1.compute_RLBWT_hash(stool::Message::NO_MESSAGE);
+                uint64_t hash2 = rlbwt2.compute_RLBWT_hash(stool::Message::NO_MESSAGE);
+                if (hash1 != rlbwt1.compute_RLBWT_hash_naively() || hash2 != rlbwt2.compute_RLBWT_hash_naively())
+                {
+                    throw std::logic_error("Error: rlbwt_hash_collision_test (the maintained hash is incorrect)");
+                }
+                if (hash1 == hash2)
+                {
+                    throw std::logic_error("Error: rlbwt_hash_collision_test (collision)");
+                }
+            }
+
+            static void sampling_verification_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(input.bwt, input.alphabet_with_end_marker, input.isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, stool::Message::NO_MESSAGE);
+                DynamicRIndex drfmi = DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                drfmi.verify_structure(true);
+                drfmi.verify_by_sampling(100, seed, 1);
+
+                for (uint64_t i = 0; i < 10; i++)
+                {
+                    DynamicRIndexTest::bwt_test_random_insertion(dfmi, drfmi, input.chars, input.mt64, false);
+                    DynamicRIndexTest::bwt_test_random_deletion(dfmi, drfmi, input.mt64, false);
+                    // Deletions may leave adjacent runs with the same character
+                    drfmi.verify_structure();
+                    drfmi.verify_by_sampling(drfmi.run_count(), seed + i, 4);
+                }
+                drfmi.compact_runs();
+                drfmi.verify_structure(true);
+                BWT_and_SA::bwt_sa_and_isa_check(dfmi, drfmi);
+            }
+
+            /**
+             * @brief Check the BWT and SA of \p index and the anchor of \p session against the naive BWT and SA of \p text
+             */
+            template <typename INDEX>
+            static void edit_session_check(const INDEX &index, const stool::dynamic_r_index::EditSession<INDEX> &session, const std::vector<uint8_t> &text, const std::string &name)
+            {
+                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text, stool::Message::NO_MESSAGE);
+                std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text, sa, stool::Message::NO_MESSAGE);
+                stool::EqualChecker::equal_check(bwt, index.get_bwt(), name + " BWT");
+                stool::EqualChecker::equal_check(sa, index.get_sa(), name + " SA");
+
+                const stool::dynamic_r_index::EditAnchor &anchor = session.get_anchor();
+                if (anchor.is_valid() && (anchor.text_position >= text.size() || anchor.sa_index >= sa.size() || sa[anchor.sa_index] != anchor.text_position))
+                {
+                    throw std::logic_error("Error: edit_session_test, the anchor of " + name + " is not ISA[t]");
+                }
+            }
+
+            static void edit_session_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::DynamicFMIndex dfmi = stool::dynamic_r_index::DynamicFMIndex::build(input.bwt, input.alphabet_with_end_marker, input.isa, stool::dynamic_r_index::DynamicSampledSA::DEFAULT_SAMPLING_INTERVAL, stool::Message::NO_MESSAGE);
+                DynamicRIndex drfmi = DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                stool::dynamic_r_index::EditSession<stool::dynamic_r_index::DynamicFMIndex> fm_session(dfmi);
+                stool::dynamic_r_index::EditSession<DynamicRIndex> r_session(drfmi);
+                std::uniform_int_distribution<uint64_t> get_rand_char(0, input.chars.size() - 1);
+                std::uniform_int_distribution<uint64_t> get_rand_len(1, 4);
+
+                // The FM-index uses the anchor only within half the sampling interval, and the r-index only if it is closer than the nearest sampled position
+                uint64_t fm_limit = dfmi.get_samling_interval() / 2;
+                auto fm_uses_anchor = [&](uint64_t i)
+                {
+                    const stool::dynamic_r_index::EditAnchor &anchor = fm_session.get_anchor();
+                    uint64_t n = dfmi.size();
+                    return anchor.distance(i, n) < fm_limit && anchor.sa_index < n ? 1 : 0;
+                };
+                auto r_uses_anchor = [&](uint64_t i)
+                {
+                    const stool::dynamic_r_index::EditAnchor &anchor = r_session.get_anchor();
+                    uint64_t n = drfmi.size();
+                    uint64_t d = anchor.distance(i, n);
+                    if (d == UINT64_MAX || anchor.sa_index >= n)
+                    {
+                        return 0;
+                    }
+                    std::pair<uint64_t, uint64_t> nearest = drfmi.get_dynamic_phi().nearest_search_by_text_position(i, drfmi.get_dynamic_rlbwt());
+                    uint64_t sample_distance = nearest.second <= i ? i - nearest.second : nearest.second - i;
+                    sample_distance = std::min(sample_distance, n - sample_distance);
+                    return d < sample_distance ? 1 : 0;
+                };
+
+                uint64_t near_edit_count = 0;
+                uint64_t far_edit_count = 0;
+                uint64_t cursor = input.mt64() % (input.text.size() - 1);
+                for (uint64_t i = 0; i < 100; i++)
+                {
+                    uint64_t action = input.mt64() % 10;
+                    if (action >= 8)
+                    {
+                        // Jump to a position near the anchor of the FM-index, or far from it (at least half the sampling interval)
+                        const stool::dynamic_r_index::EditAnchor &anchor = fm_session.get_anchor();
+                        uint64_t n = input.text.size();
+                        if (anchor.is_valid() && action == 8)
+                        {
+                            cursor = std::min<uint64_t>((anchor.text_position + (input.mt64() % fm_limit)) % n, n - 2);
+                        }
+                        else if (anchor.is_valid())
+                        {
+                            cursor = std::min<uint64_t>((anchor.text_position + fm_limit + (input.mt64() % std::max<uint64_t>(1, n - 2 * fm_limit))) % n, n - 2);
+                        }
+                        else
+                        {
+                            cursor = input.mt64() % (n - 1);
+                        }
+                    }
+
+                    uint64_t fm_use_count = fm_session.get_anchor_use_count();
+                    uint64_t r_use_count = r_session.get_anchor_use_count();
+                    uint64_t fm_expected = 0;
+                    uint64_t r_expected = 0;
+                    if (input.mt64() % 3 != 0)
+                    {
+                        // Typing: insert at the cursor and advance the cursor
+                        std::vector<uint8_t> pattern;
+                        uint64_t len = get_rand_len(input.mt64);
+                        for (uint64_t j = 0; j < len; j++)
+                        {
+                            pattern.push_back(input.chars[get_rand_char(input.mt64)]);
+                        }
+                        fm_expected = fm_uses_anchor(cursor);
+                        r_expected = r_uses_anchor(cursor);
+                        fm_session.insert_string(cursor, pattern);
+                        r_session.insert_string(cursor, pattern);
+                        input.text.insert(input.text.begin() + cursor, pattern.begin(), pattern.end());
+                        cursor += pattern.size();
+                    }
+                    else
+                    {
+                        // Backspace: delete the characters preceding the cursor
+                        uint64_t len = std::min<uint64_t>(get_rand_len(input.mt64), cursor);
+                        if (len == 0 || input.text.size() <= len + 1)
+                        {
+                            continue;
+                        }
+                        uint64_t pos = cursor - len;
+                        uint64_t pointer = cursor < input.text.size() ? cursor : 0;
+                        fm_expected = fm_uses_anchor(pointer) + fm_uses_anchor(pos);
+                        r_expected = r_uses_anchor(cursor);
+                        fm_session.delete_string(pos, len);
+                        r_session.delete_string(pos, len);
+                        input.text.erase(input.text.begin() + pos, input.text.begin() + cursor);
+                        cursor = pos;
+                    }
+
+                    // Check which path computed ISA at the edited position
+                    if (fm_session.get_anchor_use_count() != fm_use_count + fm_expected)
+                    {
+                        throw std::logic_error("Error: edit_session_test, the anchor path of DynamicFMIndex");
+                    }
+                    if (r_session.get_anchor_use_count() != r_use_count + r_expected)
+                    {
+                        throw std::logic_error("Error: edit_session_test, the anchor path of DynamicRIndex");
+                    }
+                    if (fm_expected > 0)
+                    {
+                        near_edit_count++;
+                    }
+                    else
+                    {
+                        far_edit_count++;
+                    }
+
+                    DynamicRIndexTest::edit_session_check(dfmi, fm_session, input.text, "DynamicFMIndex");
+                    DynamicRIndexTest::edit_session_check(drfmi, r_session, input.text, "DynamicRIndex");
+                }
+                if (near_edit_count == 0 || far_edit_count == 0)
+                {
+                    throw std::logic_error("Error: edit_session_test, the edits near and far from the anchor are not both tested");
+                }
+                DynamicRIndexTest::verify_r_index(drfmi);
+            }
+
+            static void parallel_sampling_sa_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::rlbwt2::RLE<uint8_t> static_rlbwt = stool::rlbwt2::RLE<uint8_t>::build_from_BWT(input.bwt, stool::Message::NO_MESSAGE);
+                std::vector<uint64_t> fst_sa1, last_sa1;
+                SamplingSATBuilder::build(static_rlbwt, fst_sa1, last_sa1, stool::Message::NO_MESSAGE, 1);
+
+                for (uint64_t thread_count : {2, 3, 8})
+                {
+                    std::vector<uint64_t> fst_sa2, last_sa2;
+                    SamplingSATBuilder::build(static_rlbwt, fst_sa2, last_sa2, stool::Message::NO_MESSAGE, thread_count);
+                    stool::EqualChecker::equal_check(fst_sa1, fst_sa2, "fst_sa");
+                    stool::EqualChecker::equal_check(last_sa1, last_sa2, "last_sa");
+                }
+
+                // The overload taking the run vectors (used by DynamicRIndex::build_from_BWT_file)
+                std::vector<uint8_t> rlbwt_chars;
+                std::vector<uint64_t> rlbwt_runs;
+                stool::RLEIO::build_RLBWT_from_BWT(input.bwt, rlbwt_chars, rlbwt_runs, stool::Message::NO_MESSAGE);
+                for (uint64_t thread_count : {1, 4})
+                {
+                    std::vector<uint64_t> fst_sa2, last_sa2;
+                    SamplingSATBuilder::build(rlbwt_chars, rlbwt_runs, fst_sa2, last_sa2, stool::Message::NO_MESSAGE, thread_count);
+                    stool::EqualChecker::equal_check(fst_sa1, fst_sa2, "fst_sa");
+                    stool::EqualChecker::equal_check(last_sa1, last_sa2, "last_sa");
+                }
+            }
+
+            static void prefix_free_parsing_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                std::vector<uint8_t> correct_chars;
+                std::vector<uint64_t> correct_runs;
+                stool::RLEIO::build_RLBWT_from_BWT(input.bwt, correct_chars, correct_runs, stool::Message::NO_MESSAGE);
+                std::vector<uint64_t> correct_fst_sa, correct_last_sa;
+                uint64_t pos = 0;
+                for (uint64_t i = 0; i < correct_runs.size(); i++)
+                {
+                    correct_fst_sa.push_back(input.sa[pos]);
+                    correct_last_sa.push_back(input.sa[pos + correct_runs[i] - 1]);
+                    pos += correct_runs[i];
+                }
+
+                // The stream without the end marker is also accepted
+                for (uint64_t with_end_marker = 0; with_end_marker <= 1; with_end_marker++)
+                {
+                    std::string str(input.text.begin(), with_end_marker == 1 ? input.text.end() : input.text.end() - 1);
+                    for (std::pair<uint64_t, uint64_t> params : std::vector<std::pair<uint64_t, uint64_t>>{{1, 1}, {2, 3}, {4, 5}, {10, 100}, {10, 1000000}})
+                    {
+                        std::stringstream ss(str);
+                        std::vector<uint8_t> test_chars;
+                        std::vector<uint64_t> test_runs, test_fst_sa, test_last_sa;
+                        PrefixFreeParsing::build(ss, input.alphabet_with_end_marker[0], test_chars, test_runs, test_fst_sa, test_last_sa, params.first, params.second, stool::Message::NO_MESSAGE);
+                        stool::EqualChecker::equal_check(correct_chars, test_chars, "RLBWT chars");
+                        stool::EqualChecker::equal_check(correct_runs, test_runs, "RLBWT runs");
+                        stool::EqualChecker::equal_check(correct_fst_sa, test_fst_sa, "fst_sa");
+                        stool::EqualChecker::equal_check(correct_last_sa, test_last_sa, "last_sa");
+                    }
+                }
+            }
+
+            static void rlbwt_file_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                stool::dynamic_r_index::DynamicRIndex drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                std::vector<uint8_t> rlbwt_chars;
+                std::vector<uint64_t> rlbwt_runs;
+                stool::RLEIO::build_RLBWT_from_BWT(input.bwt, rlbwt_chars, rlbwt_runs, stool::Message::NO_MESSAGE);
+
+                // Some runs are split into two records, which must be merged on loading
+                std::vector<uint8_t> split_chars;
+                std::vector<uint64_t> split_runs;
+                for (uint64_t i = 0; i < rlbwt_chars.size(); i++)
+                {
+                    if (rlbwt_runs[i] >= 2 && input.mt64() % 2 == 0)
+                    {
+                        uint64_t len = 1 + (input.mt64() % (rlbwt_runs[i] - 1));
+                        split_chars.push_back(rlbwt_chars[i]);
+                        split_runs.push_back(len);
+                        split_chars.push_back(rlbwt_chars[i]);
+                        split_runs.push_back(rlbwt_runs[i] - len);
+                    }
+                    else
+                    {
+                        split_chars.push_back(rlbwt_chars[i]);
+                        split_runs.push_back(rlbwt_runs[i]);
+                    }
+                }
+
+                std::string filepath = "drfmi.rlbwt";
+                {
+                    std::ofstream os;
+                    os.open(filepath, std::ios::binary);
+                    if (!os)
+                    {
+                        std::cerr << "Error: Could not open file for writing." << std::endl;
+                        throw std::runtime_error("File open error");
+                    }
+                    StaticRLBWTForConstruction::store_RLBWT_to_RLBWT_file(split_chars, split_runs, os);
+                }
+
+                std::vector<uint8_t> loaded_chars;
+                std::vector<uint64_t> loaded_runs;
+                StaticRLBWTForConstruction::load_RLBWT_from_RLBWT_file(filepath, loaded_chars, loaded_runs, stool::Message::NO_MESSAGE);
+                stool::EqualChecker::equal_check(rlbwt_chars, loaded_chars, "RLBWT chars");
+                stool::EqualChecker::equal_check(rlbwt_runs, loaded_runs, "RLBWT runs");
+
+                for (uint64_t thread_count : {1, 4})
+                {
+                    stool::dynamic_r_index::DynamicRIndex drfmi2 = stool::dynamic_r_index::DynamicRIndex::build_from_RLBWT_file(filepath, stool::Message::NO_MESSAGE, thread_count);
+                    DynamicRIndexTest::verify_r_index(drfmi2);
+                    BWT_and_SA::bwt_sa_and_isa_check(drfmi, drfmi2);
+                }
+                std::remove(filepath.c_str());
+            }
+
+            static void document_collection_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                std::mt19937_64 mt64(seed);
+                std::vector<uint8_t> chars = stool::Alphabet::create_alphabet(alphabet_type);
+                std::vector<uint8_t> alphabet_with_end_marker = DynamicFMIndexTest::create_alphabet_with_end_marker(chars);
+                uint8_t end_marker = alphabet_with_end_marker[0];
+                uint8_t separator = chars[mt64() % chars.size()];
+                std::vector<uint8_t> document_chars;
+                for (uint8_t c : chars)
+                {
+                    if (c != separator)
+                    {
+                        document_chars.push_back(c);
+                    }
+                }
+
+                // Empty documents are also tested
+                uint64_t document_count = 1 + (mt64() % 5);
+                std::vector<std::string> file_paths;
+                std::vector<uint8_t> text;
+                std::vector<uint64_t> correct_starting_positions;
+                for (uint64_t i = 0; i < document_count; i++)
+                {
+                    if (i > 0)
+                    {
+                        text.push_back(separator);
+                    }
+                    correct_starting_positions.push_back(text.size());
+                    uint64_t len = document_chars.size() > 0 ? mt64() % (text_size + 1) : 0;
+                    std::string document;
+                    for (uint64_t j = 0; j < len; j++)
+                    {
+                        document.push_back(document_chars[mt64() % document_chars.size()]);
+                    }
+                    text.insert(text.end(), document.begin(), document.end());
+
+                    std::string filepath = "drfmi_document_" + std::to_string(i) + ".txt";
+                    std::ofstream os(filepath, std::ios::binary);
+                    os.write(document.data(), document.size());
+                    file_paths.push_back(filepath);
+                }
+
+                std::string list_filepath = "drfmi_documents.txt";
+                {
+                    std::ofstream os(list_filepath);
+                    for (const std::string &path : file_paths)
+                    {
+                        os << path << std::endl;
+                    }
+                }
+                std::vector<std::string> loaded_file_paths = DocumentCollection::get_file_paths(list_filepath);
+                if (file_paths != loaded_file_paths)
+                {
+                    throw std::logic_error("Error: get_file_paths");
+                }
+
+                DocumentCollection collection(loaded_file_paths, separator);
+                stool::EqualChecker::equal_check(correct_starting_positions, collection.get_starting_positions(), "starting positions");
+                for (uint64_t i = 0; i < text.size(); i++)
+                {
+                    uint64_t k = std::distance(correct_starting_positions.begin(), std::upper_bound(correct_starting_positions.begin(), correct_starting_positions.end(), i)) - 1;
+                    if (collection.get_document_index(i) != k)
+                    {
+                        throw std::logic_error("Error: get_document_index");
+                    }
+                }
+
+                // The stream of the concatenation is read after a random seek
+                {
+                    std::unique_ptr<std::istream> is = collection.open();
+                    is->seekg(0, std::ios::end);
+                    if ((uint64_t)is->tellg() != text.size())
+                    {
+                        throw std::logic_error("Error: the size of the stream");
+                    }
+                    uint64_t pos = mt64() % (text.size() + 1);
+                    is->seekg(pos, std::ios::beg);
+                    std::string str;
+                    str.resize(text.size() - pos);
+                    is->read(str.data(), str.size());
+                    std::vector<uint8_t> suffix(str.begin(), str.end());
+                    std::vector<uint8_t> correct_suffix(text.begin() + pos, text.end());
+                    stool::EqualChecker::equal_check(correct_suffix, suffix, "stream");
+                }
+
+                text.push_back(end_marker);
+                std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(text);
+                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text, stool::Message::NO_MESSAGE);
+                std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text, sa, stool::Message::NO_MESSAGE);
+                stool::dynamic_r_index::DynamicRIndex drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(bwt, alphabet, stool::Message::NO_MESSAGE);
+
+                for (uint64_t thread_count : {1, 3})
+                {
+                    for (std::pair<uint64_t, uint64_t> params : std::vector<std::pair<uint64_t, uint64_t>>{{2, 3}, {10, 100}})
+                    {
+                        stool::dynamic_r_index::DynamicRIndex drfmi2 = stool::dynamic_r_index::DynamicRIndex::build_from_document_collection(collection, end_marker, stool::Message::NO_MESSAGE, thread_count, params.first, params.second);
+                        DynamicRIndexTest::verify_r_index(drfmi2);
+                        BWT_and_SA::bwt_sa_and_isa_check(drfmi, drfmi2);
+                    }
+                }
+
+                std::vector<uint64_t> loaded_starting_positions;
+                std::string docs_filepath = "drfmi.docs";
+                {
+                    std::ofstream os(docs_filepath, std::ios::binary);
+                    DocumentCollection::store_starting_positions_to_file(collection, os);
+                }
+                {
+                    std::ifstream ifs(docs_filepath, std::ios::binary);
+                    loaded_starting_positions = DocumentCollection::load_starting_positions_from_file(ifs);
+                }
+                stool::EqualChecker::equal_check(correct_starting_positions, loaded_starting_positions, "loaded starting positions");
+
+                // A document containing the separator is rejected
+                {
+                    std::string document;
+                    uint64_t len = 1 + (mt64() % (text_size + 1));
+                    for (uint64_t j = 0; j < len; j++)
+                    {
+                        document.push_back(chars[mt64() % chars.size()]);
+                    }
+                    document[mt64() % len] = separator;
+                    std::ofstream os(file_paths[file_paths.size() - 1], std::ios::binary | std::ios::trunc);
+                    os.write(document.data(), document.size());
+                }
+                bool thrown = false;
+                try
+                {
+                    DocumentCollection invalid_collection(file_paths, separator);
+                }
+                catch (const std::runtime_error &)
+                {
+                    thrown = true;
+                }
+                if (!thrown)
+                {
+                    throw std::logic_error("Error: document_collection_test, a document containing the separator is accepted");
+                }
+
+                for (const std::string &path : file_paths)
+                {
+                    std::remove(path.c_str());
+                }
+                std::remove(list_filepath.c_str());
+                std::remove(docs_filepath.c_str());
+            }
+
+            static void fasta_reader_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                std::mt19937_64 mt64(seed);
+                std::string raw_chars = "ACGTacgtNnRYKMSW-*";
+                uint64_t raw_char_count = 4 + (alphabet_type % (raw_chars.size() - 3));
+
+                // Records with lowercase characters, IUPAC codes, wrapped lines, CRLF, and empty sequences
+                bool is_fastq = mt64() % 2 == 0;
+                uint64_t record_count = 1 + (mt64() % 5);
+                std::string file;
+                std::string correct_sequence;
+                std::vector<std::string> correct_names;
+                std::vector<uint64_t> correct_starting_positions;
+                for (uint64_t i = 0; i < record_count; i++)
+                {
+                    std::string name = "seq" + std::to_string(i);
+                    std::string newline = mt64() % 2 == 0 ? "\n" : "\r\n";
+                    if (i > 0)
+                    {
+                        correct_sequence.push_back(PackedDNASequence::SEPARATOR);
+                    }
+                    correct_names.push_back(name);
+                    correct_starting_positions.push_back(correct_sequence.size());
+                    file += (is_fastq ? "@" : ">") + name + " description " + std::to_string(i) + newline;
+
+                    uint64_t len = i == 0 ? 1 + (mt64() % text_size) : mt64() % (text_size + 1);
+                    uint64_t line_width = 1 + (mt64() % 80);
+                    std::string quality;
+                    for (uint64_t j = 0; j < len; j++)
+                    {
+                        char c = raw_chars[mt64() % raw_char_count];
+                        file.push_back(c);
+                        correct_sequence.push_back(FASTAReader::normalize(c));
+                        quality.push_back(is_fastq && j == 0 ? '@' : '!' + (mt64() % 40));
+                        if ((j + 1) % line_width == 0 && j + 1 < len)
+                        {
+                            file += newline;
+                        }
+                    }
+                    file += newline;
+                    if (is_fastq)
+                    {
+                        file += "+" + newline + quality + newline;
+                    }
+                }
+
+                PackedDNASequence sequence;
+                std::vector<std::string> names;
+                std::vector<uint64_t> starting_positions;
+                {
+                    std::stringstream ss(file);
+                    FASTAReader::load(ss, sequence, names, starting_positions);
+                }
+                if (names != correct_names)
+                {
+                    throw std::logic_error("Error: FASTAReader (names)");
+                }
+                stool::EqualChecker::equal_check(correct_starting_positions, starting_positions, "starting positions");
+                if (sequence.to_string() != correct_sequence)
+                {
+                    throw std::logic_error("Error: FASTAReader (sequence)");
+                }
+                for (uint64_t i = 0; i < correct_sequence.size(); i++)
+                {
+                    if (sequence.at(i) != (uint8_t)correct_sequence[i])
+                    {
+                        throw std::logic_error("Error: PackedDNASequence::at");
+                    }
+                }
+                if (correct_sequence.size() > 0)
+                {
+                    uint64_t pos = mt64() % correct_sequence.size();
+                    std::unique_ptr<std::istream> is = sequence.open();
+                    is->seekg(pos, std::ios::beg);
+                    std::string str;
+                    str.resize(correct_sequence.size() - pos);
+                    is->read(str.data(), str.size());
+                    if (str != correct_sequence.substr(pos))
+                    {
+                        throw std::logic_error("Error: PackedDNASequence::open");
+                    }
+                }
+
+                std::string filepath = is_fastq ? "drfmi.fq" : "drfmi.fa";
+                {
+                    std::ofstream os(filepath, std::ios::binary);
+                    os.write(file.data(), file.size());
+                }
+                std::vector<uint8_t> text(correct_sequence.begin(), correct_sequence.end());
+                text.push_back('$');
+                std::vector<uint8_t> alphabet = stool::StringFunctions::get_alphabet(text);
+                std::vector<uint64_t> sa = libdivsufsort::construct_suffix_array(text, stool::Message::NO_MESSAGE);
+                std::vector<uint8_t> bwt = stool::ArrayConstructor::construct_BWT(text, sa, stool::Message::NO_MESSAGE);
+                stool::dynamic_r_index::DynamicRIndex drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(bwt, alphabet, stool::Message::NO_MESSAGE);
+                for (uint64_t thread_count : {1, 3})
+                {
+                    std::vector<std::string> names2;
+                    std::vector<uint64_t> starting_positions2;
+                    stool::dynamic_r_index::DynamicRIndex drfmi2 = stool::dynamic_r_index::DynamicRIndex::build_from_FASTA_file(filepath, '$', names2, starting_positions2, stool::Message::NO_MESSAGE, thread_count, 4, 5);
+                    DynamicRIndexTest::verify_r_index(drfmi2);
+                    BWT_and_SA::bwt_sa_and_isa_check(drfmi, drfmi2);
+                    stool::EqualChecker::equal_check(correct_starting_positions, starting_positions2, "starting positions");
+                }
+
+                // A pattern spanning a record boundary does not match
+                for (uint64_t i = 1; i < record_count; i++)
+                {
+                    uint64_t boundary = correct_starting_positions[i] - 1;
+                    if (boundary == 0 || correct_starting_positions[i] >= correct_sequence.size() || correct_sequence[boundary - 1] == (char)PackedDNASequence::SEPARATOR || correct_sequence[boundary + 1] == (char)PackedDNASequence::SEPARATOR)
+                    {
+                        continue;
+                    }
+                    std::vector<uint8_t> pattern = {(uint8_t)correct_sequence[boundary - 1], (uint8_t)correct_sequence[boundary + 1]};
+                    for (uint64_t occ : drfmi.locate_query(pattern))
+                    {
+                        if (occ == boundary - 1)
+                        {
+                            throw std::logic_error("Error: fasta_reader_test, a pattern matches across a record boundary");
+                        }
+                        if (text[occ] != pattern[0] || text[occ + 1] != pattern[1])
+                        {
+                            throw std::logic_error("Error: fasta_reader_test, locate_query");
+                        }
+                    }
+                }
+                std::remove(filepath.c_str());
+            }
+
+            static void online_construction_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                std::vector<uint8_t> rev_text(input.text.begin(), input.text.end() - 1);
+                std::reverse(rev_text.begin(), rev_text.end());
+                rev_text.push_back(input.end_marker);
+
+                std::vector<uint64_t> rev_sa = libdivsufsort::construct_suffix_array(rev_text, stool::Message::NO_MESSAGE);
+                std::vector<uint8_t> rev_bwt = stool::ArrayConstructor::construct_BWT(rev_text, rev_sa, stool::Message::NO_MESSAGE);
+                stool::dynamic_r_index::DynamicRIndex drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(input.bwt, stool::StringFunctions::get_alphabet(input.text), stool::Message::NO_MESSAGE);
+                stool::dynamic_r_index::DynamicRIndex rev_drfmi = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(rev_bwt, stool::StringFunctions::get_alphabet(rev_text), stool::Message::NO_MESSAGE);
+
+                std::string str(input.text.begin(), input.text.end() - 1);
+                for (uint64_t block_size : {1, 3, 1000})
+                {
+                    for (bool reversed : {false, true})
+                    {
+                        std::stringstream ss(str);
+                        stool::dynamic_r_index::DynamicRIndex drfmi2 = stool::dynamic_r_index::DynamicRIndex::build_online(ss, input.end_marker, reversed, stool::Message::NO_MESSAGE, block_size);
+                        DynamicRIndexTest::verify_r_index(drfmi2);
+                        BWT_and_SA::bwt_sa_and_isa_check(reversed ? rev_drfmi : drfmi, drfmi2);
+                    }
+                }
+            }
+
+            /**
+             * @brief Test PrimitiveUpdateOperations::r_move against a naive BWT and SA, and against r_delete followed by r_insert
+             * @details The moved rows are random, and half of them are moved inside their runs, which is the case handled without updating the RLBWT.
+             * @return The numbers of the rows moved inside their runs and the other moved rows
+             */
+            static std::pair<uint64_t, uint64_t> r_move_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed, uint64_t move_count = 50)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                uint64_t n = input.bwt.size();
+                if (n < 3)
+                {
+                    return {0, 0};
+                }
+
+                stool::dynamic_r_index::DynamicRIndex fused = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                stool::dynamic_r_index::DynamicRIndex unfused = stool::dynamic_r_index::DynamicRIndex::build_from_BWT(input.bwt, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+                auto &fused_dbwt = *fused._get_dbwt_pointer();
+                DynamicPhi &fused_disa = *fused._get_dsa_pointer();
+                auto &unfused_dbwt = *unfused._get_dbwt_pointer();
+                DynamicPhi &unfused_disa = *unfused._get_dsa_pointer();
+
+                uint64_t in_run_move_count = 0;
+                uint64_t other_move_count = 0;
+                for (uint64_t i = 0; i < move_count; i++)
+                {
+                    // As in the updates, the row of the end marker is not moved
+                    uint64_t y = input.mt64() % n;
+                    if (input.bwt[y] == input.end_marker)
+                    {
+                        continue;
+                    }
+                    uint64_t run_start = y;
+                    uint64_t run_end = y + 1;
+                    while (run_start > 0 && input.bwt[run_start - 1] == input.bwt[y])
+                    {
+                        run_start--;
+                    }
+                    while (run_end < n && input.bwt[run_end] == input.bwt[y])
+                    {
+                        run_end++;
+                    }
+
+                    // z is a position of the BWT after the row y is removed, and z is in the run of y iff run_start <= z < run_end
+                    uint64_t run_length = run_end - run_start;
+                    uint64_t z = 0;
+                    if (i % 2 == 0 && run_length >= 2)
+                    {
+                        z = run_start + (input.mt64() % (run_length - 1));
+                        if (z >= y)
+                        {
+                            z++;
+                        }
+                    }
+                    else if (run_length < n)
+                    {
+                        z = input.mt64() % (n - run_length);
+                        if (z >= run_start)
+                        {
+                            z += run_length;
+                        }
+                    }
+                    else
+                    {
+                        continue;
+                    }
+
+                    PositionInformation y_PI;
+                    y_PI.p = y;
+                    y_PI.value_at_p = input.sa[y];
+                    y_PI.value_at_p_minus = input.sa[(y + n - 1) % n];
+                    y_PI.value_at_p_plus = input.sa[(y + 1) % n];
+
+                    uint8_t y_char = input.bwt[y];
+                    input.bwt.erase(input.bwt.begin() + y);
+                    input.sa.erase(input.sa.begin() + y);
+
+                    PositionInformation z_PI;
+                    z_PI.p = z;
+                    z_PI.value_at_p_minus = input.sa[(z + n - 2) % (n - 1)];
+                    z_PI.value_at_p_plus = input.sa[z % (n - 1)];
+
+                    input.bwt.insert(input.bwt.begin() + z, y_char);
+                    input.sa.insert(input.sa.begin() + z, y_PI.value_at_p);
+
+                    RunPosition y_on_rlbwt = fused_dbwt.to_run_position(y);
+                    bool b = PrimitiveUpdateOperations::r_move(y, y_on_rlbwt, y_char, y_PI, z_PI, fused_dbwt, fused_disa);
+                    bool in_run = run_length >= 2 && run_start <= z && z < run_end;
+                    if (b != in_run)
+                    {
+                        throw std::logic_error("Error: r_move_test, r_move took the wrong path");
+                    }
+                    if (in_run)
+                    {
+                        in_run_move_count++;
+                    }
+                    else
+                    {
+                        other_move_count++;
+                    }
+
+                    RunPosition y_on_unfused_rlbwt = unfused_dbwt.to_run_position(y);
+                    PrimitiveUpdateOperations::r_delete(y_on_unfused_rlbwt, y_char, y_PI.value_at_p_minus, y_PI.value_at_p_plus, unfused_dbwt, unfused_disa);
+                    PrimitiveUpdateOperations::r_insert(y_PI.value_at_p, z_PI.p, y_char, z_PI.value_at_p_minus, z_PI.value_at_p_plus, unfused_dbwt, unfused_disa);
+
+                    // The sampled SA values are the SA values at the run boundaries of the naive BWT
+                    std::vector<uint64_t> correct_first_sa_values;
+                    std::vector<uint64_t> correct_last_sa_values;
+                    for (uint64_t j = 0; j < n; j++)
+                    {
+                        if (j == 0 || input.bwt[j - 1] != input.bwt[j])
+                        {
+                            correct_first_sa_values.push_back(input.sa[j]);
+                        }
+                        if (j + 1 == n || input.bwt[j] != input.bwt[j + 1])
+                        {
+                            correct_last_sa_values.push_back(input.sa[j]);
+                        }
+                    }
+
+                    stool::EqualChecker::equal_check(input.bwt, fused_dbwt.get_bwt(), "BWT (r_move)");
+                    stool::EqualChecker::equal_check(correct_first_sa_values, fused_disa.get_first_sa_values(), "first SA values (r_move)");
+                    stool::EqualChecker::equal_check(correct_last_sa_values, fused_disa.get_last_sa_values(), "last SA values (r_move)");
+                    stool::EqualChecker::equal_check(input.bwt, unfused_dbwt.get_bwt(), "BWT (r_delete and r_insert)");
+                    stool::EqualChecker::equal_check(correct_first_sa_values, unfused_disa.get_first_sa_values(), "first SA values (r_delete and r_insert)");
+                    stool::EqualChecker::equal_check(correct_last_sa_values, unfused_disa.get_last_sa_values(), "last SA values (r_delete and r_insert)");
+                }
+                return {in_run_move_count, other_move_count};
+            }
+
+            /**
+             * @brief Test the run lengths sorted by F, which DynamicRLBWT::build_from_RLBWT computes by a counting sort, against a naive comparison sort
+             */
+            static void f_ordered_run_lengths_test(uint64_t text_size, uint8_t alphabet_type, uint64_t seed)
+            {
+                DynamicFMIndexTest::RandomTextFixture input(text_size, alphabet_type, seed);
+
+                std::vector<uint8_t> rlbwt_chars;
+                std::vector<uint64_t> rlbwt_runs;
+                stool::RLEIO::build_RLBWT_from_BWT(input.bwt, rlbwt_chars, rlbwt_runs, stool::Message::NO_MESSAGE);
+                DynamicRIndex::RLBWT dbwt = DynamicRIndex::RLBWT::build_from_RLBWT(rlbwt_chars, rlbwt_runs, input.alphabet_with_end_marker, stool::Message::NO_MESSAGE);
+
+                // The runs are stably sorted by their characters
+                std::vector<uint64_t> sorted_run_indexes;
+                for (uint64_t i = 0; i < rlbwt_chars.size(); i++)
+                {
+                    sorted_run_indexes.push_back(i);
+                }
+                std::stable_sort(sorted_run_indexes.begin(), sorted_run_indexes.end(), [&](uint64_t x, uint64_t y)
+                                 { return rlbwt_chars[x] < rlbwt_chars[y]; });
+
+                std::vector<uint64_t> correct_f_indexes;
+                std::vector<uint64_t> correct_starting_positions_on_F;
+                std::vector<uint64_t> f_indexes;
+                std::vector<uint64_t> starting_positions_on_F;
+                correct_f_indexes.resize(rlbwt_chars.size());
+                uint64_t psum = 0;
+                for (uint64_t f = 0; f < sorted_run_indexes.size(); f++)
+                {
+                    correct_f_indexes[sorted_run_indexes[f]] = f;
+                    correct_starting_positions_on_F.push_back(psum);
+                    psum += rlbwt_runs[sorted_run_indexes[f]];
+                    starting_positions_on_F.push_back(dbwt.get_starting_position_on_F(f));
+                }
+                for (uint64_t i = 0; i < rlbwt_chars.size(); i++)
+                {
+                    f_indexes.push_back(dbwt.get_f_index(i));
+                }
+                stool::EqualChecker::equal_check(correct_f_indexes, f_indexes, "F-indexes");
+                stool::EqualChecker::equal_check(correct_starting_positions_on_F, starting_positions_on_F, "starting positions on F");
+
+                // LF depends on the run lengths sorted by F
+                uint64_t n = input.sa.size();
+                std::vector<uint64_t> correct_lf;
+                std::vector<uint64_t> lf;
+                for (uint64_t i = 0; i < n; i++)
+                {
+                    correct_lf.push_back(input.isa[(input.sa[i] + n - 1) % n]);
+                    lf.push_back(dbwt.LF(i));
+                }
+                stool::EqualChecker::equal_check(correct_lf, lf, "LF");
+            }
+
             static void detailed_string_deletion_test(uint64_t text_size, uint64_t str_len, uint8_t alphabet_type, uint64_t seed)
             {
                 if(str_len < 1){
@@ -262,10 +262,152 @@ void main_sub(int mode, uint64_t text_size, bool detailed_check, uint64_t seed)
         std::cout << std::endl;
         */
     }
+    else if (mode == 12)
+    {
+        uint64_t guarded_rebuild_count = 0;
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::rebuild_guard_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { guarded_rebuild_count += stool::r_index_test::DynamicRIndexTest::rebuild_guard_test(320, 16, alphabet_type, trial_seed); });
+        if (guarded_rebuild_count == 0)
+        {
+            throw std::logic_error("Error: rebuild_guard_test, the guarded rebuild path is not tested");
+        }
+    }
+    else if (mode == 13)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::update_cost_estimation_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::update_cost_estimation_test(320, alphabet_type, trial_seed); });
+    }
+    else if (mode == 14)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::run_compaction_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::run_compaction_test(320, alphabet_type, trial_seed); });
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::non_maximal_run_compaction_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::non_maximal_run_compaction_test(320, alphabet_type, trial_seed); });
+    }
+    else if (mode == 15)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::blocked_c_array_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::blocked_c_array_test(320, alphabet_type, trial_seed); });
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::blocked_index_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::blocked_index_test(320, alphabet_type, trial_seed); });
+    }
+    else if (mode == 16)
+    {
+        std::cout << "Execute DynamicRIndexTest::integer_alphabet_test." << std::endl;
+        std::vector<uint64_t> max_symbols = {100, 60000, 3000000};
+        for (uint64_t max_symbol : max_symbols)
+        {
+            for (uint64_t i = 0; i < 10; i++)
+            {
+                std::cout << "+" << std::flush;
+                stool::r_index_test::DynamicRIndexTest::integer_alphabet_test(300, max_symbol, seed++);
+            }
+        }
+        std::cout << std::endl;
+    }
+    else if (mode == 17)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::alphabet_growth_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::alphabet_growth_test(320, alphabet_type, trial_seed); });
+    }
+    else if (mode == 18)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::sliding_window_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::sliding_window_test(200, alphabet_type, trial_seed); });
+    }
+    else if (mode == 19)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::replace_all_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::replace_all_test(200, alphabet_type, trial_seed); });
+    }
+    else if (mode == 20)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::copy_and_move_substring_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::copy_and_move_substring_test(200, alphabet_type, trial_seed); });
 
+        // Substrings longer than DynamicRIndex::SUBSTRING_BLOCK_SIZE are copied and moved in several blocks
+        uint64_t block_size = stool::dynamic_r_index::DynamicRIndex::SUBSTRING_BLOCK_SIZE;
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::copy_and_move_substring_test", 1, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::copy_and_move_substring_test(block_size * 3, alphabet_type, trial_seed, block_size * 2 + 10); });
+    }
+    else if (mode == 21)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::run_permutation_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::run_permutation_test(320, alphabet_type, trial_seed); });
+    }
+    else if (mode == 22)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::update_log_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::update_log_test(320, alphabet_type, trial_seed); });
+    }
+    else if (mode == 23)
+    {
+        stool::r_index_test::DynamicRIndexTest::rlbwt_hash_collision_test();
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::rlbwt_hash_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::rlbwt_hash_test(320, alphabet_type, trial_seed); });
+    }
+    else if (mode == 24)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::sampling_verification_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::sampling_verification_test(320, alphabet_type, trial_seed); });
+    }
+    else if (mode == 25)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::edit_session_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::edit_session_test(text_size, alphabet_type, trial_seed); });
+    }
+    else if (mode == 26)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::parallel_sampling_sa_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::parallel_sampling_sa_test(text_size, alphabet_type, trial_seed); });
+    }
+    else if (mode == 27)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::prefix_free_parsing_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::prefix_free_parsing_test(text_size, alphabet_type, trial_seed); });
+    }
+    else if (mode == 28)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::rlbwt_file_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::rlbwt_file_test(text_size, alphabet_type, trial_seed); });
+    }
+    else if (mode == 29)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::document_collection_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::document_collection_test(text_size, alphabet_type, trial_seed); });
+    }
+    else if (mode == 30)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::fasta_reader_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::fasta_reader_test(text_size, alphabet_type, trial_seed); });
+    }
+    else if (mode == 31)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::online_construction_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::online_construction_test(text_size, alphabet_type, trial_seed); });
+    }
+    else if (mode == 32)
+    {
+        uint64_t in_run_move_count = 0;
+        uint64_t other_move_count = 0;
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::r_move_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         {
+                                                             std::pair<uint64_t, uint64_t> counts = stool::r_index_test::DynamicRIndexTest::r_move_test(text_size, alphabet_type, trial_seed);
+                                                             in_run_move_count += counts.first;
+                                                             other_move_count += counts.second; });
+        if (in_run_move_count == 0 || other_move_count == 0)
+        {
+            throw std::logic_error("Error: r_move_test, a path of r_move is not tested");
+        }
+    }
+    else if (mode == 33)
+    {
+        stool::fm_index_test::run_for_each_alphabet_type("DynamicRIndexTest::f_ordered_run_lengths_test", 10, seed, [&](uint8_t alphabet_type, uint64_t trial_seed)
+                                                         { stool::r_index_test::DynamicRIndexTest::f_ordered_run_lengths_test(text_size, alphabet_type, trial_seed); });
+    }
     else if (mode == 0)
     {
-        for (uint64_t i = 1; i <= 10; i++)
+        for (uint64_t i = 1; i <= 33; i++)
         {
             main_sub(i, text_size, detailed_check, seed);
         }